@@ -1,15 +1,77 @@
-
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "Class.h"
+#include "JsonStats.h"
+
+
+
+
+/**
+ * Allocates with the standard library
+ */
+static void * __standardAllocate(void * context, size_t size);
+
+
+/**
+ * Resizes with the standard library
+ */
+static void * __standardReallocate(void * context, void * block, size_t oldSize, size_t newSize);
 
 
+/**
+ * Releases with the standard library
+ */
+static void __standardDeallocate(void * context, void * block);
+
+
+/**
+ * Allocator backed by the standard library
+ */
+static Allocator const standardAllocator = {
+    __standardAllocate,
+    __standardReallocate,
+    __standardDeallocate,
+    NULL
+};
+
+
+/**
+ * Allocator used by further allocations through new, delete and resize
+ */
+static Allocator const * currentAllocator = & standardAllocator;
 
 
-static void * Class_allocate(char const * className, unsigned int blockSize)
+
+
+static void * Class_allocate(char const * className, size_t blockSize)
 {
-    void * this = calloc(1, blockSize);
+    return Class->newWithAllocator(currentAllocator, className, blockSize);
+}
+
+
+static void Class_deallocate(void ** this)
+{
+    Class->deleteWithAllocator(currentAllocator, this);
+}
+
+
+static int Class_resize(void ** this, size_t oldSize, size_t newSize)
+{
+    return Class->resizeWithAllocator(currentAllocator, this, oldSize, newSize);
+}
+
+
+static void * Class_allocateWith(Allocator const * allocator, char const * className, size_t blockSize)
+{
+    void * this;
+
+    if (allocator == NULL) {
+        allocator = & standardAllocator;
+    }
+
+    this = allocator->allocate(allocator->context, blockSize);
 
     if (this == NULL) {
         if (className == NULL) {
@@ -17,23 +79,103 @@ static void * Class_allocate(char const * className, unsigned int blockSize)
         } 
 
         fprintf(stderr, "Memory allocation failed for class %s\n", className);
+    } else {
+        memset(this, 0, blockSize);
+        JSON_STATS_ALLOCATION(blockSize);
     }
 
     return this;
 }
 
 
-static void Class_deallocate(void ** this)
+static void Class_deallocateWith(Allocator const * allocator, void ** this)
 {
     if ((this == NULL) || (* this == NULL)) {
         return;
     }
 
-    free(* this);
+    if (allocator == NULL) {
+        allocator = & standardAllocator;
+    }
+
+    allocator->deallocate(allocator->context, * this);
     * this = NULL;
 }
 
 
+static int Class_resizeWith(Allocator const * allocator, void ** this, size_t oldSize, size_t newSize)
+{
+    char * resized;
+
+    if (this == NULL) {
+        return -1;
+    }
+
+    if (allocator == NULL) {
+        allocator = & standardAllocator;
+    }
+
+    resized = allocator->reallocate(allocator->context, * this, oldSize, newSize);
+    if (resized == NULL) {
+        return -1;
+    }
+
+    if (newSize > oldSize) {
+        memset(resized + oldSize, 0, newSize - oldSize);
+        JSON_STATS_ALLOCATION(newSize - oldSize);
+    }
+    * this = resized;
+
+    return 0;
+}
+
+
+static Allocator const * Class_useAllocator(Allocator const * allocator)
+{
+    Allocator const * previousAllocator = currentAllocator;
+
+    if (allocator == NULL) {
+        allocator = & standardAllocator;
+    }
+    currentAllocator = allocator;
+
+    return previousAllocator;
+}
+
+
+static Allocator const * Class_getAllocator(void)
+{
+    return currentAllocator;
+}
+
+
+
+
+static void * __standardAllocate(void * context, size_t size)
+{
+    (void) context;
+
+    return malloc(size);
+}
+
+
+static void * __standardReallocate(void * context, void * block, size_t oldSize, size_t newSize)
+{
+    (void) context;
+    (void) oldSize;
+
+    return realloc(block, newSize);
+}
+
+
+static void __standardDeallocate(void * context, void * block)
+{
+    (void) context;
+
+    free(block);
+}
+
+
 
 
 /**
@@ -41,6 +183,12 @@ static void Class_deallocate(void ** this)
  */
 static ClassMethods methods = {
     Class_allocate,
-    Class_deallocate
+    Class_deallocate,
+    Class_resize,
+    Class_allocateWith,
+    Class_deallocateWith,
+    Class_resizeWith,
+    Class_useAllocator,
+    Class_getAllocator
 };
 ClassMethods const * const Class = & methods;
@@ -1,7 +1,66 @@
-
 #ifndef CLASS_HEADER
 #define CLASS_HEADER
 
+#include <stddef.h>
+
+
+
+
+/**
+ * Add and release a reference of a reference count, returning the new count
+ * They are atomic where the compiler provides it, so that frozen instances may be shared between threads
+ */
+#ifdef __GNUC__
+    #define CLASS_RETAIN(count) __sync_add_and_fetch(& (count), 1)
+    #define CLASS_RELEASE(count) __sync_sub_and_fetch(& (count), 1)
+#else
+    #define CLASS_RETAIN(count) (++(count))
+    #define CLASS_RELEASE(count) (--(count))
+#endif
+
+
+/**
+ * Memory allocator the instances are allocated with
+ */
+typedef struct
+{
+    /**
+     * Allocates a memory block
+     *
+     * @param context - the allocator context
+     * @param size - the size of the block to allocate
+     *
+     * @return - the allocated block, NULL on failure
+     */
+    void * (* allocate)(void * context, size_t size);
+
+    /**
+     * Resizes a memory block
+     *
+     * @param context - the allocator context
+     * @param block - the block to resize
+     * @param oldSize - the current size of the block
+     * @param newSize - the requested size of the block
+     *
+     * @return - the resized block, NULL on failure (the block is left untouched)
+     */
+    void * (* reallocate)(void * context, void * block, size_t oldSize, size_t newSize);
+
+    /**
+     * Releases a memory block
+     *
+     * @param context - the allocator context
+     * @param block - the block to release
+     */
+    void (* deallocate)(void * context, void * block);
+
+    /**
+     * User data given back to every allocator call
+     */
+    void * context;
+
+} Allocator;
+
 
 
 
@@ -11,22 +70,81 @@
 typedef struct
 {
     /**
-    * Allocates a new instance and returns it
+    * Allocates a new zeroed instance with the current allocator and returns it
     *
     * @param className - the name of the class to allocate
     * @param blockSize - the size of the class to allocate
     *
     * @return - the allocated instance
     */
-    void * (* new)(char const * className, unsigned int blockSize);
+    void * (* new)(char const * className, size_t blockSize);
 
     /**
-    * Deletes the instance and sets it to NULL
+    * Deletes the instance with the current allocator and sets it to NULL
     *
     * @param this - pointer to the instance to delete
     */
     void (* delete)(void ** this);
 
+    /**
+    * Resizes the instance with the current allocator, the added bytes are zeroed
+    *
+    * @param this - pointer to the instance to resize, updated on success
+    * @param oldSize - the current size of the instance
+    * @param newSize - the requested size of the instance
+    *
+    * @return - 0 on success, -1 on failure
+    */
+    int (* resize)(void ** this, size_t oldSize, size_t newSize);
+
+    /**
+    * Allocates a new zeroed instance with the given allocator, whatever the current one
+    *
+    * @param allocator - the allocator to use, NULL for the standard one
+    * @param className - the name of the class to allocate
+    * @param blockSize - the size of the class to allocate
+    *
+    * @return - the allocated instance
+    */
+    void * (* newWithAllocator)(Allocator const * allocator, char const * className, size_t blockSize);
+
+    /**
+    * Deletes the instance with the allocator it was allocated with and sets it to NULL
+    *
+    * @param allocator - the allocator the instance was allocated with, NULL for the standard one
+    * @param this - pointer to the instance to delete
+    */
+    void (* deleteWithAllocator)(Allocator const * allocator, void ** this);
+
+    /**
+    * Resizes the instance with the allocator it was allocated with, the added bytes are zeroed
+    *
+    * @param allocator - the allocator the instance was allocated with, NULL for the standard one
+    * @param this - pointer to the instance to resize, updated on success
+    * @param oldSize - the current size of the instance
+    * @param newSize - the requested size of the instance
+    *
+    * @return - 0 on success, -1 on failure
+    */
+    int (* resizeWithAllocator)(Allocator const * allocator, void ** this, size_t oldSize, size_t newSize);
+
+    /**
+    * Sets the allocator used by further allocations through new, delete and resize
+    * This is a process-wide default, meant to be set once: instances owning an allocator pass it explicitly
+    *
+    * @param allocator - the allocator to use, NULL to restore the standard one
+    *
+    * @return - the previously used allocator
+    */
+    Allocator const * (* useAllocator)(Allocator const * allocator);
+
+    /**
+    * Returns the allocator currently used
+    *
+    * @return - the current allocator
+    */
+    Allocator const * (* getAllocator)(void);
+
 } ClassMethods;
 
 
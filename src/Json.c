@@ -1,227 +1,1635 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <limits.h>
 
 #include "Class.h"
+#include "Pool.h"
 #include "JsonToken.h"
 #include "LinkedList.h"
+#include "JsonStats.h"
+#include "JsonLexer.h"
+#include "JsonNumbers.h"
+#include "JsonGrammar.h"
+#include "JsonProjection.h"
 #include "Json.h"
 
 
 
 
+/**
+ * Number of characters an edit first reads again past the edited range, doubled while tokens go on
+ */
+#define JSON_EDIT_READ_STEP 64
+
+
+
+
+/**
+ * Where a token of a json is, and which bracket it matches
+ */
+typedef struct
+{
+    /**
+     * The list element holding the token
+     */
+    LinkedList * element;
+
+    /**
+     * The offset of the token in the raw string, 0 for projected tokens
+     * Entries after the gap hold it from the end of the raw string instead
+     */
+    size_t offset;
+
+    /**
+     * The index of the matching bracket, the token's own index for non-bracket tokens
+     * It's held from the number of tokens, as a negative index, when the matching bracket is after the gap
+     */
+    int match;
+
+} TokenEntry;
+
+
+/**
+ * Numbers of a single type gathered to be converted together
+ */
+typedef struct
+{
+    /**
+     * JSON_TOKEN_INTEGER or JSON_TOKEN_FLOAT
+     */
+    JsonTokenType type;
+
+    /**
+     * The number of numbers gathered
+     */
+    unsigned int count;
+
+    /**
+     * The lexeme of each number
+     */
+    JsonLexeme lexemes[JSON_NUMBERS_BATCH_SIZE];
+
+    /**
+     * The token of each number, its value stored once converted
+     */
+    JsonToken * tokens[JSON_NUMBERS_BATCH_SIZE];
+
+    /**
+     * The index of each number among the numbers of the json
+     */
+    unsigned int indexes[JSON_NUMBERS_BATCH_SIZE];
+
+} NumbersBatch;
+
+
+/**
+ * An edit being checked, before the json is changed
+ */
+typedef struct
+{
+    /**
+     * The offset of the replaced range in the json-string
+     */
+    size_t offset;
+
+    /**
+     * The length of the replaced range
+     */
+    size_t removedLength;
+
+    /**
+     * The characters replacing the range
+     */
+    char const * inserted;
+
+    /**
+     * The number of characters replacing the range
+     */
+    size_t insertedLength;
+
+    /**
+     * The length of the edited json-string
+     */
+    size_t length;
+
+    /**
+     * The characters of the edited json-string read again, from the first token the edit may change
+     */
+    char * text;
+
+    /**
+     * The offset of the characters read again in the edited json-string
+     */
+    size_t textOffset;
+
+    /**
+     * The number of characters read again
+     */
+    size_t textLength;
+
+    /**
+     * The number of characters there is room for
+     */
+    size_t textCapacity;
+
+    /**
+     * The tokens read again, borrowing their characters from text
+     */
+    JsonLexeme * lexemes;
+
+    /**
+     * The number of tokens read again
+     */
+    unsigned int lexemesCount;
+
+    /**
+     * The number of tokens there is room for
+     */
+    unsigned int lexemesCapacity;
+
+    /**
+     * The index of the first replaced token
+     */
+    unsigned int first;
+
+    /**
+     * The index of the first kept token after the replaced ones
+     */
+    unsigned int resumeIndex;
+
+    /**
+     * The matching brackets of the tokens validated again, by index in the edited tokens
+     */
+    unsigned int * matches;
+
+    /**
+     * The index of the first token validated again, in the edited tokens
+     */
+    unsigned int matchesStart;
+
+    /**
+     * The number of tokens validated again
+     */
+    unsigned int matchesCount;
+
+    /**
+     * Why the edit is rejected
+     */
+    JsonError error;
+
+} PendingEdit;
+
+
 struct Json
 {
-    /**
-     * The raw string used to build the json object
-     */
-    char * rawString;
+    /**
+     * The raw string used to build the json object, a gap buffer once edited:
+     * the characters before the gap, the gap, then the rest and a NUL, so that an edit only moves the characters since the last one
+     */
+    char * rawString;
+
+    /**
+     * The length of the raw string, the gap excluded
+     */
+    size_t rawLength;
+
+    /**
+     * The offset of the gap in the raw string, rawLength when the raw string is contiguous
+     */
+    size_t gapOffset;
+
+    /**
+     * The number of characters in the gap
+     */
+    size_t gapLength;
+
+    /**
+     * The list of tokens
+     */
+    LinkedList * tokens; 
+
+    /**
+     * The number of tokens
+     */
+    unsigned int tokensCount;
+
+    /**
+     * The entry of each token, in the order of the list, a gap buffer like the raw string
+     * Edits leave the entries after the gap untouched, as their offsets and matches are held from the end
+     */
+    TokenEntry * entries;
+
+    /**
+     * The number of entries there is room for
+     */
+    unsigned int entriesCapacity;
+
+    /**
+     * The index of the first token whose entry is after the gap, tokensCount when there's none
+     */
+    unsigned int entriesGap;
+
+    /**
+     * Whether only the tokens of some paths were extracted
+     */
+    char isProjected;
+
+    /**
+     * Whether numbers are converted on first access, kept for tokens created by edits
+     */
+    char lazyNumbers;
+
+    /**
+     * Whether the json is immutable, and may be read from several threads
+     */
+    char isFrozen;
+
+    /**
+     * The pool the tokens are taken from
+     */
+    Pool * tokenPool;
+
+    /**
+     * The pool the elements of the list of tokens are taken from
+     */
+    Pool * nodePool;
+
+    /**
+     * The allocator the json and its tokens are allocated with
+     */
+    Allocator const * allocator;
+
+    /**
+     * Counters gathered while parsing, only filled with JSON_INSTRUMENTATION
+     */
+    JsonStats stats;
+
+    /**
+     * The number of owners of the json, it's deleted when the last one releases it
+     */
+    unsigned int referencesCount;
+};
+
+
+
+
+/**
+ * Fills options with the defaults: current allocator, every token extracted, numbers converted on creation
+ * 
+ * @param options - the options to fill
+ */
+static void __defaultOptions(JsonOptions * options);
+
+
+/**
+ * Converts the integer and float tokens not converted yet in bulk, storing their values in the tokens
+ * 
+ * @param this - the json to convert numbers of
+ * @param numbers - where to store every number, in document order
+ * @param capacity - the number of numbers there is room for
+ * 
+ * @return - the number of integer and float tokens, -1 on failure
+ */
+static int __convertNumbers(Json const * const this, JsonNumber * numbers, unsigned int capacity);
+
+
+/**
+ * Converts the numbers of a batch, storing their values in their tokens and in the numbers there is room for
+ * 
+ * @param batch - the numbers to convert, emptied on success
+ * @param numbers - where to store the numbers, by index
+ * @param capacity - the number of numbers there is room for
+ * 
+ * @return - 0 on success, -1 on failure
+ */
+static int __flushNumbers(NumbersBatch * batch, JsonNumber * numbers, unsigned int capacity);
+
+
+/**
+ * Fills the json from the json-string, with the allocator of the json
+ * 
+ * @param this - the json to fill
+ * @param jsonString - the json-string to parse
+ * @param options - the parsing options
+ * 
+ * @return - 0 on success, -1 on failure
+ */
+static int __parse(Json * this, char const * const jsonString, JsonOptions const * options);
+
+
+/**
+ * Deletes the tokens stored in the list, the list itself is left to delete
+ * 
+ * @param this - the json object the tokens belong to
+ * @param tokens - the list of tokens to delete
+ */
+static void __deleteTokens(Json const * this, LinkedList * tokens);
+
+
+/**
+ * Parses the tokens from the raw string, validating their sequence along the way
+ * 
+ * @param this - the json object with a valid raw string to extract tokens from
+ * @param error - where to store why the raw string is rejected
+ * 
+ * @return - 0 on success, -1 on failure
+ */
+static int __extractTokens(Json * this, JsonError * error);
+
+
+/**
+ * Validates the sequence of already extracted tokens, and records their matching brackets
+ * 
+ * @param this - the json object with extracted tokens
+ * @param error - where to store why the tokens are rejected
+ * 
+ * @return - 0 on success, -1 on failure
+ */
+static int __matchTokens(Json * this, JsonError * error);
+
+
+/**
+ * Creates a token and the list element holding it, from the pools of the json
+ * 
+ * @param this - the json object the token belongs to
+ * @param start - the first character of the token
+ * @param length - the number of characters of the token
+ * 
+ * @return - the list element if creation succeeds, NULL otherwise
+ */
+static LinkedList * __newTokenElement(Json const * this, char const * const start, size_t length);
+
+
+/**
+ * Makes room for the given number of entries
+ * 
+ * @param this - the json object to grow entries of
+ * @param count - the number of entries needed
+ * 
+ * @return - 0 on success, -1 on allocation failure
+ */
+static int __reserveEntries(Json * this, unsigned int count);
+
+
+/**
+ * Records the entry of the next token
+ * 
+ * @param this - the json object the token belongs to
+ * @param element - the list element holding the token
+ * @param offset - the offset of the token in the raw string
+ * @param status - the status the grammar accepted the token with
+ * @param openingIndex - the index of the opening token, if the token closes a container
+ * 
+ * @return - 0 on success, -1 on allocation failure
+ */
+static int __recordToken(Json * this, LinkedList * element, size_t offset, int status, unsigned int openingIndex);
+
+
+/**
+ * Returns the grammar class of a token: its operator for operators, 's' for strings, 'v' for other values
+ * Two sequences of tokens with the same classes are validated and matched the same way
+ * 
+ * @param type - the type of the token
+ * @param operator - the first character of the token
+ * 
+ * @return - the grammar class of the token
+ */
+static char __grammarClass(JsonTokenType type, char operator);
+
+
+/**
+ * Returns the entry of a token, wherever the gap of entries is
+ * 
+ * @param this - the json the token belongs to
+ * @param index - the index of the token, which must be in range
+ * 
+ * @return - the entry of the token
+ */
+static TokenEntry * __getEntry(Json const * this, unsigned int index);
+
+
+/**
+ * Returns the offset of a token in the raw string
+ * 
+ * @param this - the json the token belongs to
+ * @param index - the index of the token, which must be in range
+ * 
+ * @return - the offset of the token
+ */
+static size_t __getOffset(Json const * this, unsigned int index);
+
+
+/**
+ * Returns the index of the bracket matching a token
+ * 
+ * @param this - the json the token belongs to
+ * @param index - the index of the token, which must be in range
+ * 
+ * @return - the index of the matching bracket, the given index if the token isn't a bracket
+ */
+static unsigned int __getMatch(Json const * this, unsigned int index);
+
+
+/**
+ * Sets the index of the bracket matching a token, held according to where it is from the gap of entries
+ * 
+ * @param this - the json the token belongs to
+ * @param index - the index of the token, which must be in range
+ * @param match - the index of the matching bracket, the given index if the token isn't a bracket
+ */
+static void __setMatch(Json * this, unsigned int index, unsigned int match);
+
+
+/**
+ * Moves the gap of entries before the given token, converting the entries crossing it
+ * 
+ * @param this - the json to move the gap of
+ * @param index - the index of the first token to be after the gap
+ */
+static void __moveEntriesGap(Json * this, unsigned int index);
+
+
+/**
+ * Moves the gap of the raw string to the given offset
+ * 
+ * @param this - the json to move the gap of
+ * @param offset - the offset of the gap in the raw string
+ */
+static void __moveGap(Json * this, size_t offset);
+
+
+/**
+ * Makes room in the gap of the raw string, growing the raw string if needed
+ * 
+ * @param this - the json to make room in
+ * @param length - the number of characters needed in the gap
+ * 
+ * @return - 0 on success, -1 on failure
+ */
+static int __reserveGap(Json * this, size_t length);
+
+
+/**
+ * Moves the gap of the raw string to its end, so that it's contiguous and NUL-terminated
+ * The gap is a layout of the raw string, which is logically left untouched
+ * 
+ * @param this - the json to make contiguous
+ */
+static void __closeGap(Json const * this);
+
+
+/**
+ * Copies characters of the raw string, across the gap
+ * 
+ * @param this - the json to read
+ * @param offset - the offset of the first character in the raw string
+ * @param count - the number of characters to copy
+ * @param destination - where to copy the characters
+ */
+static void __copyText(Json const * this, size_t offset, size_t count, char * destination);
+
+
+/**
+ * Copies characters of the edited json-string, without changing the json
+ * 
+ * @param this - the json being edited
+ * @param edit - the edit
+ * @param offset - the offset of the first character in the edited json-string
+ * @param count - the number of characters to copy
+ * @param destination - where to copy the characters
+ */
+static void __copyEdited(Json const * this, PendingEdit const * edit, size_t offset, size_t count, char * destination);
+
+
+/**
+ * Reads more characters of the edited json-string, doubling the characters read
+ * 
+ * @param this - the json being edited
+ * @param edit - the edit to read more characters for, its tokens moved along with the characters
+ * 
+ * @return - 0 on success, -1 on failure
+ */
+static int __readMore(Json const * this, PendingEdit * edit);
+
+
+/**
+ * Finds the first token an edit at the given offset may change: the last one starting before it
+ * 
+ * @param this - the json object to search tokens of
+ * @param offset - the offset of the edit
+ * 
+ * @return - the index of the token, 0 if none starts before the offset
+ */
+static unsigned int __findEditedToken(Json const * this, size_t offset);
+
+
+/**
+ * Reads the tokens of an edited json-string, from a token start until the old tokens are met again
+ * Only the characters of these tokens are read, into the edit
+ * 
+ * @param this - the json object being edited
+ * @param edit - the edit, getting the tokens read, the first replaced token and the first kept one after them
+ * 
+ * @return - 0 on success, -1 on failure
+ */
+static int __relex(Json const * this, PendingEdit * edit);
+
+
+/**
+ * Validates the token sequence an edit leads to, and computes its matching brackets
+ * Only the innermost container whose brackets are kept is validated again, the whole sequence if there's none
+ * Nothing is validated when the replacing tokens have the same grammar classes as the replaced ones
+ * 
+ * @param this - the json object being edited
+ * @param edit - the edit, getting the matching brackets of the tokens validated again
+ * 
+ * @return - 0 on success, -1 on failure
+ */
+static int __rematch(Json const * this, PendingEdit * edit);
+
+
+/**
+ * Reads the type, the first character and the offset of a token of the edited sequence
+ * 
+ * @param this - the json object being edited
+ * @param edit - the edit
+ * @param index - the index of the token in the edited sequence
+ * @param type - where to store the type of the token
+ * @param operator - where to store the first character of the token
+ * 
+ * @return - the offset of the token in the edited json-string
+ */
+static size_t __readEditedToken(Json const * this, PendingEdit const * edit, unsigned int index, JsonTokenType * type, char * operator);
+
+
+/**
+ * Replaces the tokens of an edited range by the tokens read again, splicing the list and the entries at the gap
+ * 
+ * @param this - the json object being edited
+ * @param edit - the edit
+ * @param newElements - the list of new tokens
+ */
+static void __spliceTokens(Json * this, PendingEdit const * edit, LinkedList * newElements);
+
+
+/**
+ * Replaces the edited range of the raw string, at the gap
+ * 
+ * @param this - the json object being edited
+ * @param edit - the edit, with room made in the gap for the inserted characters
+ */
+static void __spliceText(Json * this, PendingEdit const * edit);
+
+
+
+
+static Json * new(char const * const jsonString)
+{
+    JsonOptions options;
+
+    __defaultOptions(& options);
+
+    return _Json->newWithOptions(jsonString, & options);
+}
+
+
+static Json * newWithAllocator(char const * const jsonString, Allocator const * allocator)
+{
+    JsonOptions options;
+
+    __defaultOptions(& options);
+    options.allocator = allocator;
+
+    return _Json->newWithOptions(jsonString, & options);
+}
+
+
+static Json * newWithProjection(char const * const jsonString, char const * const * paths, unsigned int pathsCount)
+{
+    JsonOptions options;
+
+    __defaultOptions(& options);
+    options.paths = paths;
+    options.pathsCount = pathsCount;
+
+    return _Json->newWithOptions(jsonString, & options);
+}
+
+
+static Json * newWithOptions(char const * const jsonString, JsonOptions const * options)
+{
+    Json * this;
+    JsonStats stats;
+
+    /* recorded apart until the parse succeeds, so that the json's own block is counted and a rejected one is never written to */
+    memset(& stats, 0, sizeof(stats));
+    JSON_STATS_BEGIN(& stats);
+
+    this = Class->newWithAllocator(options->allocator, "Json", sizeof(* this));
+
+    if (this != NULL) {
+        this->allocator = options->allocator;
+        this->referencesCount = 1;
+
+        if (__parse(this, jsonString, options) != 0) {
+            JSON_STATS_END();
+            _Json->delete(& this);
+            return NULL;
+        }
+    }
+
+    JSON_STATS_END();
+    if (this != NULL) {
+        this->stats = stats;
+    }
+
+    return this;
+}
+
+
+static void delete(Json ** this)
+{
+    if ((this == NULL) || (* this == NULL)) {
+        return;
+    }
+
+    if (CLASS_RELEASE((* this)->referencesCount) > 0) {
+        * this = NULL;
+        return;
+    }
+
+    Class->deleteWithAllocator((* this)->allocator, (void **) & (* this)->rawString);
+    Class->deleteWithAllocator((* this)->allocator, (void **) & (* this)->entries);
+
+    if ((* this)->tokens != NULL) {
+        __deleteTokens(* this, (* this)->tokens);
+        (* this)->tokens = NULL;
+    }
+
+    /* the list elements are released along with their pool */
+    _Pool->delete(& (* this)->tokenPool);
+    _Pool->delete(& (* this)->nodePool);
+
+    Class->deleteWithAllocator((* this)->allocator, (void **) this);
+}
+
+
+static Json * retain(Json * const this)
+{
+    CLASS_RETAIN(this->referencesCount);
+
+    return this;
+}
+
+
+static void freeze(Json * const this)
+{
+    JsonToken * token;
+    unsigned int index;
+
+    /* the raw string is made contiguous once, toString then writes nothing */
+    __closeGap(this);
+
+    /* lazy numbers are the only values converted on access, in bulk unless memory runs out */
+    if (__convertNumbers(this, NULL, 0) >= 0) {
+        this->isFrozen = 1;
+        return;
+    }
+
+    for (index = 0; index < this->tokensCount; index++) {
+        token = LINKED_LIST_CONTENT(__getEntry(this, index)->element);
+        if (JSON_TOKEN_GET_TYPE(token) == JSON_TOKEN_INTEGER) {
+            _JsonToken->asInteger(token);
+        } else if (JSON_TOKEN_GET_TYPE(token) == JSON_TOKEN_FLOAT) {
+            _JsonToken->asFloat(token);
+        }
+    }
+
+    this->isFrozen = 1;
+}
+
+
+static char const * toString(Json const * const this)
+{
+    __closeGap(this);
+
+    return this->rawString;
+}
+
+
+static LinkedList * getTokens(Json const * const this)
+{
+    return this->tokens;
+}
+
+
+static unsigned int getTokensCount(Json const * const this)
+{
+    return this->tokensCount;
+}
+
+
+static JsonToken * getToken(Json const * const this, unsigned int index)
+{
+    if (index >= this->tokensCount) {
+        return NULL;
+    }
+
+    return _LinkedList->getContent(__getEntry(this, index)->element);
+}
+
+
+static int getMatchingIndex(Json const * const this, unsigned int index)
+{
+    if (index >= this->tokensCount) {
+        return -1;
+    }
+
+    return __getMatch(this, index);
+}
+
+
+static int getNumbers(Json const * const this, JsonNumber * numbers, unsigned int capacity)
+{
+    return __convertNumbers(this, numbers, capacity);
+}
+
+
+static int edit(Json * const this, size_t offset, size_t removedLength, char const * const inserted, JsonError * error)
+{
+    PendingEdit pending;
+    unsigned int index;
+    int status;
+    LinkedList * newElements = NULL;
+    LinkedList * lastElement = NULL;
+    LinkedList * element;
+
+    if ((this->referencesCount > 1) || this->isProjected || this->isFrozen || (offset > this->rawLength) || (removedLength > this->rawLength - offset)) {
+        return -1;
+    }
+
+    memset(& pending, 0, sizeof(pending));
+    pending.offset = offset;
+    pending.removedLength = removedLength;
+    pending.inserted = inserted;
+    pending.insertedLength = strlen(inserted);
+    pending.length = this->rawLength - removedLength + pending.insertedLength;
+    pending.error.code = JSON_ERROR_ALLOCATION;
+    pending.error.offset = offset;
+
+    status = __relex(this, & pending);
+
+    if (status == 0) {
+        status = __rematch(this, & pending);
+    }
+
+    if (status == 0) {
+        status = __reserveEntries(this, this->tokensCount - (pending.resumeIndex - pending.first) + pending.lexemesCount);
+    }
+
+    if (status == 0) {
+        status = __reserveGap(this, pending.insertedLength);
+    }
+
+    for (index = 0; (status == 0) && (index < pending.lexemesCount); index++) {
+        element = __newTokenElement(this, pending.lexemes[index].start, pending.lexemes[index].length);
+        if (element == NULL) {
+            pending.error.code = JSON_ERROR_ALLOCATION;
+            pending.error.offset = pending.textOffset + (pending.lexemes[index].start - pending.text);
+            status = -1;
+            break;
+        }
+
+        _LinkedList->append(& lastElement, element);
+        lastElement = element;
+        if (newElements == NULL) {
+            newElements = element;
+        }
+    }
+
+    /* nothing can fail anymore, the json is changed at once */
+    if (status == 0) {
+        __spliceTokens(this, & pending, newElements);
+        __spliceText(this, & pending);
+    } else {
+        __deleteTokens(this, newElements);
+        _LinkedList->deleteInPool(this->nodePool, & newElements);
+
+        if (error != NULL) {
+            * error = pending.error;
+        }
+    }
+
+    Class->deleteWithAllocator(this->allocator, (void **) & pending.text);
+    Class->deleteWithAllocator(this->allocator, (void **) & pending.lexemes);
+    Class->deleteWithAllocator(this->allocator, (void **) & pending.matches);
+
+    return status;
+}
+
+
+static JsonStats const * getStats(Json const * const this)
+{
+    return & this->stats;
+}
+
+
+
+
+static void __defaultOptions(JsonOptions * options)
+{
+    memset(options, 0, sizeof(* options));
+    options->allocator = Class->getAllocator();
+}
+
+
+static int __convertNumbers(Json const * const this, JsonNumber * numbers, unsigned int capacity)
+{
+    NumbersBatch integers;
+    NumbersBatch floats;
+    NumbersBatch * batch;
+    unsigned int count = 0;
+    unsigned int index;
+    JsonToken * token;
+    JsonTokenType type;
 
-    /**
-     * The raw string, without white-spaces between tokens
-     */
-    char * trimmedString;
+    integers.type = JSON_TOKEN_INTEGER;
+    integers.count = 0;
+    floats.type = JSON_TOKEN_FLOAT;
+    floats.count = 0;
 
-    /**
-     * The list of tokens
-     */
-    LinkedList * tokens; 
-};
+    for (index = 0; index < this->tokensCount; index++) {
+        token = LINKED_LIST_CONTENT(__getEntry(this, index)->element);
+        type = JSON_TOKEN_GET_TYPE(token);
+        if ((type != JSON_TOKEN_INTEGER) && (type != JSON_TOKEN_FLOAT)) {
+            continue;
+        }
 
+        /* numbers converted already only need copying */
+        if (token->isConverted) {
+            if (count < capacity) {
+                numbers[count].type = type;
+                numbers[count].value = token->value;
+            }
+            count++;
+            continue;
+        }
 
+        /* the others are gathered by type, then converted together */
+        batch = (type == JSON_TOKEN_INTEGER) ? & integers : & floats;
+        batch->lexemes[batch->count].type = type;
+        batch->lexemes[batch->count].start = JSON_TOKEN_GET_RAW_STRING(token);
+        batch->lexemes[batch->count].length = strlen(batch->lexemes[batch->count].start);
+        batch->tokens[batch->count] = token;
+        batch->indexes[batch->count] = count;
+        batch->count++;
+        count++;
 
+        if ((batch->count == JSON_NUMBERS_BATCH_SIZE) && (__flushNumbers(batch, numbers, capacity) != 0)) {
+            return -1;
+        }
+    }
 
-/**
- * Computes the lenght of the trimmed json-string (@see __trimString)
- * 
- * @param jsonString - the json-string to get the lenght for
- * 
- * @return - the lenght of the trimmed string
- */
-static unsigned int __trimmedStringLength(char const * const jsonString);
+    if ((__flushNumbers(& integers, numbers, capacity) != 0) || (__flushNumbers(& floats, numbers, capacity) != 0)) {
+        return -1;
+    }
 
+    return count;
+}
 
-/**
- * Copies the json-string, without any white-spaces between tokens
- * 
- * @param jsonString - the json-string to trim
- * 
- * @return - the trimmed json-string
- */
-static char * __trimString(char const * const jsonString);
 
+static int __flushNumbers(NumbersBatch * batch, JsonNumber * numbers, unsigned int capacity)
+{
+    JsonValue values[JSON_NUMBERS_BATCH_SIZE];
+    JsonIntegerValue integers[JSON_NUMBERS_BATCH_SIZE];
+    JsonFloatValue floats[JSON_NUMBERS_BATCH_SIZE];
+    unsigned int index;
 
-/**
- * Parses the tokens from the trimmed string
- * 
- * @param this - the json object with a valid trimmed string to extract tokens from
- * 
- * @return - the list of parsed tokens
- */
-static LinkedList * __extractTokens(Json const * this);
+    if (batch->type == JSON_TOKEN_INTEGER) {
+        if (_JsonNumbers->convertIntegers(batch->lexemes, batch->count, integers) != 0) {
+            return -1;
+        }
+        for (index = 0; index < batch->count; index++) {
+            values[index].asInteger = integers[index];
+        }
+    } else {
+        if (_JsonNumbers->convertFloats(batch->lexemes, batch->count, floats) != 0) {
+            return -1;
+        }
+        for (index = 0; index < batch->count; index++) {
+            values[index].asFloat = floats[index];
+        }
+    }
 
+    for (index = 0; index < batch->count; index++) {
+        _JsonToken->setNumber(batch->tokens[index], values[index]);
+        if (batch->indexes[index] < capacity) {
+            numbers[batch->indexes[index]].type = batch->type;
+            numbers[batch->indexes[index]].value = values[index];
+        }
+    }
+    batch->count = 0;
 
+    return 0;
+}
 
 
-static Json * new(char const * const jsonString)
+static int __parse(Json * this, char const * const jsonString, JsonOptions const * options)
 {
-    Json * this;
+    int status;
+    JsonError error;
+    size_t length = strlen(jsonString);
 
-    this = Class->new("Json", sizeof(* this));
+    error.code = JSON_ERROR_ALLOCATION;
+    error.offset = 0;
+    status = -1;
 
-    if (this != NULL) {
-        this->rawString = calloc(strlen(jsonString) + 1, 1);
-        if (this->rawString == NULL) {
-            _Json->delete(& this);
-            return NULL;
+    this->rawString = Class->newWithAllocator(this->allocator, "JsonString", length + 1);
+    this->tokenPool = _JsonToken->newPool(this->allocator);
+    this->nodePool = _LinkedList->newPool(this->allocator);
+
+    if ((this->rawString != NULL) && (this->tokenPool != NULL) && (this->nodePool != NULL)) {
+        memcpy(this->rawString, jsonString, length + 1);
+        this->rawLength = length;
+        this->gapOffset = this->rawLength;
+
+        this->lazyNumbers = (options->lazyNumbers != 0);
+        this->isProjected = (options->paths != NULL);
+
+        JSON_STATS_START(JSON_STAGE_EXTRACT);
+        if (options->paths == NULL) {
+            status = __extractTokens(this, & error);
+        } else if (_JsonProjection->extractTokens(this->rawString, this->rawLength, options->paths, options->pathsCount, this->tokenPool, this->nodePool, this->lazyNumbers, & this->tokens) == 0) {
+            status = __matchTokens(this, & error);
+        } else {
+            error.code = JSON_ERROR_UNEXPECTED_TOKEN;
         }
-        strcpy(this->rawString, jsonString);
+        JSON_STATS_STOP(JSON_STAGE_EXTRACT);
+    }
 
-        this->trimmedString = __trimString(this->rawString);
-        if (this->trimmedString == NULL) {
-            _Json->delete(& this);
-            return NULL;
+    if ((status != 0) && (options->error != NULL)) {
+        * options->error = error;
+    }
+
+    return status;
+}
+
+
+static void __deleteTokens(Json const * this, LinkedList * tokens)
+{
+    JsonToken * token;
+
+    for (; tokens != NULL; tokens = LINKED_LIST_NEXT(tokens)) {
+        token = LINKED_LIST_CONTENT(tokens);
+        _JsonToken->deleteInPool(this->tokenPool, & token);
+    }
+}
+
+
+static int __extractTokens(Json * this, JsonError * error)
+{
+    JsonGrammar grammar;
+    JsonLexeme lexeme;
+    size_t length = this->rawLength;
+    size_t offset = 0;
+    unsigned int openingIndex = 0;
+    int lexerStatus;
+    int grammarStatus;
+    LinkedList * lastToken = NULL;
+    LinkedList * element;
+
+    _JsonGrammar->begin(& grammar);
+
+    while ((lexerStatus = _JsonLexer->next(this->rawString, length, & offset, & lexeme)) == 1) {
+        grammarStatus = _JsonGrammar->feed(& grammar, lexeme.type, lexeme.start[0], lexeme.start - this->rawString, & openingIndex);
+        if (grammarStatus == -1) {
+            * error = grammar.error;
+            return -1;
+        }
+
+        error->offset = lexeme.start - this->rawString;
+        element = __newTokenElement(this, lexeme.start, lexeme.length);
+        if (element == NULL) {
+            return -1;
+        }
+
+        JSON_STATS_START(JSON_STAGE_APPEND);
+        _LinkedList->append(& lastToken, element);
+        lastToken = element;
+        if (this->tokens == NULL) {
+            this->tokens = element;
         }
+        JSON_STATS_STOP(JSON_STAGE_APPEND);
 
-        this->tokens = __extractTokens(this);
+        if (__recordToken(this, element, error->offset, grammarStatus, openingIndex) != 0) {
+            return -1;
+        }
     }
 
-    return this;
+    if (lexerStatus == -1) {
+        error->code = JSON_ERROR_INVALID_TOKEN;
+        error->offset = offset;
+        return -1;
+    }
+
+    if (_JsonGrammar->end(& grammar, offset) != 0) {
+        * error = grammar.error;
+        return -1;
+    }
+
+    return 0;
 }
 
 
-static void delete(Json ** this)
+static int __matchTokens(Json * this, JsonError * error)
 {
-    if ((this == NULL) || (* this == NULL)) {
-        return;
+    JsonGrammar grammar;
+    LinkedList * element;
+    JsonToken * token;
+    JsonTokenType type;
+    JsonOperatorValue operator;
+    unsigned int openingIndex = 0;
+    int status;
+
+    _JsonGrammar->begin(& grammar);
+
+    for (element = this->tokens; element != NULL; element = _LinkedList->nextElement(element)) {
+        token = _LinkedList->getContent(element);
+        type = _JsonToken->getType(token);
+        operator = (type == JSON_TOKEN_OPERATOR) ? _JsonToken->asOperator(token) : '\0';
+
+        /* projected tokens don't keep their offsets, errors are reported at the start */
+        status = _JsonGrammar->feed(& grammar, type, operator, 0, & openingIndex);
+        if (status == -1) {
+            * error = grammar.error;
+            return -1;
+        }
+
+        if (__recordToken(this, element, 0, status, openingIndex) != 0) {
+            return -1;
+        }
     }
 
-    if ((* this)->rawString != NULL) {
-        free((* this)->rawString);
-        (* this)->rawString = NULL;
+    if (_JsonGrammar->end(& grammar, 0) != 0) {
+        * error = grammar.error;
+        return -1;
     }
 
-    if ((* this)->trimmedString != NULL) {
-        free((* this)->trimmedString);
-        (* this)->trimmedString = NULL;
+    return 0;
+}
+
+
+static LinkedList * __newTokenElement(Json const * this, char const * const start, size_t length)
+{
+    JsonToken * token;
+    LinkedList * element;
+
+    JSON_STATS_START(JSON_STAGE_TOKEN);
+    token = _JsonToken->newInPool(this->tokenPool, start, length, this->lazyNumbers);
+    JSON_STATS_STOP(JSON_STAGE_TOKEN);
+    if (token == NULL) {
+        return NULL;
     }
+    JSON_STATS_TOKEN(token);
 
-    if ((* this)->tokens != NULL) {
-        _LinkedList->delete(& (* this)->tokens);
+    element = _LinkedList->newInPool(this->nodePool, token);
+    if (element == NULL) {
+        _JsonToken->deleteInPool(this->tokenPool, & token);
     }
 
-    Class->delete((void **) this);
+    return element;
 }
 
 
-static char const * toString(Json const * const this)
+static int __reserveEntries(Json * this, unsigned int count)
 {
-    return this->rawString;
+    unsigned int capacity = this->entriesCapacity;
+
+    if (count <= capacity) {
+        return 0;
+    }
+
+    /* matching indexes are given as ints */
+    if (count > INT_MAX) {
+        return -1;
+    }
+
+    if (capacity == 0) {
+        capacity = 16;
+    }
+    while (capacity < count) {
+        capacity = (capacity > INT_MAX / 2) ? INT_MAX : capacity * 2;
+    }
+
+    if (this->entries == NULL) {
+        this->entries = Class->newWithAllocator(this->allocator, "TokenEntry[]", capacity * sizeof(TokenEntry));
+        if (this->entries == NULL) {
+            return -1;
+        }
+    } else if (Class->resizeWithAllocator(this->allocator, (void **) & this->entries, this->entriesCapacity * sizeof(TokenEntry), capacity * sizeof(TokenEntry)) != 0) {
+        return -1;
+    }
+
+    /* the entries after the gap stay at the end */
+    memmove(this->entries + capacity - (this->tokensCount - this->entriesGap), this->entries + this->entriesCapacity - (this->tokensCount - this->entriesGap), (this->tokensCount - this->entriesGap) * sizeof(TokenEntry));
+    this->entriesCapacity = capacity;
+
+    return 0;
 }
 
 
-static LinkedList * getTokens(Json const * const this)
+static int __recordToken(Json * this, LinkedList * element, size_t offset, int status, unsigned int openingIndex)
 {
-    return this->tokens;
+    TokenEntry * entry;
+
+    if (__reserveEntries(this, this->tokensCount + 1) != 0) {
+        return -1;
+    }
+
+    entry = & this->entries[this->tokensCount];
+    entry->element = element;
+    entry->offset = offset;
+    entry->match = this->tokensCount;
+    if (status == 1) {
+        this->entries[openingIndex].match = this->tokensCount;
+        entry->match = openingIndex;
+    }
+    this->tokensCount++;
+    this->entriesGap = this->tokensCount;
+
+    return 0;
 }
 
 
+static char __grammarClass(JsonTokenType type, char operator)
+{
+    switch (type) {
+        case JSON_TOKEN_OPERATOR:
+            return operator;
+        case JSON_TOKEN_STRING:
+            return 's';
+        default:
+            return 'v';
+    }
+}
 
 
-static unsigned int __trimmedStringLength(char const * const string)
+static TokenEntry * __getEntry(Json const * this, unsigned int index)
 {
-    unsigned int stringIndex;
-    int inQuotes = 0;
-    unsigned int length = 0;
+    if (index >= this->entriesGap) {
+        index += this->entriesCapacity - this->tokensCount;
+    }
 
-    for (stringIndex = 0; string[stringIndex] != '\0'; stringIndex++) {
-        if ((string[stringIndex] == ' ') || (string[stringIndex] == '\t') || (string[stringIndex] == '\n')) {
-            if (! inQuotes) {
-                continue;
-            }
+    return & this->entries[index];
+}
+
+
+static size_t __getOffset(Json const * this, unsigned int index)
+{
+    size_t offset = __getEntry(this, index)->offset;
+
+    return (index < this->entriesGap) ? offset : this->rawLength - offset;
+}
+
+
+static unsigned int __getMatch(Json const * this, unsigned int index)
+{
+    int match = __getEntry(this, index)->match;
+
+    return (match >= 0) ? (unsigned int) match : this->tokensCount - (unsigned int) - match;
+}
+
+
+static void __setMatch(Json * this, unsigned int index, unsigned int match)
+{
+    __getEntry(this, index)->match = (match < this->entriesGap) ? (int) match : - (int) (this->tokensCount - match);
+}
+
+
+static void __moveEntriesGap(Json * this, unsigned int index)
+{
+    unsigned int gapLength = this->entriesCapacity - this->tokensCount;
+    unsigned int from = (index < this->entriesGap) ? index : this->entriesGap;
+    unsigned int to = (index < this->entriesGap) ? this->entriesGap : index;
+    unsigned int current;
+    unsigned int match;
+    TokenEntry * entry;
+
+    if (index < this->entriesGap) {
+        memmove(this->entries + index + gapLength, this->entries + index, (this->entriesGap - index) * sizeof(TokenEntry));
+    } else {
+        memmove(this->entries + this->entriesGap, this->entries + this->entriesGap + gapLength, (index - this->entriesGap) * sizeof(TokenEntry));
+    }
+    this->entriesGap = index;
+
+    /* the entries crossing the gap switch how they hold their offset, and the brackets matching them how they refer to them */
+    for (current = from; current < to; current++) {
+        entry = __getEntry(this, current);
+        entry->offset = this->rawLength - entry->offset;
+
+        /* matches are read the same from either side, those of entries crossing too are only rewritten when they're met */
+        match = __getMatch(this, current);
+        __setMatch(this, current, match);
+        if ((match < from) || (match >= to)) {
+            __setMatch(this, match, current);
+        }
+    }
+}
+
+
+static void __moveGap(Json * this, size_t offset)
+{
+    if (offset < this->gapOffset) {
+        memmove(this->rawString + offset + this->gapLength, this->rawString + offset, this->gapOffset - offset);
+    } else {
+        memmove(this->rawString + this->gapOffset, this->rawString + this->gapOffset + this->gapLength, offset - this->gapOffset);
+    }
+
+    this->gapOffset = offset;
+}
+
+
+static int __reserveGap(Json * this, size_t length)
+{
+    size_t size = this->rawLength + this->gapLength + 1;
+    char * rawString;
+
+    if (this->gapLength >= length) {
+        return 0;
+    }
+
+    /* growing by half keeps edits amortized, without doubling large json-strings */
+    size += size / 2 + length;
+    rawString = Class->newWithAllocator(this->allocator, "JsonString", size);
+    if (rawString == NULL) {
+        return -1;
+    }
+
+    memcpy(rawString, this->rawString, this->gapOffset);
+    memcpy(rawString + size - (this->rawLength - this->gapOffset) - 1, this->rawString + this->gapOffset + this->gapLength, this->rawLength - this->gapOffset + 1);
+
+    Class->deleteWithAllocator(this->allocator, (void **) & this->rawString);
+    this->rawString = rawString;
+    this->gapLength = size - this->rawLength - 1;
+
+    return 0;
+}
+
+
+static void __closeGap(Json const * this)
+{
+    Json * contiguous = (Json *) this;
+
+    if (this->gapOffset < this->rawLength) {
+        __moveGap(contiguous, this->rawLength);
+    }
+
+    if (this->rawString[this->rawLength] != '\0') {
+        contiguous->rawString[this->rawLength] = '\0';
+    }
+}
+
+
+static void __copyText(Json const * this, size_t offset, size_t count, char * destination)
+{
+    size_t beforeGap = 0;
+
+    if (offset < this->gapOffset) {
+        beforeGap = (this->gapOffset - offset < count) ? this->gapOffset - offset : count;
+        memcpy(destination, this->rawString + offset, beforeGap);
+    }
+
+    memcpy(destination + beforeGap, this->rawString + offset + beforeGap + this->gapLength, count - beforeGap);
+}
+
+
+static void __copyEdited(Json const * this, PendingEdit const * edit, size_t offset, size_t count, char * destination)
+{
+    size_t insertedEnd = edit->offset + edit->insertedLength;
+    size_t piece;
+
+    while (count > 0) {
+        if (offset < edit->offset) {
+            piece = (edit->offset - offset < count) ? edit->offset - offset : count;
+            __copyText(this, offset, piece, destination);
+        } else if (offset < insertedEnd) {
+            piece = (insertedEnd - offset < count) ? insertedEnd - offset : count;
+            memcpy(destination, edit->inserted + offset - edit->offset, piece);
+        } else {
+            piece = count;
+            __copyText(this, offset - edit->insertedLength + edit->removedLength, piece, destination);
+        }
+
+        offset += piece;
+        count -= piece;
+        destination += piece;
+    }
+}
+
+
+static int __readMore(Json const * this, PendingEdit * edit)
+{
+    size_t count = (edit->textLength > JSON_EDIT_READ_STEP) ? edit->textLength : JSON_EDIT_READ_STEP;
+    size_t remaining = edit->length - edit->textOffset - edit->textLength;
+    unsigned int index;
+    char * text;
+
+    if (count > remaining) {
+        count = remaining;
+    }
+
+    if (edit->textLength + count > edit->textCapacity) {
+        text = Class->newWithAllocator(this->allocator, "JsonString", edit->textLength + count);
+        if (text == NULL) {
+            return -1;
         }
 
-        if (string[stringIndex] == '"') {
-            if (stringIndex == 0) {
-                inQuotes = ! inQuotes;
-            } else if (string[stringIndex - 1] != '\\') {
-                inQuotes = ! inQuotes;
+        if (edit->text != NULL) {
+            memcpy(text, edit->text, edit->textLength);
+            for (index = 0; index < edit->lexemesCount; index++) {
+                edit->lexemes[index].start = text + (edit->lexemes[index].start - edit->text);
             }
+            Class->deleteWithAllocator(this->allocator, (void **) & edit->text);
         }
+        edit->text = text;
+        edit->textCapacity = edit->textLength + count;
+    }
+
+    __copyEdited(this, edit, edit->textOffset + edit->textLength, count, edit->text + edit->textLength);
+    edit->textLength += count;
+
+    return 0;
+}
+
+
+static unsigned int __findEditedToken(Json const * this, size_t offset)
+{
+    unsigned int low = 0;
+    unsigned int high = this->tokensCount;
+    unsigned int middle;
 
-        length++;
+    while (low < high) {
+        middle = low + (high - low) / 2;
+        if (__getOffset(this, middle) < offset) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
     }
 
-    return length;
+    return (low > 0) ? low - 1 : 0;
 }
 
 
-static char * __trimString(char const * const string)
+static int __relex(Json const * this, PendingEdit * edit)
 {
-    unsigned int stringIndex;
-    int inQuotes = 0;
-    unsigned int length;
-    char * trimmedString;
-    unsigned int trimmedIndex;
-    
-    length = __trimmedStringLength(string);
-    trimmedString = calloc(length + 1, 1);
-    if (trimmedString == NULL) {
-        return NULL;
+    unsigned int index;
+    size_t position = 0;
+    size_t tokenStart;
+    unsigned int capacity;
+    int status;
+    int isLast;
+    JsonLexeme lexeme;
+
+    edit->first = __findEditedToken(this, edit->offset);
+    edit->textOffset = __getOffset(this, edit->first);
+    if (edit->offset < edit->textOffset) {
+        edit->textOffset = edit->offset;
     }
+    index = edit->first;
+
+    for (;;) {
+        isLast = (edit->textOffset + edit->textLength == edit->length);
+        status = _JsonLexer->nextInChunk(edit->text, edit->textLength, & position, & lexeme, isLast);
 
-    for (trimmedIndex = 0, stringIndex = 0; string[stringIndex] != '\0'; stringIndex++) {
-        if ((string[stringIndex] == ' ') || (string[stringIndex] == '\t') || (string[stringIndex] == '\n')) {
-            if (! inQuotes) {
-                continue;
+        /* tokens reaching the end of the characters read may go on further, more are read then */
+        if ((status == 0) && ! isLast) {
+            if (__readMore(this, edit) != 0) {
+                return -1;
             }
+            continue;
         }
 
-        if (string[stringIndex] == '"') {
-            if (stringIndex == 0) {
-                inQuotes = ! inQuotes;
-            } else if (string[stringIndex - 1] != '\\') {
-                inQuotes = ! inQuotes;
+        if (status != 1) {
+            break;
+        }
+
+        tokenStart = edit->textOffset + (lexeme.start - edit->text);
+
+        /* the lexer keeps no state between tokens: once a token starts where an old one did, the rest reads the same */
+        if (tokenStart >= edit->offset + edit->insertedLength) {
+            while ((index < this->tokensCount) && (__getOffset(this, index) + edit->insertedLength < tokenStart + edit->removedLength)) {
+                index++;
+            }
+            if ((index < this->tokensCount) && (__getOffset(this, index) + edit->insertedLength == tokenStart + edit->removedLength)) {
+                edit->resumeIndex = index;
+                return 0;
+            }
+        }
+
+        if (edit->lexemesCount == edit->lexemesCapacity) {
+            capacity = (edit->lexemesCapacity == 0) ? 16 : edit->lexemesCapacity * 2;
+            if (edit->lexemes == NULL) {
+                edit->lexemes = Class->newWithAllocator(this->allocator, "JsonLexeme[]", capacity * sizeof(JsonLexeme));
+            } else if (Class->resizeWithAllocator(this->allocator, (void **) & edit->lexemes, edit->lexemesCapacity * sizeof(JsonLexeme), capacity * sizeof(JsonLexeme)) != 0) {
+                return -1;
+            }
+            if (edit->lexemes == NULL) {
+                return -1;
             }
+            edit->lexemesCapacity = capacity;
         }
 
-        trimmedString[trimmedIndex] = string[stringIndex];
-        trimmedIndex++;
+        edit->lexemes[edit->lexemesCount] = lexeme;
+        edit->lexemesCount++;
     }
 
-    return trimmedString;
+    if (status == -1) {
+        edit->error.code = JSON_ERROR_INVALID_TOKEN;
+        edit->error.offset = edit->textOffset + position;
+        return -1;
+    }
+
+    edit->resumeIndex = this->tokensCount;
+
+    return 0;
 }
 
 
-static LinkedList * __extractTokens(Json const * this)
+static int __rematch(Json const * this, PendingEdit * edit)
 {
-    char * tokenStart = this->trimmedString;
-    char * tokenEnd = tokenStart + 1;
-    char * tokenBuffer;
-    LinkedList * tokens = NULL;
-    JsonToken * currentToken;
+    unsigned int removedCount = edit->resumeIndex - edit->first;
+    unsigned int count = this->tokensCount - removedCount + edit->lexemesCount;
+    unsigned int index;
+    unsigned int match;
+    size_t offset;
+    size_t endOffset = edit->length;
+    unsigned int openingIndex = 0;
+    int status;
+    int isSameClasses;
+    JsonGrammar grammar;
+    JsonToken * token;
+    JsonTokenType type;
+    char operator;
 
-    while (* (tokenEnd - 1) != '\0') {
-        tokenBuffer = calloc(tokenEnd - tokenStart + 1, 1);
-        if (tokenBuffer == NULL) {
-            return NULL;
+    /* the replacing tokens have the same grammar classes as the replaced ones, which keep their matches */
+    isSameClasses = (removedCount == edit->lexemesCount);
+    for (index = 0; isSameClasses && (index < edit->lexemesCount); index++) {
+        token = _LinkedList->getContent(__getEntry(this, edit->first + index)->element);
+        isSameClasses = (__grammarClass(_JsonToken->getType(token), _JsonToken->getRawString(token)[0]) == __grammarClass(edit->lexemes[index].type, edit->lexemes[index].start[0]));
+    }
+
+    edit->matchesStart = isSameClasses ? edit->first : 0;
+    edit->matchesCount = isSameClasses ? edit->lexemesCount : count;
+
+    /* otherwise the innermost container whose brackets are kept is validated again, complete values before the replaced tokens being skipped at once */
+    for (index = edit->first; ! isSameClasses && (index > 0); index--) {
+        match = __getMatch(this, index - 1);
+        if (match < index - 1) {
+            index = match + 1;
+        } else if ((match > index - 1) && (match >= edit->resumeIndex)) {
+            edit->matchesStart = index - 1;
+            edit->matchesCount = match - removedCount + edit->lexemesCount + 1 - edit->matchesStart;
+            endOffset = __getOffset(this, match) - edit->removedLength + edit->insertedLength;
+            break;
+        }
+    }
+
+    edit->matches = Class->newWithAllocator(this->allocator, "unsigned int[]", (edit->matchesCount + 1) * sizeof(unsigned int));
+    if (edit->matches == NULL) {
+        return -1;
+    }
+
+    if (isSameClasses) {
+        for (index = 0; index < edit->matchesCount; index++) {
+            edit->matches[index] = __getMatch(this, edit->first + index);
+        }
+        return 0;
+    }
+
+    _JsonGrammar->begin(& grammar);
+
+    for (index = 0; index < edit->matchesCount; index++) {
+        offset = __readEditedToken(this, edit, edit->matchesStart + index, & type, & operator);
+
+        status = _JsonGrammar->feed(& grammar, type, operator, offset, & openingIndex);
+        if (status == -1) {
+            edit->error = grammar.error;
+            return -1;
+        }
+
+        edit->matches[index] = edit->matchesStart + index;
+        if (status == 1) {
+            edit->matches[openingIndex] = edit->matchesStart + index;
+            edit->matches[index] = edit->matchesStart + openingIndex;
         }
-        strncpy(tokenBuffer, tokenStart, tokenEnd - tokenStart);
-        tokenBuffer[tokenEnd - tokenStart] = '\0';
+    }
+
+    if (_JsonGrammar->end(& grammar, endOffset) != 0) {
+        edit->error = grammar.error;
+        return -1;
+    }
+
+    return 0;
+}
+
+
+static size_t __readEditedToken(Json const * this, PendingEdit const * edit, unsigned int index, JsonTokenType * type, char * operator)
+{
+    JsonLexeme const * lexeme;
+    JsonToken * token;
+    unsigned int removedCount = edit->resumeIndex - edit->first;
+
+    if ((index >= edit->first) && (index < edit->first + edit->lexemesCount)) {
+        lexeme = & edit->lexemes[index - edit->first];
+        * type = lexeme->type;
+        * operator = lexeme->start[0];
+        return edit->textOffset + (lexeme->start - edit->text);
+    }
+
+    if (index >= edit->first) {
+        index = index - edit->lexemesCount + removedCount;
+    }
+    token = _LinkedList->getContent(__getEntry(this, index)->element);
+    * type = _JsonToken->getType(token);
+    * operator = _JsonToken->getRawString(token)[0];
+
+    return (index < edit->first) ? __getOffset(this, index) : __getOffset(this, index) - edit->removedLength + edit->insertedLength;
+}
+
+
+static void __spliceTokens(Json * this, PendingEdit const * edit, LinkedList * newElements)
+{
+    unsigned int removedCount = edit->resumeIndex - edit->first;
+    unsigned int index;
+    LinkedList * previous = NULL;
+    LinkedList * removed = NULL;
+    LinkedList * kept;
+    LinkedList * element;
+    TokenEntry * entry;
 
+    if (edit->first > 0) {
+        previous = __getEntry(this, edit->first - 1)->element;
+        kept = _LinkedList->detachNext(previous);
+    } else {
+        kept = this->tokens;
+    }
+
+    if (removedCount > 0) {
+        removed = kept;
+        kept = _LinkedList->detachNext(__getEntry(this, edit->resumeIndex - 1)->element);
+    }
+    __deleteTokens(this, removed);
+    _LinkedList->deleteInPool(this->nodePool, & removed);
 
-        currentToken = _JsonToken->new(tokenBuffer);
-        if (currentToken != NULL) {
-            _LinkedList->append(& tokens, _LinkedList->new(currentToken));
-            tokenStart = tokenEnd;
+    if (newElements == NULL) {
+        newElements = kept;
+    } else if (kept != NULL) {
+        element = newElements;
+        while (_LinkedList->nextElement(element) != NULL) {
+            element = _LinkedList->nextElement(element);
         }
+        _LinkedList->append(& element, kept);
+    }
 
-        tokenEnd++;
+    if (previous == NULL) {
+        this->tokens = newElements;
+    } else if (newElements != NULL) {
+        _LinkedList->append(& previous, newElements);
+    }
+
+    /* the replaced entries follow the gap once it's moved to them, dropping them widens it, and the new ones fill it from the start */
+    __moveEntriesGap(this, edit->first);
+    this->tokensCount -= removedCount;
+
+    element = newElements;
+    for (index = edit->first; index < edit->first + edit->lexemesCount; index++) {
+        entry = & this->entries[index];
+        entry->element = element;
+        entry->offset = edit->textOffset + (edit->lexemes[index - edit->first].start - edit->text);
+        entry->match = index;
+        element = _LinkedList->nextElement(element);
+    }
+    this->entriesGap += edit->lexemesCount;
+    this->tokensCount += edit->lexemesCount;
 
-        free(tokenBuffer);
+    for (index = 0; index < edit->matchesCount; index++) {
+        __setMatch(this, edit->matchesStart + index, edit->matches[index]);
+        __setMatch(this, edit->matches[index], edit->matchesStart + index);
     }
+}
+
+
+static void __spliceText(Json * this, PendingEdit const * edit)
+{
+    __moveGap(this, edit->offset);
 
-    return tokens;
+    this->gapLength += edit->removedLength;
+    memcpy(this->rawString + this->gapOffset, edit->inserted, edit->insertedLength);
+    this->gapOffset += edit->insertedLength;
+    this->gapLength -= edit->insertedLength;
+    this->rawLength = edit->length;
 }
 
 
@@ -232,8 +1640,19 @@ static LinkedList * __extractTokens(Json const * this)
  */
 static _JsonMethods methods = {
     new,
+    newWithAllocator,
+    newWithProjection,
+    newWithOptions,
     delete,
+    retain,
+    freeze,
     toString,
-    getTokens
+    getTokens,
+    getTokensCount,
+    getToken,
+    getMatchingIndex,
+    getNumbers,
+    edit,
+    getStats
 };
 _JsonMethods const * const _Json = & methods;
@@ -2,7 +2,12 @@
 #ifndef JSON_HEADER
 #define JSON_HEADER
 
+#include "Class.h"
 #include "LinkedList.h"
+#include "JsonToken.h"
+#include "JsonNumbers.h"
+#include "JsonStats.h"
+#include "JsonGrammar.h"
 
 
 
@@ -13,6 +18,40 @@
 typedef struct Json Json;
 
 
+/**
+ * Options of a json parsing
+ */
+typedef struct
+{
+    /**
+     * The allocator of the json and all its tokens, NULL for the standard one
+     * It must outlive the json, it is used again on deletion
+     */
+    Allocator const * allocator;
+
+    /**
+     * The paths to extract tokens of, NULL to extract every token (@see JsonProjection.extractTokens)
+     */
+    char const * const * paths;
+
+    /**
+     * The number of paths
+     */
+    unsigned int pathsCount;
+
+    /**
+     * Whether integer and float tokens are converted on first access rather than on creation
+     */
+    int lazyNumbers;
+
+    /**
+     * Where to store why the json-string is rejected, NULL to ignore it
+     */
+    JsonError * error;
+
+} JsonOptions;
+
+
 
 
 /**
@@ -30,14 +69,69 @@ typedef struct
     Json * (* new)(char const * const jsonString);
 
     /**
-     * Destructor, sets the pointer to NULL
+     * Constructor, allocating the json and all its tokens with the given allocator
+     * The allocator must outlive the json, it is used again on deletion
+     * 
+     * @param jsonString - the json-string to parse
+     * @param allocator - the allocator to use, NULL for the standard one
+     * 
+     * @return - a Json instance if parsing and allocation succeed, NULL otherwise
+     */
+    Json * (* newWithAllocator)(char const * const jsonString, Allocator const * allocator);
+
+    /**
+     * Constructor, only extracting the tokens of the requested paths and of their ancestors
+     * Paths are json pointers through object members, @see JsonProjection.extractTokens
+     * 
+     * @param jsonString - the json-string to parse
+     * @param paths - the paths to extract
+     * @param pathsCount - the number of paths
+     * 
+     * @return - a Json instance if parsing and allocation succeed, NULL otherwise
+     */
+    Json * (* newWithProjection)(char const * const jsonString, char const * const * paths, unsigned int pathsCount);
+
+    /**
+     * Constructor, with every parsing option
+     * 
+     * @param jsonString - the json-string to parse
+     * @param options - the parsing options
+     * 
+     * @return - a Json instance if parsing and allocation succeed, NULL otherwise
+     */
+    Json * (* newWithOptions)(char const * const jsonString, JsonOptions const * options);
+
+    /**
+     * Destructor, releases a reference to the instance and sets the pointer to NULL
+     * The instance is only deleted once every reference is released
      * 
      * @param this - pointer to the instance to delete
      */
     void (* delete)(Json ** this);
 
+    /**
+     * Adds a reference to the instance, to be released with delete
+     * 
+     * @param this - the instance to share
+     * 
+     * @return - the instance
+     */
+    Json * (* retain)(Json * const this);
+
+    /**
+     * Makes the json immutable, so that any number of threads may read it and retain or delete references to it
+     * Numbers converted lazily are converted at once, reads then write nothing, and edits are refused
+     * The json must be frozen before it's shared, by the thread which parsed it
+     * Whichever thread releases the last reference frees the json through its own allocator and pools, touching no global
+     * (stats built with JSON_INSTRUMENTATION are process-wide, and aren't meant for concurrent parses)
+     * 
+     * @param this - the json to freeze
+     */
+    void (* freeze)(Json * const this);
+
     /**
      * Returns the json as a string
+     * After edits, the characters are first moved together, which a frozen json never needs
      * 
      * @param this - the instance to turn into a string
      * 
@@ -54,6 +148,74 @@ typedef struct
      */
     LinkedList * (* getTokens)(Json const * const this);
 
+    /**
+     * Returns the number of parsed tokens
+     * 
+     * @param this - the json to count tokens of
+     * 
+     * @return - the number of tokens
+     */
+    unsigned int (* getTokensCount)(Json const * const this);
+
+    /**
+     * Returns the token at the given index, without walking the list
+     * 
+     * @param this - the json the token belongs to
+     * @param index - the index of the token in the list of tokens
+     * 
+     * @return - the token, NULL if the index is out of range
+     */
+    JsonToken * (* getToken)(Json const * const this, unsigned int index);
+
+    /**
+     * Returns the index of the bracket matching the token at the given index, to skip containers at once
+     * 
+     * @param this - the json the token belongs to
+     * @param index - the index of the token in the list of tokens
+     * 
+     * @return - the index of the matching bracket, the given index if the token isn't a bracket, -1 if it's out of range
+     */
+    int (* getMatchingIndex)(Json const * const this, unsigned int index);
+
+    /**
+     * Converts every integer and float token in bulk, storing their values in the tokens as accessing them would
+     * Best parsed with lazy numbers, so that lexing only records the numbers
+     * The json mustn't be read from other threads meanwhile, unless it's frozen (@see freeze)
+     * 
+     * @param this - the json to get numbers of
+     * @param numbers - where to store each number with its type, in document order
+     * @param capacity - the number of numbers there is room for, further numbers are only counted
+     * 
+     * @return - the number of integer and float tokens, -1 if memory runs out converting numbers too long for the stack
+     */
+    int (* getNumbers)(Json const * const this, JsonNumber * numbers, unsigned int capacity);
+
+    /**
+     * Replaces a range of the json-string, only reading again the tokens around it
+     * Only the innermost container enclosing the edited tokens is validated again, and tokens after the range are kept as they are,
+     * so that an edit costs its own size and the distance from the previous edit, rather than the size of the json
+     * The json must be neither shared nor projected, and is left untouched on failure
+     * 
+     * @param this - the json to edit
+     * @param offset - the offset of the range in the json-string
+     * @param removedLength - the length of the range
+     * @param inserted - the characters replacing the range
+     * @param error - where to store why the edited json-string is rejected, NULL to ignore it
+     * 
+     * @return - 0 on success, -1 on failure
+     */
+    int (* edit)(Json * const this, size_t offset, size_t removedLength, char const * const inserted, JsonError * error);
+
+    /**
+     * Returns the counters gathered while parsing the json
+     * They stay zeroed unless the library is built with JSON_INSTRUMENTATION
+     * 
+     * @param this - the json to get stats of
+     * 
+     * @return - the parsing stats
+     */
+    JsonStats const * (* getStats)(Json const * const this);
+
 } _JsonMethods;
 
 
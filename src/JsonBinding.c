@@ -0,0 +1,398 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Class.h"
+#include "JsonToken.h"
+#include "JsonLexer.h"
+#include "JsonNumbers.h"
+#include "JsonBinding.h"
+
+
+
+
+/**
+ * Number of seeds tried for a table size before doubling it
+ */
+#define JSON_BINDING_SEEDS 64
+
+
+/**
+ * Size of the table above which no perfect hash is searched anymore
+ */
+#define JSON_BINDING_MAX_SLOTS 65536
+
+
+struct JsonBinding
+{
+    /**
+     * The descriptors of the struct members
+     */
+    JsonBindingField const * fields;
+
+    /**
+     * The number of descriptors
+     */
+    unsigned int fieldsCount;
+
+    /**
+     * The seed of the perfect hash
+     */
+    unsigned long seed;
+
+    /**
+     * The size of the hash table, a power of 2
+     */
+    unsigned int slotsCount;
+
+    /**
+     * The hash table, storing the index of the field plus 1, 0 for empty slots
+     */
+    unsigned int * slots;
+
+    /**
+     * The compiled nested structs, NULL for fields which aren't objects
+     */
+    JsonBinding ** nestedBindings;
+};
+
+
+
+
+/**
+ * Hashes a key
+ * 
+ * @param key - the characters of the key
+ * @param length - the number of characters of the key
+ * @param seed - the seed of the hash
+ * 
+ * @return - the hash of the key
+ */
+static unsigned long __hash(char const * const key, size_t length, unsigned long seed);
+
+
+/**
+ * Searches a seed and a table size for which no key collide
+ * 
+ * @param this - the binding to fill the hash table of
+ * 
+ * @return - 0 on success, -1 if none was found or allocation failed
+ */
+static int __buildSlots(JsonBinding * const this);
+
+
+/**
+ * Finds the field matching the key with a single probe
+ * 
+ * @param this - the binding to search the field in
+ * @param key - the characters of the key, without quotes
+ * @param length - the number of characters of the key
+ * 
+ * @return - the index of the field, -1 if the key is unknown
+ */
+static int __findField(JsonBinding const * const this, char const * const key, size_t length);
+
+
+/**
+ * Checks if the token is the given operator
+ * 
+ * @param lexeme - the token to check
+ * @param operator - the expected operator
+ * 
+ * @return - 1 if the token is the operator, 0 otherwise
+ */
+static int __isOperator(JsonLexeme const * const lexeme, JsonOperator operator);
+
+
+/**
+ * Binds the object following the offset into the struct
+ * 
+ * @param this - the binding describing the struct
+ * @param string - the json-string to read from
+ * @param length - the length of the json-string
+ * @param offset - the offset to read from, moved past the object
+ * @param target - the struct to write into
+ * 
+ * @return - 0 on success, -1 on failure
+ */
+static int __bindObject(JsonBinding const * const this, char const * const string, size_t length, size_t * offset, char * target);
+
+
+/**
+ * Binds the value following the offset into a struct member
+ * 
+ * @param this - the binding describing the struct
+ * @param fieldIndex - the index of the field describing the member
+ * @param string - the json-string to read from
+ * @param length - the length of the json-string
+ * @param offset - the offset to read from, moved past the value
+ * @param target - the struct to write into
+ * 
+ * @return - 0 on success, -1 on failure
+ */
+static int __bindValue(JsonBinding const * const this, unsigned int fieldIndex, char const * const string, size_t length, size_t * offset, char * target);
+
+
+
+
+static JsonBinding * new(JsonBindingField const * fields, unsigned int fieldsCount)
+{
+    JsonBinding * this;
+    unsigned int fieldIndex;
+
+    this = Class->new("JsonBinding", sizeof(* this));
+
+    if (this != NULL) {
+        this->fields = fields;
+        this->fieldsCount = fieldsCount;
+
+        if (__buildSlots(this) != 0) {
+            _JsonBinding->delete(& this);
+            return NULL;
+        }
+
+        this->nestedBindings = Class->new("JsonBinding[]", sizeof(JsonBinding *) * (fieldsCount + 1));
+        if (this->nestedBindings == NULL) {
+            _JsonBinding->delete(& this);
+            return NULL;
+        }
+
+        for (fieldIndex = 0; fieldIndex < fieldsCount; fieldIndex++) {
+            if (fields[fieldIndex].type != JSON_BINDING_OBJECT) {
+                continue;
+            }
+
+            this->nestedBindings[fieldIndex] = _JsonBinding->new(fields[fieldIndex].fields, fields[fieldIndex].fieldsCount);
+            if (this->nestedBindings[fieldIndex] == NULL) {
+                _JsonBinding->delete(& this);
+                return NULL;
+            }
+        }
+    }
+
+    return this;
+}
+
+
+static void delete(JsonBinding ** this)
+{
+    unsigned int fieldIndex;
+
+    if ((this == NULL) || (* this == NULL)) {
+        return;
+    }
+
+    if ((* this)->nestedBindings != NULL) {
+        for (fieldIndex = 0; fieldIndex < (* this)->fieldsCount; fieldIndex++) {
+            _JsonBinding->delete(& (* this)->nestedBindings[fieldIndex]);
+        }
+        Class->delete((void **) & (* this)->nestedBindings);
+    }
+
+    Class->delete((void **) & (* this)->slots);
+    Class->delete((void **) this);
+}
+
+
+static int bind(JsonBinding const * const this, char const * const string, size_t length, void * target)
+{
+    size_t offset = 0;
+    JsonLexeme lexeme;
+
+    if ((string == NULL) || (target == NULL)) {
+        return -1;
+    }
+
+    if (__bindObject(this, string, length, & offset, target) != 0) {
+        return -1;
+    }
+
+    /* nothing but white-spaces may follow the object */
+    if (_JsonLexer->next(string, length, & offset, & lexeme) != 0) {
+        return -1;
+    }
+
+    return 0;
+}
+
+
+
+
+static unsigned long __hash(char const * const key, size_t length, unsigned long seed)
+{
+    size_t index;
+    unsigned long hash = (2166136261UL ^ seed) & 0xFFFFFFFFUL;
+
+    for (index = 0; index < length; index++) {
+        hash ^= (unsigned char) key[index];
+        hash = (hash * 16777619UL) & 0xFFFFFFFFUL;
+    }
+
+    return hash;
+}
+
+
+static int __buildSlots(JsonBinding * const this)
+{
+    unsigned int fieldIndex;
+    unsigned int slotIndex;
+    unsigned long seed;
+
+    for (this->slotsCount = 1; this->slotsCount < this->fieldsCount * 2; this->slotsCount *= 2);
+
+    for (; this->slotsCount <= JSON_BINDING_MAX_SLOTS; this->slotsCount *= 2) {
+        Class->delete((void **) & this->slots);
+        this->slots = Class->new("JsonBindingSlots", sizeof(unsigned int) * this->slotsCount);
+        if (this->slots == NULL) {
+            return -1;
+        }
+
+        for (seed = 0; seed < JSON_BINDING_SEEDS; seed++) {
+            memset(this->slots, 0, sizeof(unsigned int) * this->slotsCount);
+
+            for (fieldIndex = 0; fieldIndex < this->fieldsCount; fieldIndex++) {
+                slotIndex = __hash(this->fields[fieldIndex].name, strlen(this->fields[fieldIndex].name), seed) & (this->slotsCount - 1);
+                if (this->slots[slotIndex] != 0) {
+                    break;
+                }
+                this->slots[slotIndex] = fieldIndex + 1;
+            }
+
+            if (fieldIndex == this->fieldsCount) {
+                this->seed = seed;
+                return 0;
+            }
+        }
+    }
+
+    return -1;
+}
+
+
+static int __findField(JsonBinding const * const this, char const * const key, size_t length)
+{
+    unsigned int slot;
+    JsonBindingField const * field;
+
+    slot = this->slots[__hash(key, length, this->seed) & (this->slotsCount - 1)];
+    if (slot == 0) {
+        return -1;
+    }
+
+    field = & this->fields[slot - 1];
+    if ((strlen(field->name) != length) || (memcmp(field->name, key, length) != 0)) {
+        return -1;
+    }
+
+    return slot - 1;
+}
+
+
+static int __isOperator(JsonLexeme const * const lexeme, JsonOperator operator)
+{
+    return (lexeme->type == JSON_TOKEN_OPERATOR) && (lexeme->start[0] == (char) operator);
+}
+
+
+static int __bindObject(JsonBinding const * const this, char const * const string, size_t length, size_t * offset, char * target)
+{
+    JsonLexeme lexeme;
+    size_t peekOffset;
+    int fieldIndex;
+
+    if ((_JsonLexer->next(string, length, offset, & lexeme) != 1) || ! __isOperator(& lexeme, JSON_OPERATOR_OBJECT_START)) {
+        return -1;
+    }
+
+    peekOffset = * offset;
+    if ((_JsonLexer->next(string, length, & peekOffset, & lexeme) == 1) && __isOperator(& lexeme, JSON_OPERATOR_OBJECT_END)) {
+        * offset = peekOffset;
+        return 0;
+    }
+
+    for (;;) {
+        if ((_JsonLexer->next(string, length, offset, & lexeme) != 1) || (lexeme.type != JSON_TOKEN_STRING)) {
+            return -1;
+        }
+        fieldIndex = __findField(this, lexeme.start + 1, lexeme.length - 2);
+
+        if ((_JsonLexer->next(string, length, offset, & lexeme) != 1) || ! __isOperator(& lexeme, JSON_OPERATOR_COLON)) {
+            return -1;
+        }
+
+        if (fieldIndex == -1) {
+            if (_JsonLexer->skipValue(string, length, offset) != 0) {
+                return -1;
+            }
+        } else if (__bindValue(this, fieldIndex, string, length, offset, target) != 0) {
+            return -1;
+        }
+
+        if (_JsonLexer->next(string, length, offset, & lexeme) != 1) {
+            return -1;
+        }
+        if (__isOperator(& lexeme, JSON_OPERATOR_OBJECT_END)) {
+            return 0;
+        }
+        if (! __isOperator(& lexeme, JSON_OPERATOR_COMMA)) {
+            return -1;
+        }
+    }
+}
+
+
+static int __bindValue(JsonBinding const * const this, unsigned int fieldIndex, char const * const string, size_t length, size_t * offset, char * target)
+{
+    JsonBindingField const * field = & this->fields[fieldIndex];
+    char * member = target + field->offset;
+    JsonLexeme lexeme;
+
+    if (field->type == JSON_BINDING_OBJECT) {
+        return __bindObject(this->nestedBindings[fieldIndex], string, length, offset, member);
+    }
+
+    if (_JsonLexer->next(string, length, offset, & lexeme) != 1) {
+        return -1;
+    }
+
+    switch (field->type) {
+        case JSON_BINDING_INTEGER:
+            if (lexeme.type != JSON_TOKEN_INTEGER) {
+                return -1;
+            }
+            return _JsonNumbers->convertIntegers(& lexeme, 1, (JsonIntegerValue *) member);
+        case JSON_BINDING_FLOAT:
+            if ((lexeme.type != JSON_TOKEN_INTEGER) && (lexeme.type != JSON_TOKEN_FLOAT)) {
+                return -1;
+            }
+            return _JsonNumbers->convertFloats(& lexeme, 1, (JsonFloatValue *) member);
+        case JSON_BINDING_BOOLEAN:
+            if (lexeme.type != JSON_TOKEN_BOOLEAN) {
+                return -1;
+            }
+            * (JsonBooleanValue *) member = (lexeme.start[0] == 't');
+            return 0;
+        case JSON_BINDING_STRING:
+            if ((lexeme.type != JSON_TOKEN_STRING) || (lexeme.length - 2 >= field->size)) {
+                return -1;
+            }
+            memcpy(member, lexeme.start + 1, lexeme.length - 2);
+            member[lexeme.length - 2] = '\0';
+            return 0;
+        default:
+            return -1;
+    }
+}
+
+
+
+
+/**
+ * Init JsonBinding methods table
+ */
+static _JsonBindingMethods methods = {
+    new,
+    delete,
+    bind
+};
+_JsonBindingMethods const * const _JsonBinding = & methods;
@@ -0,0 +1,115 @@
+#ifndef JSON_BINDING_HEADER
+#define JSON_BINDING_HEADER
+
+
+
+
+/**
+ * Types a json value may be bound to
+ */
+typedef enum
+{
+    JSON_BINDING_INTEGER,   /* a JsonIntegerValue member */
+    JSON_BINDING_FLOAT,     /* a JsonFloatValue member, json integers are accepted too */
+    JSON_BINDING_BOOLEAN,   /* a JsonBooleanValue member */
+    JSON_BINDING_STRING,    /* a char array member of the given size, filled without quotes, escapes kept */
+    JSON_BINDING_OBJECT     /* a struct member, described by nested fields */
+} JsonBindingType;
+
+
+/**
+ * Describes where a json object member is written in a C struct
+ */
+typedef struct JsonBindingField
+{
+    /**
+     * The key of the member
+     */
+    char const * name;
+
+    /**
+     * The offset of the C struct member, from offsetof
+     */
+    unsigned int offset;
+
+    /**
+     * The type of the C struct member
+     */
+    JsonBindingType type;
+
+    /**
+     * The size of the char array, NUL included, for strings only
+     */
+    unsigned int size;
+
+    /**
+     * The fields of the nested struct, for objects only
+     */
+    struct JsonBindingField const * fields;
+
+    /**
+     * The number of fields of the nested struct, for objects only
+     */
+    unsigned int fieldsCount;
+
+} JsonBindingField;
+
+
+/**
+ * A compiled set of field descriptors, matching keys with a perfect hash
+ */
+typedef struct JsonBinding JsonBinding;
+
+
+
+
+/**
+ * JsonBinding methods table
+ */
+typedef struct
+{
+    /**
+     * Constructor, compiles the descriptors once to bind many json-strings
+     * The descriptors are stored internally, they must outlive the instance
+     * 
+     * @param fields - the descriptors of the struct members, names must be unique
+     * @param fieldsCount - the number of descriptors
+     * 
+     * @return - a JsonBinding instance if the descriptors are valid and allocation succeeds, NULL otherwise
+     */
+    JsonBinding * (* new)(JsonBindingField const * fields, unsigned int fieldsCount);
+
+    /**
+     * Destructor, sets the pointer to NULL
+     * 
+     * @param this - pointer to the instance to delete
+     */
+    void (* delete)(JsonBinding ** this);
+
+    /**
+     * Writes the members of a json object straight into a struct, without creating any token
+     * Unknown keys are skipped, members missing from the json are left untouched
+     * 
+     * @param this - the binding describing the struct
+     * @param string - the json-string of an object, doesn't need to be NUL-terminated
+     * @param length - the length of the json-string
+     * @param target - the struct to write into
+     * 
+     * @return - 0 on success, -1 if the json is malformed, a value doesn't match its field or memory runs out converting a long number
+     */
+    int (* bind)(JsonBinding const * const this, char const * const string, size_t length, void * target);
+
+} _JsonBindingMethods;
+
+
+
+
+/**
+ * JsonBinding class methods table
+ */
+extern _JsonBindingMethods const * const _JsonBinding;
+
+
+
+
+#endif /* JSON_BINDING_HEADER */
@@ -0,0 +1,576 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Class.h"
+#include "Json.h"
+#include "JsonCache.h"
+
+
+
+
+/**
+ * Number of buckets of a new cache, doubled when there are more entries than buckets
+ */
+#define JSON_CACHE_FIRST_BUCKETS 16
+
+
+/**
+ * Header of the blocks of a cached json, recording their size
+ */
+typedef union
+{
+    /**
+     * The size of the block, header excluded
+     */
+    size_t size;
+
+    /**
+     * Members keeping the block after the header aligned
+     */
+    long alignLong;
+    double alignDouble;
+    void * alignPointer;
+
+} JsonCacheBlock;
+
+
+/**
+ * The allocator of a cached json, counting the bytes the json holds
+ * It outlives the cache entry as long as the json is referenced elsewhere, and is freed with the json's last block
+ */
+typedef struct
+{
+    /**
+     * The allocator given to the json, with the account as context
+     */
+    Allocator allocator;
+
+    /**
+     * The allocator the blocks are taken from
+     */
+    Allocator const * backing;
+
+    /**
+     * The number of bytes the json holds
+     */
+    size_t bytes;
+
+    /**
+     * The number of blocks the json holds
+     */
+    unsigned long blocksCount;
+
+    /**
+     * Whether the cache released the json, the account then being freed with its last block
+     */
+    char isDetached;
+
+} JsonCacheAccount;
+
+
+/**
+ * A cached json
+ */
+typedef struct JsonCacheEntry
+{
+    /**
+     * The hash of the json-string
+     */
+    unsigned long hash;
+
+    /**
+     * The length of the json-string
+     */
+    size_t length;
+
+    /**
+     * The reference held by the cache
+     */
+    Json * json;
+
+    /**
+     * The account of the bytes the json holds
+     */
+    JsonCacheAccount * account;
+
+    /**
+     * The number of bytes the json held once cached
+     */
+    size_t bytes;
+
+    /**
+     * The next entry in the same bucket
+     */
+    struct JsonCacheEntry * nextInBucket;
+
+    /**
+     * The entry used just before this one
+     */
+    struct JsonCacheEntry * moreRecent;
+
+    /**
+     * The entry used just after this one
+     */
+    struct JsonCacheEntry * lessRecent;
+
+} JsonCacheEntry;
+
+
+struct JsonCache
+{
+    /**
+     * The maximum size of the cached jsons
+     */
+    size_t maxBytes;
+
+    /**
+     * The allocator the jsons are allocated with, current when the cache was created
+     */
+    Allocator const * allocator;
+
+    /**
+     * The entries, by hash
+     */
+    JsonCacheEntry ** buckets;
+
+    /**
+     * The number of buckets, a power of 2
+     */
+    unsigned int bucketsCount;
+
+    /**
+     * The most recently used entry
+     */
+    JsonCacheEntry * mostRecent;
+
+    /**
+     * The least recently used entry, evicted first
+     */
+    JsonCacheEntry * leastRecent;
+
+    /**
+     * The counters
+     */
+    JsonCacheStats stats;
+};
+
+
+
+
+/**
+ * Creates the account of a json to be cached
+ * 
+ * @param this - the cache the json is parsed for
+ * 
+ * @return - the account, NULL if allocation fails
+ */
+static JsonCacheAccount * __newAccount(JsonCache const * const this);
+
+
+/**
+ * Allocates a block of a cached json, @see Allocator.allocate
+ */
+static void * __allocate(void * context, size_t size);
+
+
+/**
+ * Resizes a block of a cached json, @see Allocator.reallocate
+ */
+static void * __reallocate(void * context, void * block, size_t oldSize, size_t newSize);
+
+
+/**
+ * Releases a block of a cached json, and the account with the last block of a released json, @see Allocator.deallocate
+ */
+static void __deallocate(void * context, void * block);
+
+
+/**
+ * Hashes a json-string
+ * 
+ * @param string - the json-string to hash
+ * @param length - where to store the length of the json-string
+ * 
+ * @return - the hash of the json-string
+ */
+static unsigned long __hash(char const * const string, size_t * length);
+
+
+/**
+ * Finds the entry of a json-string, verifying its content
+ * 
+ * @param this - the cache to look into
+ * @param string - the json-string to find
+ * @param hash - the hash of the json-string
+ * @param length - the length of the json-string
+ * 
+ * @return - the entry, NULL if the json-string isn't cached
+ */
+static JsonCacheEntry * __find(JsonCache const * const this, char const * const string, unsigned long hash, size_t length);
+
+
+/**
+ * Adds an entry, evicting the least recently used ones if needed
+ * 
+ * @param this - the cache to add to
+ * @param entry - the entry to add
+ */
+static void __insert(JsonCache * const this, JsonCacheEntry * entry);
+
+
+/**
+ * Removes the least recently used entry, and releases its json
+ * 
+ * @param this - the cache to evict from
+ */
+static void __evict(JsonCache * const this);
+
+
+/**
+ * Removes an entry from the recently used ones
+ * 
+ * @param this - the cache the entry belongs to
+ * @param entry - the entry to remove
+ */
+static void __unlinkRecent(JsonCache * const this, JsonCacheEntry * entry);
+
+
+/**
+ * Makes an entry the most recently used
+ * 
+ * @param this - the cache the entry belongs to
+ * @param entry - the entry which was used
+ */
+static void __linkRecent(JsonCache * const this, JsonCacheEntry * entry);
+
+
+/**
+ * Doubles the number of buckets
+ * 
+ * @param this - the cache to grow
+ */
+static void __grow(JsonCache * const this);
+
+
+
+
+static JsonCache * new(size_t maxBytes)
+{
+    JsonCache * this;
+
+    this = Class->new("JsonCache", sizeof(* this));
+
+    if (this != NULL) {
+        this->maxBytes = maxBytes;
+        this->allocator = Class->getAllocator();
+        this->bucketsCount = JSON_CACHE_FIRST_BUCKETS;
+        this->buckets = Class->new("JsonCacheEntry[]", sizeof(JsonCacheEntry *) * this->bucketsCount);
+        if (this->buckets == NULL) {
+            _JsonCache->delete(& this);
+            return NULL;
+        }
+    }
+
+    return this;
+}
+
+
+static void delete(JsonCache ** this)
+{
+    if ((this == NULL) || (* this == NULL)) {
+        return;
+    }
+
+    while ((* this)->leastRecent != NULL) {
+        __evict(* this);
+    }
+
+    Class->delete((void **) & (* this)->buckets);
+    Class->delete((void **) this);
+}
+
+
+static Json * get(JsonCache * const this, char const * const jsonString)
+{
+    JsonCacheEntry * entry;
+    unsigned long hash;
+    size_t length;
+    Json * json;
+
+    hash = __hash(jsonString, & length);
+
+    entry = __find(this, jsonString, hash, length);
+    if (entry != NULL) {
+        this->stats.hits++;
+        __unlinkRecent(this, entry);
+        __linkRecent(this, entry);
+        return _Json->retain(entry->json);
+    }
+
+    this->stats.misses++;
+
+    /* a json always holds more than its json-string */
+    if (length > this->maxBytes) {
+        json = _Json->new(jsonString);
+        if (json != NULL) {
+            _Json->freeze(json);
+        }
+        return json;
+    }
+
+    entry = Class->new("JsonCacheEntry", sizeof(* entry));
+    if ((entry == NULL) || ((entry->account = __newAccount(this)) == NULL)) {
+        Class->delete((void **) & entry);
+        return NULL;
+    }
+
+    json = _Json->newWithAllocator(jsonString, & entry->account->allocator);
+    if (json == NULL) {
+        Class->deleteWithAllocator(this->allocator, (void **) & entry->account);
+        Class->delete((void **) & entry);
+        return NULL;
+    }
+
+    /* cached jsons are shared, they're frozen before the first reference is handed out */
+    _Json->freeze(json);
+
+    /* jsons too large to be cached keep the account until they're deleted */
+    if (entry->account->bytes > this->maxBytes) {
+        entry->account->isDetached = 1;
+        Class->delete((void **) & entry);
+        return json;
+    }
+
+    entry->hash = hash;
+    entry->length = length;
+    entry->bytes = entry->account->bytes;
+    entry->json = _Json->retain(json);
+    __insert(this, entry);
+
+    return json;
+}
+
+
+static JsonCacheStats const * getStats(JsonCache const * const this)
+{
+    return & this->stats;
+}
+
+
+
+
+static JsonCacheAccount * __newAccount(JsonCache const * const this)
+{
+    JsonCacheAccount * account;
+
+    account = Class->newWithAllocator(this->allocator, "JsonCacheAccount", sizeof(* account));
+
+    if (account != NULL) {
+        account->allocator.allocate = __allocate;
+        account->allocator.reallocate = __reallocate;
+        account->allocator.deallocate = __deallocate;
+        account->allocator.context = account;
+        account->backing = this->allocator;
+    }
+
+    return account;
+}
+
+
+static void * __allocate(void * context, size_t size)
+{
+    JsonCacheAccount * account = context;
+    JsonCacheBlock * block;
+
+    block = account->backing->allocate(account->backing->context, sizeof(* block) + size);
+    if (block == NULL) {
+        return NULL;
+    }
+
+    block->size = size;
+    account->bytes += sizeof(* block) + size;
+    account->blocksCount++;
+
+    return block + 1;
+}
+
+
+static void * __reallocate(void * context, void * block, size_t oldSize, size_t newSize)
+{
+    JsonCacheAccount * account = context;
+    JsonCacheBlock * header = (JsonCacheBlock *) block - 1;
+
+    header = account->backing->reallocate(account->backing->context, header, sizeof(* header) + oldSize, sizeof(* header) + newSize);
+    if (header == NULL) {
+        return NULL;
+    }
+
+    header->size = newSize;
+    account->bytes = account->bytes - oldSize + newSize;
+
+    return header + 1;
+}
+
+
+static void __deallocate(void * context, void * block)
+{
+    JsonCacheAccount * account = context;
+    JsonCacheBlock * header = (JsonCacheBlock *) block - 1;
+
+    account->bytes -= sizeof(* header) + header->size;
+    account->blocksCount--;
+    account->backing->deallocate(account->backing->context, header);
+
+    if (account->isDetached && (account->blocksCount == 0)) {
+        Class->deleteWithAllocator(account->backing, (void **) & account);
+    }
+}
+
+
+static unsigned long __hash(char const * const string, size_t * length)
+{
+    size_t index;
+    unsigned long hash = 2166136261UL;
+
+    for (index = 0; string[index] != '\0'; index++) {
+        hash ^= (unsigned char) string[index];
+        hash = (hash * 16777619UL) & 0xFFFFFFFFUL;
+    }
+    * length = index;
+
+    return hash;
+}
+
+
+static JsonCacheEntry * __find(JsonCache const * const this, char const * const string, unsigned long hash, size_t length)
+{
+    JsonCacheEntry * entry = this->buckets[hash & (this->bucketsCount - 1)];
+
+    for (; entry != NULL; entry = entry->nextInBucket) {
+        if ((entry->hash == hash) && (entry->length == length) && (memcmp(_Json->toString(entry->json), string, length) == 0)) {
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
+
+static void __insert(JsonCache * const this, JsonCacheEntry * entry)
+{
+    unsigned int bucketIndex;
+
+    while ((this->leastRecent != NULL) && (this->stats.bytes + entry->bytes > this->maxBytes)) {
+        __evict(this);
+    }
+
+    if (this->stats.entries >= this->bucketsCount) {
+        __grow(this);
+    }
+
+    bucketIndex = entry->hash & (this->bucketsCount - 1);
+    entry->nextInBucket = this->buckets[bucketIndex];
+    this->buckets[bucketIndex] = entry;
+    __linkRecent(this, entry);
+
+    this->stats.entries++;
+    this->stats.bytes += entry->bytes;
+}
+
+
+static void __evict(JsonCache * const this)
+{
+    JsonCacheEntry * entry = this->leastRecent;
+    JsonCacheEntry ** bucket = & this->buckets[entry->hash & (this->bucketsCount - 1)];
+
+    while (* bucket != entry) {
+        bucket = & (* bucket)->nextInBucket;
+    }
+    * bucket = entry->nextInBucket;
+    __unlinkRecent(this, entry);
+
+    this->stats.evictions++;
+    this->stats.entries--;
+    this->stats.bytes -= entry->bytes;
+
+    /* the account is freed along with the json, now or once its other holders release it */
+    entry->account->isDetached = 1;
+    _Json->delete(& entry->json);
+    Class->delete((void **) & entry);
+}
+
+
+static void __unlinkRecent(JsonCache * const this, JsonCacheEntry * entry)
+{
+    if (entry->moreRecent != NULL) {
+        entry->moreRecent->lessRecent = entry->lessRecent;
+    } else {
+        this->mostRecent = entry->lessRecent;
+    }
+
+    if (entry->lessRecent != NULL) {
+        entry->lessRecent->moreRecent = entry->moreRecent;
+    } else {
+        this->leastRecent = entry->moreRecent;
+    }
+
+    entry->moreRecent = NULL;
+    entry->lessRecent = NULL;
+}
+
+
+static void __linkRecent(JsonCache * const this, JsonCacheEntry * entry)
+{
+    entry->lessRecent = this->mostRecent;
+    if (this->mostRecent != NULL) {
+        this->mostRecent->moreRecent = entry;
+    }
+    this->mostRecent = entry;
+
+    if (this->leastRecent == NULL) {
+        this->leastRecent = entry;
+    }
+}
+
+
+static void __grow(JsonCache * const this)
+{
+    JsonCacheEntry ** buckets;
+    JsonCacheEntry * entry;
+    JsonCacheEntry * nextEntry;
+    unsigned int bucketsCount = this->bucketsCount * 2;
+    unsigned int bucketIndex;
+
+    buckets = Class->new("JsonCacheEntry[]", sizeof(JsonCacheEntry *) * bucketsCount);
+    if (buckets == NULL) {
+        /* keep the current buckets, lookups just get longer */
+        return;
+    }
+
+    for (bucketIndex = 0; bucketIndex < this->bucketsCount; bucketIndex++) {
+        for (entry = this->buckets[bucketIndex]; entry != NULL; entry = nextEntry) {
+            nextEntry = entry->nextInBucket;
+            entry->nextInBucket = buckets[entry->hash & (bucketsCount - 1)];
+            buckets[entry->hash & (bucketsCount - 1)] = entry;
+        }
+    }
+
+    Class->delete((void **) & this->buckets);
+    this->buckets = buckets;
+    this->bucketsCount = bucketsCount;
+}
+
+
+
+
+/**
+ * Init JsonCache methods table
+ */
+static _JsonCacheMethods methods = {
+    new,
+    delete,
+    get,
+    getStats
+};
+_JsonCacheMethods const * const _JsonCache = & methods;
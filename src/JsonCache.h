@@ -0,0 +1,107 @@
+#ifndef JSON_CACHE_HEADER
+#define JSON_CACHE_HEADER
+
+#include "Json.h"
+
+
+
+
+/**
+ * A cache of parsed jsons, keyed by the content of their json-string
+ */
+typedef struct JsonCache JsonCache;
+
+
+/**
+ * Counters of a cache
+ */
+typedef struct
+{
+    /**
+     * Number of requests answered from the cache
+     */
+    unsigned long hits;
+
+    /**
+     * Number of requests which needed parsing
+     */
+    unsigned long misses;
+
+    /**
+     * Number of jsons evicted to stay within the budget
+     */
+    unsigned long evictions;
+
+    /**
+     * Number of jsons currently cached
+     */
+    unsigned long entries;
+
+    /**
+     * Memory held by the jsons currently cached, in bytes, as counted by their allocator
+     */
+    size_t bytes;
+
+} JsonCacheStats;
+
+
+
+
+/**
+ * JsonCache methods table
+ */
+typedef struct
+{
+    /**
+     * Constructor
+     * 
+     * Jsons are allocated with the allocator current at creation, through an allocator counting the bytes each one holds
+     * 
+     * @param maxBytes - the maximum memory held by the cached jsons, least recently used ones are evicted beyond
+     * 
+     * @return - a JsonCache instance if allocation succeeds, NULL otherwise
+     */
+    JsonCache * (* new)(size_t maxBytes);
+
+    /**
+     * Destructor, releases the cached jsons and sets the pointer to NULL
+     * Jsons still referenced elsewhere stay valid
+     * 
+     * @param this - pointer to the instance to delete
+     */
+    void (* delete)(JsonCache ** this);
+
+    /**
+     * Returns the json parsed from a json-string, parsing it only if no identical json-string is cached
+     * The json is shared and frozen, it must be released with _Json->delete
+     * 
+     * @param this - the cache to look into
+     * @param jsonString - the json-string to parse
+     * 
+     * @return - a reference to the parsed json, NULL if parsing or allocation fails
+     */
+    Json * (* get)(JsonCache * const this, char const * const jsonString);
+
+    /**
+     * Returns the counters of the cache
+     * 
+     * @param this - the cache to get the counters of
+     * 
+     * @return - the counters
+     */
+    JsonCacheStats const * (* getStats)(JsonCache const * const this);
+
+} _JsonCacheMethods;
+
+
+
+
+/**
+ * JsonCache class methods table
+ */
+extern _JsonCacheMethods const * const _JsonCache;
+
+
+
+
+#endif /* JSON_CACHE_HEADER */
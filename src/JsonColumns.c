@@ -0,0 +1,539 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Class.h"
+#include "JsonToken.h"
+#include "JsonLexer.h"
+#include "JsonNumbers.h"
+#include "JsonGrammar.h"
+#include "JsonColumns.h"
+
+
+
+
+/**
+ * Number of rows there is room for at first
+ */
+#define JSON_COLUMNS_INITIAL_ROWS 64
+
+
+struct JsonColumns
+{
+    /**
+     * The extracted columns
+     */
+    JsonColumn * columns;
+
+    /**
+     * The json pointer of each column
+     */
+    char ** paths;
+
+    /**
+     * The number of keys of the json pointer of each column
+     */
+    unsigned int * depths;
+
+    /**
+     * The number of characters the heap of each column can hold
+     */
+    unsigned int * heapCapacities;
+
+    /**
+     * The number of columns
+     */
+    unsigned int columnsCount;
+
+    /**
+     * The number of rows
+     */
+    unsigned int rowsCount;
+
+    /**
+     * The number of rows there is room for
+     */
+    unsigned int rowsCapacity;
+};
+
+
+
+
+/**
+ * Reads a record into a new row
+ *
+ * @param this - the columns to append to
+ * @param string - the record
+ * @param length - the length of the record
+ * @param error - where to store why the record is rejected
+ *
+ * @return - 0 on success, -1 if the record is rejected or allocation fails
+ */
+static int __appendRecord(JsonColumns * const this, char const * const string, size_t length, JsonError * error);
+
+
+/**
+ * Stores a value in the columns whose json pointer leads to it
+ *
+ * @param this - the columns
+ * @param keys - the key of the member holding the value, at each depth
+ * @param depth - the number of keys
+ * @param lexeme - the value
+ *
+ * @return - 0 on success, -1 on allocation failure
+ */
+static int __store(JsonColumns * const this, JsonLexeme const * keys, unsigned int depth, JsonLexeme const * lexeme);
+
+
+/**
+ * Stores a value in a column, unless the column already has a value for the row or the value doesn't have the column type
+ *
+ * @param this - the columns
+ * @param column - the column
+ * @param lexeme - the value
+ *
+ * @return - 0 on success, -1 on allocation failure
+ */
+static int __storeValue(JsonColumns * const this, unsigned int column, JsonLexeme const * lexeme);
+
+
+/**
+ * Checks if the keys leading to a value are the ones of a json pointer
+ *
+ * @param path - the json pointer
+ * @param keys - the key of the member holding the value, at each depth
+ * @param depth - the number of keys
+ *
+ * @return - 1 if the json pointer leads to the value, 0 otherwise
+ */
+static int __pathIs(char const * const path, JsonLexeme const * keys, unsigned int depth);
+
+
+/**
+ * Makes room for the given number of rows in every column
+ *
+ * @param this - the columns
+ * @param count - the number of rows needed
+ *
+ * @return - 0 on success, -1 on allocation failure
+ */
+static int __reserveRows(JsonColumns * const this, unsigned int count);
+
+
+/**
+ * Resizes a buffer, allocating it if needed
+ *
+ * @param buffer - pointer to the buffer
+ * @param oldSize - the current size of the buffer, 0 if it isn't allocated yet
+ * @param newSize - the requested size of the buffer
+ *
+ * @return - 0 on success, -1 on allocation failure
+ */
+static int __resize(void ** buffer, unsigned int oldSize, unsigned int newSize);
+
+
+/**
+ * Returns the size of a value of a column
+ *
+ * @param type - the type of the column
+ *
+ * @return - the size of a value, 0 for strings
+ */
+static unsigned int __valueSize(JsonColumnType type);
+
+
+
+
+static JsonColumns * new(JsonColumnSpec const * specs, unsigned int columnsCount)
+{
+    JsonColumns * this;
+    unsigned int column;
+    char const * character;
+
+    this = Class->new("JsonColumns", sizeof(* this));
+    if (this == NULL) {
+        return NULL;
+    }
+
+    this->columns = Class->new("JsonColumn[]", columnsCount * sizeof(JsonColumn) + 1);
+    this->paths = Class->new("char *[]", columnsCount * sizeof(char *) + 1);
+    this->depths = Class->new("unsigned int[]", columnsCount * sizeof(unsigned int) + 1);
+    this->heapCapacities = Class->new("unsigned int[]", columnsCount * sizeof(unsigned int) + 1);
+    if ((this->columns == NULL) || (this->paths == NULL) || (this->depths == NULL) || (this->heapCapacities == NULL)) {
+        _JsonColumns->delete(& this);
+        return NULL;
+    }
+    this->columnsCount = columnsCount;
+
+    for (column = 0; column < columnsCount; column++) {
+        this->columns[column].type = specs[column].type;
+
+        this->paths[column] = Class->new("JsonString", strlen(specs[column].path) + 1);
+        if (this->paths[column] == NULL) {
+            _JsonColumns->delete(& this);
+            return NULL;
+        }
+        strcpy(this->paths[column], specs[column].path);
+
+        for (character = specs[column].path; * character != '\0'; character++) {
+            this->depths[column] += (* character == '/');
+        }
+    }
+
+    if (__reserveRows(this, JSON_COLUMNS_INITIAL_ROWS) != 0) {
+        _JsonColumns->delete(& this);
+        return NULL;
+    }
+
+    return this;
+}
+
+
+static void delete(JsonColumns ** this)
+{
+    unsigned int column;
+
+    if (* this == NULL) {
+        return;
+    }
+
+    for (column = 0; (* this)->columns != NULL && column < (* this)->columnsCount; column++) {
+        Class->delete((void **) & (* this)->columns[column].values);
+        Class->delete((void **) & (* this)->columns[column].offsets);
+        Class->delete((void **) & (* this)->columns[column].heap);
+        Class->delete((void **) & (* this)->columns[column].validity);
+        Class->delete((void **) & (* this)->paths[column]);
+    }
+
+    Class->delete((void **) & (* this)->columns);
+    Class->delete((void **) & (* this)->paths);
+    Class->delete((void **) & (* this)->depths);
+    Class->delete((void **) & (* this)->heapCapacities);
+    Class->delete((void **) this);
+}
+
+
+static int append(JsonColumns * const this, char const * const string, size_t length, JsonError * error)
+{
+    char const * lineEnd;
+    size_t start = 0;
+    size_t end;
+    unsigned int rowsCount = this->rowsCount;
+    JsonError recordError;
+
+    while (start < length) {
+        lineEnd = memchr(string + start, '\n', length - start);
+        end = (lineEnd != NULL) ? (size_t) (lineEnd - string) : length;
+
+        if (__appendRecord(this, string + start, end - start, & recordError) != 0) {
+            if (recordError.code != JSON_ERROR_NONE) {
+                recordError.offset += start;
+            }
+            if (error != NULL) {
+                * error = recordError;
+            }
+            return -1;
+        }
+
+        start = end + 1;
+    }
+
+    return this->rowsCount - rowsCount;
+}
+
+
+static void clear(JsonColumns * const this)
+{
+    unsigned int column;
+
+    this->rowsCount = 0;
+    for (column = 0; column < this->columnsCount; column++) {
+        if (this->columns[column].type == JSON_COLUMN_STRING) {
+            this->columns[column].offsets[0] = 0;
+        }
+    }
+}
+
+
+static unsigned int getRowsCount(JsonColumns const * const this)
+{
+    return this->rowsCount;
+}
+
+
+static JsonColumn const * getColumn(JsonColumns const * const this, unsigned int index)
+{
+    if (index >= this->columnsCount) {
+        return NULL;
+    }
+
+    return & this->columns[index];
+}
+
+
+
+
+static int __appendRecord(JsonColumns * const this, char const * const string, size_t length, JsonError * error)
+{
+    JsonLexeme keys[JSON_GRAMMAR_MAX_DEPTH];
+    JsonGrammar grammar;
+    JsonLexeme lexeme;
+    JsonColumn * column;
+    size_t offset = 0;
+    unsigned int openingIndex;
+    unsigned int index;
+    int isKey;
+    int status;
+
+    error->code = JSON_ERROR_NONE;
+    error->offset = 0;
+
+    _JsonGrammar->begin(& grammar);
+    if (__reserveRows(this, this->rowsCount + 1) != 0) {
+        return -1;
+    }
+
+    for (index = 0; index < this->columnsCount; index++) {
+        column = & this->columns[index];
+        column->validity[this->rowsCount / 8] &= ~(1 << (this->rowsCount % 8));
+        if (column->type != JSON_COLUMN_STRING) {
+            memset((char *) column->values + this->rowsCount * __valueSize(column->type), 0, __valueSize(column->type));
+        }
+    }
+
+    while ((status = _JsonLexer->next(string, length, & offset, & lexeme)) == 1) {
+        isKey = (grammar.state == JSON_GRAMMAR_KEY) || (grammar.state == JSON_GRAMMAR_FIRST_KEY);
+
+        if (_JsonGrammar->feed(& grammar, lexeme.type, lexeme.start[0], lexeme.start - string, & openingIndex) == -1) {
+            break;
+        }
+
+        if (isKey) {
+            keys[grammar.depth - 1] = lexeme;
+        } else if ((lexeme.type != JSON_TOKEN_OPERATOR) && (memchr(grammar.containers, JSON_OPERATOR_ARRAY_START, grammar.depth) == NULL)
+            && (__store(this, keys, grammar.depth, & lexeme) != 0)) {
+            grammar.error.code = JSON_ERROR_ALLOCATION;
+            grammar.error.offset = lexeme.start - string;
+            break;
+        }
+    }
+
+    /* blank lines aren't records */
+    if ((status == 0) && (grammar.tokensCount == 0)) {
+        return 0;
+    }
+
+    if ((status == -1) && (grammar.error.code == JSON_ERROR_NONE)) {
+        grammar.error.code = JSON_ERROR_INVALID_TOKEN;
+        grammar.error.offset = offset;
+    }
+    _JsonGrammar->end(& grammar, offset);
+
+    if (grammar.error.code != JSON_ERROR_NONE) {
+        * error = grammar.error;
+        return -1;
+    }
+
+    this->rowsCount++;
+    for (index = 0; index < this->columnsCount; index++) {
+        column = & this->columns[index];
+        if ((column->type == JSON_COLUMN_STRING) && ! (column->validity[(this->rowsCount - 1) / 8] & (1 << ((this->rowsCount - 1) % 8)))) {
+            column->offsets[this->rowsCount] = column->offsets[this->rowsCount - 1];
+        }
+    }
+
+    return 0;
+}
+
+
+static int __store(JsonColumns * const this, JsonLexeme const * keys, unsigned int depth, JsonLexeme const * lexeme)
+{
+    unsigned int column;
+
+    for (column = 0; column < this->columnsCount; column++) {
+        if ((this->depths[column] == depth) && __pathIs(this->paths[column], keys, depth)) {
+            if (__storeValue(this, column, lexeme) != 0) {
+                return -1;
+            }
+        }
+    }
+
+    return 0;
+}
+
+
+static int __storeValue(JsonColumns * const this, unsigned int column, JsonLexeme const * lexeme)
+{
+    JsonColumn * target = & this->columns[column];
+    unsigned int row = this->rowsCount;
+    unsigned int heapLength;
+    unsigned int capacity;
+
+    if (target->validity[row / 8] & (1 << (row % 8))) {
+        return 0;
+    }
+
+    switch (target->type) {
+        case JSON_COLUMN_INTEGER:
+            if (lexeme->type != JSON_TOKEN_INTEGER) {
+                return 0;
+            }
+            if (_JsonNumbers->convertIntegers(lexeme, 1, & ((JsonIntegerValue *) target->values)[row]) != 0) {
+                return -1;
+            }
+            break;
+        case JSON_COLUMN_FLOAT:
+            if ((lexeme->type != JSON_TOKEN_INTEGER) && (lexeme->type != JSON_TOKEN_FLOAT)) {
+                return 0;
+            }
+            if (_JsonNumbers->convertFloats(lexeme, 1, & ((JsonFloatValue *) target->values)[row]) != 0) {
+                return -1;
+            }
+            break;
+        case JSON_COLUMN_BOOLEAN:
+            if (lexeme->type != JSON_TOKEN_BOOLEAN) {
+                return 0;
+            }
+            ((JsonBooleanValue *) target->values)[row] = (lexeme->start[0] == 't');
+            break;
+        case JSON_COLUMN_STRING:
+            if (lexeme->type != JSON_TOKEN_STRING) {
+                return 0;
+            }
+            heapLength = target->offsets[row];
+            capacity = this->heapCapacities[column];
+            while (capacity < heapLength + lexeme->length) {
+                capacity *= 2;
+            }
+            if ((capacity > this->heapCapacities[column]) && (__resize((void **) & target->heap, this->heapCapacities[column], capacity) != 0)) {
+                return -1;
+            }
+            this->heapCapacities[column] = capacity;
+            memcpy(target->heap + heapLength, lexeme->start + 1, lexeme->length - 2);
+            target->offsets[row + 1] = heapLength + lexeme->length - 2;
+            break;
+    }
+
+    target->validity[row / 8] |= 1 << (row % 8);
+
+    return 0;
+}
+
+
+static int __pathIs(char const * const path, JsonLexeme const * keys, unsigned int depth)
+{
+    unsigned int position = 0;
+    unsigned int keyIndex;
+    unsigned int level;
+    char character;
+
+    for (level = 0; level < depth; level++) {
+        /* skips the '/' and compares the segment with the key, without its quotes */
+        position++;
+        for (keyIndex = 1; keyIndex < keys[level].length - 1; keyIndex++, position++) {
+            character = path[position];
+            if ((character == '\0') || (character == '/')) {
+                return 0;
+            }
+            if ((character == '~') && ((path[position + 1] == '0') || (path[position + 1] == '1'))) {
+                position++;
+                character = (path[position] == '1') ? '/' : '~';
+            }
+            if (character != keys[level].start[keyIndex]) {
+                return 0;
+            }
+        }
+        if ((path[position] != '/') && (path[position] != '\0')) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+
+static int __reserveRows(JsonColumns * const this, unsigned int count)
+{
+    unsigned int capacity = (this->rowsCapacity > 0) ? this->rowsCapacity : JSON_COLUMNS_INITIAL_ROWS;
+    unsigned int column;
+    JsonColumn * target;
+
+    if (count <= this->rowsCapacity) {
+        return 0;
+    }
+
+    while (capacity < count) {
+        capacity *= 2;
+    }
+
+    for (column = 0; column < this->columnsCount; column++) {
+        target = & this->columns[column];
+
+        if (__resize((void **) & target->validity, (this->rowsCapacity + 7) / 8, (capacity + 7) / 8) != 0) {
+            return -1;
+        }
+
+        if (target->type != JSON_COLUMN_STRING) {
+            if (__resize(& target->values, this->rowsCapacity * __valueSize(target->type), capacity * __valueSize(target->type)) != 0) {
+                return -1;
+            }
+            continue;
+        }
+
+        if (__resize((void **) & target->offsets, (this->rowsCapacity + 1) * sizeof(unsigned int) * (target->offsets != NULL), (capacity + 1) * sizeof(unsigned int)) != 0) {
+            return -1;
+        }
+        if ((target->heap == NULL) && (__resize((void **) & target->heap, 0, capacity) != 0)) {
+            return -1;
+        }
+        if (this->heapCapacities[column] == 0) {
+            this->heapCapacities[column] = capacity;
+        }
+    }
+
+    this->rowsCapacity = capacity;
+
+    return 0;
+}
+
+
+static int __resize(void ** buffer, unsigned int oldSize, unsigned int newSize)
+{
+    if (* buffer == NULL) {
+        * buffer = Class->new("JsonColumnBuffer", newSize);
+        return (* buffer == NULL) ? -1 : 0;
+    }
+
+    return Class->resize(buffer, oldSize, newSize);
+}
+
+
+static unsigned int __valueSize(JsonColumnType type)
+{
+    switch (type) {
+        case JSON_COLUMN_INTEGER:
+            return sizeof(JsonIntegerValue);
+        case JSON_COLUMN_FLOAT:
+            return sizeof(JsonFloatValue);
+        case JSON_COLUMN_BOOLEAN:
+            return sizeof(JsonBooleanValue);
+        default:
+            return 0;
+    }
+}
+
+
+
+
+/**
+ * Init JsonColumns methods table
+ */
+static _JsonColumnsMethods methods = {
+    new,
+    delete,
+    append,
+    clear,
+    getRowsCount,
+    getColumn
+};
+_JsonColumnsMethods const * const _JsonColumns = & methods;
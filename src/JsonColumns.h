@@ -0,0 +1,156 @@
+#ifndef JSON_COLUMNS_HEADER
+#define JSON_COLUMNS_HEADER
+
+#include "JsonToken.h"
+#include "JsonGrammar.h"
+
+
+
+
+/**
+ * Types a column may extract
+ */
+typedef enum
+{
+    JSON_COLUMN_INTEGER,
+    JSON_COLUMN_FLOAT,
+    JSON_COLUMN_BOOLEAN,
+    JSON_COLUMN_STRING
+} JsonColumnType;
+
+
+/**
+ * What a column extracts from each record
+ */
+typedef struct
+{
+    /**
+     * The json pointer to the value through object members ("/user/age"), "" being the whole record
+     */
+    char const * path;
+
+    /**
+     * The type of the values, a float column takes integers too
+     */
+    JsonColumnType type;
+
+} JsonColumnSpec;
+
+
+/**
+ * The values of a column, one per row, stored contiguously
+ */
+typedef struct
+{
+    /**
+     * The type of the values
+     */
+    JsonColumnType type;
+
+    /**
+     * The value of each row: JsonIntegerValue, JsonFloatValue or JsonBooleanValue as per the type, 0 for missing values, unused for strings
+     */
+    void * values;
+
+    /**
+     * For strings, the offset of the string of each row in the heap, followed by the length of the heap
+     */
+    unsigned int * offsets;
+
+    /**
+     * For strings, the strings of every row one after the other, without quotes and with their escapes kept
+     */
+    char * heap;
+
+    /**
+     * A bit per row (bit row % 8 of byte row / 8), set if the record has a value of the column type
+     */
+    unsigned char * validity;
+
+} JsonColumn;
+
+
+/**
+ * Columns extracted from newline-delimited json records
+ */
+typedef struct JsonColumns JsonColumns;
+
+
+
+
+/**
+ * JsonColumns methods table
+ * Records are read straight into the columns, without creating any token; buffers only grow once they are full
+ */
+typedef struct
+{
+    /**
+     * Constructor
+     *
+     * @param specs - what each column extracts
+     * @param columnsCount - the number of columns
+     *
+     * @return - a JsonColumns instance if allocation succeeds, NULL otherwise
+     */
+    JsonColumns * (* new)(JsonColumnSpec const * specs, unsigned int columnsCount);
+
+    /**
+     * Destructor
+     *
+     * @param this - pointer to the instance to delete
+     */
+    void (* delete)(JsonColumns ** this);
+
+    /**
+     * Appends a row to the columns for each record of a newline-delimited json-string, blank lines being skipped
+     * Separate ranges of records may be extracted into separate columns
+     *
+     * @param this - the columns to append to
+     * @param string - the records, each on its own line
+     * @param length - the length of the string
+     * @param error - where to store why a record is rejected, its offset counted from the start of the string, NULL to ignore it
+     *
+     * @return - the number of rows appended, -1 if a record is rejected or allocation fails (the rows before it are kept)
+     */
+    int (* append)(JsonColumns * const this, char const * const string, size_t length, JsonError * error);
+
+    /**
+     * Removes every row, keeping the buffers for the next records
+     *
+     * @param this - the columns to clear
+     */
+    void (* clear)(JsonColumns * const this);
+
+    /**
+     * Returns the number of rows
+     *
+     * @param this - the columns
+     *
+     * @return - the number of rows
+     */
+    unsigned int (* getRowsCount)(JsonColumns const * const this);
+
+    /**
+     * Returns a column, whose buffers are valid until the next append
+     *
+     * @param this - the columns
+     * @param index - the index of the column, in the order of the specs
+     *
+     * @return - the column, NULL if the index is out of range
+     */
+    JsonColumn const * (* getColumn)(JsonColumns const * const this, unsigned int index);
+
+} _JsonColumnsMethods;
+
+
+
+
+/**
+ * JsonColumns class methods table
+ */
+extern _JsonColumnsMethods const * const _JsonColumns;
+
+
+
+
+#endif /* JSON_COLUMNS_HEADER */
@@ -0,0 +1,252 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "JsonToken.h"
+#include "JsonLexer.h"
+#include "JsonGrammar.h"
+
+
+
+
+/**
+ * Accepts a value token, or opens a container
+ *
+ * @param this - the grammar, expecting a value
+ * @param type - the type of the token
+ * @param operator - the operator of the token, ignored for other types
+ * @param offset - the offset of the token in the json-string
+ *
+ * @return - 0 if the token is accepted, -1 otherwise
+ */
+static int __feedValue(JsonGrammar * this, JsonTokenType type, JsonOperatorValue operator, size_t offset);
+
+
+/**
+ * Closes the innermost container
+ *
+ * @param this - the grammar
+ * @param operator - the closing operator
+ * @param offset - the offset of the token in the json-string
+ * @param openingIndex - where to store the index of the opening token
+ *
+ * @return - 1 if the operator matches the container, -1 otherwise
+ */
+static int __close(JsonGrammar * this, JsonOperatorValue operator, size_t offset, unsigned int * openingIndex);
+
+
+/**
+ * Moves past a complete value, to the end of the json or to the separator expected after it
+ *
+ * @param this - the grammar
+ */
+static void __completeValue(JsonGrammar * this);
+
+
+/**
+ * Rejects the sequence of tokens
+ *
+ * @param this - the grammar
+ * @param code - the reason of the rejection
+ * @param offset - the offset of the rejected character in the json-string
+ *
+ * @return - always -1
+ */
+static int __reject(JsonGrammar * this, JsonErrorCode code, size_t offset);
+
+
+
+
+static void begin(JsonGrammar * this)
+{
+    this->state = JSON_GRAMMAR_VALUE;
+    this->depth = 0;
+    this->tokensCount = 0;
+    this->error.code = JSON_ERROR_NONE;
+    this->error.offset = 0;
+}
+
+
+static int feed(JsonGrammar * this, JsonTokenType type, JsonOperatorValue operator, size_t offset, unsigned int * openingIndex)
+{
+    int status = -1;
+
+    if (this->error.code != JSON_ERROR_NONE) {
+        return -1;
+    }
+
+    if (type != JSON_TOKEN_OPERATOR) {
+        operator = '\0';
+    }
+
+    switch (this->state) {
+        case JSON_GRAMMAR_FIRST_VALUE:
+            if (operator == JSON_OPERATOR_ARRAY_END) {
+                status = __close(this, operator, offset, openingIndex);
+                break;
+            }
+            status = __feedValue(this, type, operator, offset);
+            break;
+        case JSON_GRAMMAR_VALUE:
+            status = __feedValue(this, type, operator, offset);
+            break;
+        case JSON_GRAMMAR_FIRST_KEY:
+            if (operator == JSON_OPERATOR_OBJECT_END) {
+                status = __close(this, operator, offset, openingIndex);
+                break;
+            }
+            /* falls through */
+        case JSON_GRAMMAR_KEY:
+            if (type != JSON_TOKEN_STRING) {
+                return __reject(this, JSON_ERROR_UNEXPECTED_TOKEN, offset);
+            }
+            this->state = JSON_GRAMMAR_COLON;
+            status = 0;
+            break;
+        case JSON_GRAMMAR_COLON:
+            if (operator != JSON_OPERATOR_COLON) {
+                return __reject(this, JSON_ERROR_UNEXPECTED_TOKEN, offset);
+            }
+            this->state = JSON_GRAMMAR_VALUE;
+            status = 0;
+            break;
+        case JSON_GRAMMAR_SEPARATOR:
+            if (operator == JSON_OPERATOR_COMMA) {
+                if (this->containers[this->depth - 1] == JSON_OPERATOR_OBJECT_START) {
+                    this->state = JSON_GRAMMAR_KEY;
+                } else {
+                    this->state = JSON_GRAMMAR_VALUE;
+                }
+                status = 0;
+                break;
+            }
+            status = __close(this, operator, offset, openingIndex);
+            break;
+        default:
+            return __reject(this, JSON_ERROR_UNEXPECTED_TOKEN, offset);
+    }
+
+    if (status != -1) {
+        this->tokensCount++;
+    }
+
+    return status;
+}
+
+
+static int end(JsonGrammar * this, size_t offset)
+{
+    if (this->error.code != JSON_ERROR_NONE) {
+        return -1;
+    }
+
+    if (this->state != JSON_GRAMMAR_DONE) {
+        return __reject(this, JSON_ERROR_UNEXPECTED_END, offset);
+    }
+
+    return 0;
+}
+
+
+static int validate(char const * const string, size_t length, JsonError * error)
+{
+    JsonGrammar grammar;
+    JsonLexeme lexeme;
+    size_t offset = 0;
+    unsigned int openingIndex;
+    int status;
+
+    _JsonGrammar->begin(& grammar);
+
+    while ((status = _JsonLexer->next(string, length, & offset, & lexeme)) == 1) {
+        if (_JsonGrammar->feed(& grammar, lexeme.type, lexeme.start[0], lexeme.start - string, & openingIndex) == -1) {
+            break;
+        }
+    }
+
+    if (status == -1) {
+        __reject(& grammar, JSON_ERROR_INVALID_TOKEN, offset);
+    }
+    _JsonGrammar->end(& grammar, offset);
+
+    if (error != NULL) {
+        * error = grammar.error;
+    }
+
+    return (grammar.error.code == JSON_ERROR_NONE) ? 0 : -1;
+}
+
+
+
+
+static int __feedValue(JsonGrammar * this, JsonTokenType type, JsonOperatorValue operator, size_t offset)
+{
+    if (type != JSON_TOKEN_OPERATOR) {
+        __completeValue(this);
+        return 0;
+    }
+
+    if ((operator != JSON_OPERATOR_OBJECT_START) && (operator != JSON_OPERATOR_ARRAY_START)) {
+        return __reject(this, JSON_ERROR_UNEXPECTED_TOKEN, offset);
+    }
+
+    if (this->depth == JSON_GRAMMAR_MAX_DEPTH) {
+        return __reject(this, JSON_ERROR_TOO_DEEP, offset);
+    }
+
+    this->containers[this->depth] = operator;
+    this->openings[this->depth] = this->tokensCount;
+    this->depth++;
+
+    this->state = (operator == JSON_OPERATOR_OBJECT_START) ? JSON_GRAMMAR_FIRST_KEY : JSON_GRAMMAR_FIRST_VALUE;
+
+    return 0;
+}
+
+
+static int __close(JsonGrammar * this, JsonOperatorValue operator, size_t offset, unsigned int * openingIndex)
+{
+    JsonOperatorValue expected;
+
+    expected = (this->containers[this->depth - 1] == JSON_OPERATOR_OBJECT_START) ? JSON_OPERATOR_OBJECT_END : JSON_OPERATOR_ARRAY_END;
+    if (operator != expected) {
+        return __reject(this, JSON_ERROR_UNEXPECTED_TOKEN, offset);
+    }
+
+    this->depth--;
+    * openingIndex = this->openings[this->depth];
+    __completeValue(this);
+
+    return 1;
+}
+
+
+static void __completeValue(JsonGrammar * this)
+{
+    this->state = (this->depth == 0) ? JSON_GRAMMAR_DONE : JSON_GRAMMAR_SEPARATOR;
+}
+
+
+static int __reject(JsonGrammar * this, JsonErrorCode code, size_t offset)
+{
+    if (this->error.code == JSON_ERROR_NONE) {
+        this->error.code = code;
+        this->error.offset = offset;
+    }
+
+    return -1;
+}
+
+
+
+
+/**
+ * Init JsonGrammar methods table
+ */
+static _JsonGrammarMethods methods = {
+    begin,
+    feed,
+    end,
+    validate
+};
+_JsonGrammarMethods const * const _JsonGrammar = & methods;
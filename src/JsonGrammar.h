@@ -0,0 +1,163 @@
+#ifndef JSON_GRAMMAR_HEADER
+#define JSON_GRAMMAR_HEADER
+
+#include "JsonToken.h"
+
+
+
+
+/**
+ * Deepest nesting of objects and arrays accepted
+ */
+#define JSON_GRAMMAR_MAX_DEPTH 256
+
+
+/**
+ * Reasons for rejecting a json-string
+ */
+typedef enum
+{
+    JSON_ERROR_NONE,
+    JSON_ERROR_INVALID_TOKEN,
+    JSON_ERROR_UNEXPECTED_TOKEN,
+    JSON_ERROR_UNEXPECTED_END,
+    JSON_ERROR_TOO_DEEP,
+    JSON_ERROR_ALLOCATION,
+    JSON_ERROR_READ
+} JsonErrorCode;
+
+
+/**
+ * Why and where a json-string was rejected
+ */
+typedef struct
+{
+    /**
+     * The reason of the rejection
+     */
+    JsonErrorCode code;
+
+    /**
+     * The offset of the rejected character in the json-string
+     */
+    size_t offset;
+
+} JsonError;
+
+
+/**
+ * What the grammar expects next
+ */
+typedef enum
+{
+    JSON_GRAMMAR_VALUE,
+    JSON_GRAMMAR_FIRST_VALUE,
+    JSON_GRAMMAR_KEY,
+    JSON_GRAMMAR_FIRST_KEY,
+    JSON_GRAMMAR_COLON,
+    JSON_GRAMMAR_SEPARATOR,
+    JSON_GRAMMAR_DONE
+} JsonGrammarState;
+
+
+/**
+ * State of the validation of a sequence of tokens
+ */
+typedef struct
+{
+    /**
+     * What the next token may be
+     */
+    JsonGrammarState state;
+
+    /**
+     * Number of objects and arrays opened and not closed yet
+     */
+    unsigned int depth;
+
+    /**
+     * Opening operator of each open container, from the outermost one
+     */
+    JsonOperatorValue containers[JSON_GRAMMAR_MAX_DEPTH];
+
+    /**
+     * Index of the opening token of each open container
+     */
+    unsigned int openings[JSON_GRAMMAR_MAX_DEPTH];
+
+    /**
+     * Number of tokens accepted so far
+     */
+    unsigned int tokensCount;
+
+    /**
+     * Why the sequence was rejected, JSON_ERROR_NONE while it's valid
+     */
+    JsonError error;
+
+} JsonGrammar;
+
+
+
+
+/**
+ * JsonGrammar methods table
+ * The grammar allocates nothing, it's fed tokens one at a time while they are read
+ */
+typedef struct
+{
+    /**
+     * Resets the grammar to expect a whole json value
+     *
+     * @param this - the grammar to reset
+     */
+    void (* begin)(JsonGrammar * this);
+
+    /**
+     * Checks the next token against the grammar
+     *
+     * @param this - the grammar
+     * @param type - the type of the token
+     * @param operator - the operator of the token, ignored for other types
+     * @param offset - the offset of the token in the json-string, to report errors at
+     * @param openingIndex - where to store the index of the opening token, when the token closes a container
+     *
+     * @return - 1 if the token closes a container, 0 if it's otherwise accepted, -1 if it's rejected
+     */
+    int (* feed)(JsonGrammar * this, JsonTokenType type, JsonOperatorValue operator, size_t offset, unsigned int * openingIndex);
+
+    /**
+     * Checks that the tokens fed form a whole json value
+     *
+     * @param this - the grammar
+     * @param offset - the offset of the end of the json-string, to report errors at
+     *
+     * @return - 0 if the value is complete, -1 otherwise
+     */
+    int (* end)(JsonGrammar * this, size_t offset);
+
+    /**
+     * Validates a json-string without creating any token
+     *
+     * @param string - the json-string to validate
+     * @param length - the length of the json-string
+     * @param error - where to store why the json-string is rejected, NULL to ignore it
+     *
+     * @return - 0 if the json-string is valid, -1 otherwise
+     */
+    int (* validate)(char const * const string, size_t length, JsonError * error);
+
+} _JsonGrammarMethods;
+
+
+
+
+/**
+ * JsonGrammar class methods table
+ */
+extern _JsonGrammarMethods const * const _JsonGrammar;
+
+
+
+
+#endif /* JSON_GRAMMAR_HEADER */
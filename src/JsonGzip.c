@@ -0,0 +1,248 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef JSON_ZLIB
+#include <zlib.h>
+#endif
+
+#include "Class.h"
+#include "JsonGrammar.h"
+#include "JsonSax.h"
+#include "JsonGzip.h"
+
+
+
+
+/**
+ * Number of compressed characters read at once from the file
+ */
+#define JSON_GZIP_INPUT_SIZE 65536
+
+
+/**
+ * Number of buffers of decompressed characters the reader thread fills ahead
+ */
+#define JSON_GZIP_RING_SIZE 4
+
+
+/**
+ * Number of decompressed characters in each buffer of the ring
+ */
+#define JSON_GZIP_CHUNK_SIZE 65536
+
+
+/**
+ * Window bits letting zlib detect a gzip or a zlib header
+ */
+#define JSON_GZIP_WINDOW_BITS (15 + 32)
+
+
+
+
+#ifdef JSON_ZLIB
+struct JsonGzip
+{
+    /**
+     * The compressed file
+     */
+    FILE * file;
+
+    /**
+     * The state of the decompression
+     */
+    z_stream stream;
+
+    /**
+     * The compressed characters read from the file and not decompressed yet
+     */
+    unsigned char * input;
+
+    /**
+     * Whether the last member read is complete, so that the end of the file ends the json-string
+     */
+    int isEnded;
+};
+#endif
+
+
+
+
+/**
+ * Reads the next decompressed characters of a JsonGzip instance, as a JsonSaxSource
+ *
+ * @param context - the JsonGzip instance
+ * @param window - where to write the characters
+ * @param capacity - the most characters the window can take
+ *
+ * @return - the number of characters written, 0 at the end of the last member, -1 if the stream is corrupted or truncated
+ */
+static int __read(void * context, char * window, unsigned int capacity);
+
+
+/**
+ * Stores why a file couldn't be read
+ *
+ * @param error - where to store the error, NULL to ignore it
+ * @param code - the reason of the rejection
+ *
+ * @return - -1
+ */
+static int __fail(JsonError * error, JsonErrorCode code);
+
+
+
+
+static JsonGzip * new(FILE * file)
+{
+#ifdef JSON_ZLIB
+    JsonGzip * this = Class->new("JsonGzip", sizeof(JsonGzip));
+    if (this == NULL) {
+        return NULL;
+    }
+
+    this->input = Class->new("JsonString", JSON_GZIP_INPUT_SIZE);
+    if (this->input == NULL) {
+        Class->delete((void **) & this);
+        return NULL;
+    }
+
+    memset(& this->stream, 0, sizeof(z_stream));
+    if (inflateInit2(& this->stream, JSON_GZIP_WINDOW_BITS) != Z_OK) {
+        Class->delete((void **) & this->input);
+        Class->delete((void **) & this);
+        return NULL;
+    }
+
+    this->file = file;
+    this->isEnded = 0;
+
+    return this;
+#else
+    (void) file;
+
+    return NULL;
+#endif
+}
+
+
+static void delete(JsonGzip ** this)
+{
+#ifdef JSON_ZLIB
+    if (* this == NULL) {
+        return;
+    }
+
+    inflateEnd(& (* this)->stream);
+    Class->delete((void **) & (* this)->input);
+    Class->delete((void **) this);
+#else
+    * this = NULL;
+#endif
+}
+
+
+static JsonSaxSource getSource(JsonGzip * const this)
+{
+    JsonSaxSource source;
+
+    source.read = __read;
+    source.context = this;
+
+    return source;
+}
+
+
+static int parseFile(FILE * file, JsonSaxHandler const * handler, void * context, JsonError * error)
+{
+    JsonGzip * this;
+    JsonSaxSource source;
+    int status;
+
+    this = _JsonGzip->new(file);
+    if (this == NULL) {
+#ifdef JSON_ZLIB
+        return __fail(error, JSON_ERROR_ALLOCATION);
+#else
+        return __fail(error, JSON_ERROR_READ);
+#endif
+    }
+
+    /* the reader thread decompresses the next chunks while this one parses */
+    source = _JsonGzip->getSource(this);
+    status = _JsonSax->parseSourceAsync(& source, JSON_GZIP_RING_SIZE, JSON_GZIP_CHUNK_SIZE, handler, context, error);
+    _JsonGzip->delete(& this);
+
+    return status;
+}
+
+
+
+
+static int __read(void * context, char * window, unsigned int capacity)
+{
+#ifdef JSON_ZLIB
+    JsonGzip * this = context;
+    size_t length;
+    int status;
+
+    this->stream.next_out = (Bytef *) window;
+    this->stream.avail_out = capacity;
+
+    /* an empty member produces nothing, so members are read until some characters come out */
+    while (this->stream.avail_out == capacity) {
+        if (this->stream.avail_in == 0) {
+            length = fread(this->input, 1, JSON_GZIP_INPUT_SIZE, this->file);
+            if (length == 0) {
+                return (ferror(this->file) || ! this->isEnded) ? -1 : 0;
+            }
+            this->stream.next_in = this->input;
+            this->stream.avail_in = length;
+        }
+
+        status = inflate(& this->stream, Z_NO_FLUSH);
+        if (status == Z_STREAM_END) {
+            /* the next member, if any, is decompressed as the continuation of the json-string */
+            this->isEnded = 1;
+            inflateReset(& this->stream);
+        } else if (status == Z_OK) {
+            this->isEnded = 0;
+        } else if ((status != Z_BUF_ERROR) || (this->stream.avail_in != 0)) {
+            return -1;
+        }
+    }
+
+    return capacity - this->stream.avail_out;
+#else
+    (void) context;
+    (void) window;
+    (void) capacity;
+
+    return -1;
+#endif
+}
+
+
+static int __fail(JsonError * error, JsonErrorCode code)
+{
+    if (error != NULL) {
+        error->code = code;
+        error->offset = 0;
+    }
+
+    return -1;
+}
+
+
+
+
+/**
+ * Init JsonGzip methods table
+ */
+static _JsonGzipMethods methods = {
+    new,
+    delete,
+    getSource,
+    parseFile
+};
+_JsonGzipMethods const * const _JsonGzip = & methods;
@@ -0,0 +1,80 @@
+
+#ifndef JSON_GZIP_HEADER
+#define JSON_GZIP_HEADER
+
+#include <stdio.h>
+
+#include "JsonGrammar.h"
+#include "JsonSax.h"
+
+
+
+
+/**
+ * A gzip stream decompressed as a source of a json-string
+ */
+typedef struct JsonGzip JsonGzip;
+
+
+
+
+/**
+ * JsonGzip methods table
+ * Decompression is only compiled in with JSON_ZLIB (`make ZLIB=1`), linking with zlib, otherwise no stream can be created
+ * Memory only depends on the compressed input buffer and on the window the json-string is decompressed into, not on its size
+ */
+typedef struct
+{
+    /**
+     * Constructor, reading a gzip or zlib stream from a file
+     * Streams made of several concatenated gzip members are read as one
+     *
+     * @param file - the file to read, from its current position to its end
+     *
+     * @return - a JsonGzip instance if allocation succeeds and decompression is compiled in, NULL otherwise
+     */
+    JsonGzip * (* new)(FILE * file);
+
+    /**
+     * Destructor, leaves the file open
+     *
+     * @param this - pointer to the instance to delete
+     */
+    void (* delete)(JsonGzip ** this);
+
+    /**
+     * Returns the source decompressing the stream, to read with JsonSax.parseSource or JsonSax.parseSourceAsync
+     * Its read fails on corrupted or truncated streams
+     *
+     * @param this - the stream to decompress
+     *
+     * @return - the source
+     */
+    JsonSaxSource (* getSource)(JsonGzip * const this);
+
+    /**
+     * Reads a compressed json file, decompressing it on a reader thread while the calling thread parses (@see JsonSax.parseSourceAsync)
+     *
+     * @param file - the file to read, from its current position to its end
+     * @param handler - the callbacks to call
+     * @param context - the user context passed to every callback
+     * @param error - where to store why the file is rejected, NULL to ignore it
+     *
+     * @return - 0 once the whole file is read, 1 if a callback stopped the parse, -1 if the file is rejected or can't be decompressed
+     */
+    int (* parseFile)(FILE * file, JsonSaxHandler const * handler, void * context, JsonError * error);
+
+} _JsonGzipMethods;
+
+
+
+
+/**
+ * JsonGzip class methods table
+ */
+extern _JsonGzipMethods const * const _JsonGzip;
+
+
+
+
+#endif /* JSON_GZIP_HEADER */
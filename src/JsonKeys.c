@@ -0,0 +1,233 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Class.h"
+#include "JsonKeys.h"
+
+
+
+
+/**
+ * Number of seeds tried for a bucket before giving up
+ */
+#define JSON_KEYS_MAX_SEED 1000000
+
+
+/**
+ * A bucket of keys, sorted by decreasing size before being placed
+ */
+typedef struct
+{
+    /**
+     * The index of the bucket
+     */
+    unsigned int index;
+
+    /**
+     * The number of keys in the bucket
+     */
+    unsigned int size;
+
+} JsonKeysBucket;
+
+
+
+
+/**
+ * Places the keys of a bucket of several keys, trying seeds until they all land in free and distinct slots
+ *
+ * @param keys - the keys
+ * @param count - the number of keys
+ * @param bucket - the bucket to place
+ * @param members - room for the index of each key of the bucket
+ * @param isTaken - whether each slot is taken, updated once placed
+ * @param slots - where to store the slot of each key of the bucket
+ *
+ * @return - the seed on success, -1 if no seed works
+ */
+static int __placeBucket(char const * const * keys, unsigned int count, JsonKeysBucket const * bucket, unsigned int * members, char * isTaken, unsigned int * slots);
+
+
+/**
+ * Orders buckets by decreasing size, then increasing index
+ *
+ * @param first - the first bucket
+ * @param second - the second bucket
+ *
+ * @return - a negative value if the first bucket comes first, a positive one otherwise
+ */
+static int __compareBuckets(void const * first, void const * second);
+
+
+
+
+static unsigned long hash(unsigned long seed, char const * key, size_t length)
+{
+    unsigned long value = (2166136261UL ^ (seed * 2654435761UL)) & 0xFFFFFFFFUL;
+    size_t index;
+
+    for (index = 0; index < length; index++) {
+        value ^= (unsigned char) key[index];
+        value = (value * 16777619UL) & 0xFFFFFFFFUL;
+    }
+
+    /* spreads the last characters over the low bits, which pick the slot */
+    value ^= value >> 16;
+    value = (value * 0x85EBCA6BUL) & 0xFFFFFFFFUL;
+    value ^= value >> 13;
+
+    return value;
+}
+
+
+static int find(JsonKeySet const * set, char const * key, size_t length)
+{
+    int displacement;
+    unsigned int slot;
+
+    if (set->count == 0) {
+        return -1;
+    }
+
+    displacement = set->displacements[_JsonKeys->hash(0, key, length) % set->count];
+    if (displacement == 0) {
+        return -1;
+    }
+
+    slot = (displacement < 0) ? (unsigned int) (- displacement - 1) : _JsonKeys->hash(displacement, key, length) % set->count;
+    if ((strlen(set->keys[slot]) != length) || (memcmp(set->keys[slot], key, length) != 0)) {
+        return -1;
+    }
+
+    return slot;
+}
+
+
+static int build(char const * const * keys, unsigned int count, int * displacements, unsigned int * slots)
+{
+    JsonKeysBucket * buckets;
+    unsigned int * members;
+    char * isTaken;
+    unsigned int key;
+    unsigned int other;
+    unsigned int index;
+    unsigned int freeSlot = 0;
+    int status = 0;
+
+    for (key = 0; key < count; key++) {
+        for (other = key + 1; other < count; other++) {
+            if (strcmp(keys[key], keys[other]) == 0) {
+                return JSON_KEYS_ERROR_DUPLICATED;
+            }
+        }
+    }
+
+    buckets = Class->new("JsonKeysBucket[]", count * sizeof(JsonKeysBucket) + 1);
+    members = Class->new("unsigned int[]", count * sizeof(unsigned int) + 1);
+    isTaken = Class->new("char[]", count + 1);
+    if ((buckets == NULL) || (members == NULL) || (isTaken == NULL)) {
+        status = JSON_KEYS_ERROR_ALLOCATION;
+    }
+
+    for (index = 0; (status == 0) && (index < count); index++) {
+        buckets[index].index = index;
+        displacements[index] = 0;
+    }
+    for (key = 0; (status == 0) && (key < count); key++) {
+        buckets[_JsonKeys->hash(0, keys[key], strlen(keys[key])) % count].size++;
+    }
+
+    if (status == 0) {
+        qsort(buckets, count, sizeof(JsonKeysBucket), __compareBuckets);
+    }
+
+    /* the largest buckets are placed first, while most slots are free */
+    for (index = 0; (status == 0) && (index < count) && (buckets[index].size > 1); index++) {
+        displacements[buckets[index].index] = __placeBucket(keys, count, & buckets[index], members, isTaken, slots);
+        status = (displacements[buckets[index].index] == -1) ? JSON_KEYS_ERROR_NO_SEED : 0;
+    }
+
+    /* single keys go straight to the remaining slots */
+    for (; (status == 0) && (index < count) && (buckets[index].size == 1); index++) {
+        for (key = 0; _JsonKeys->hash(0, keys[key], strlen(keys[key])) % count != buckets[index].index; key++);
+        while (isTaken[freeSlot]) {
+            freeSlot++;
+        }
+        isTaken[freeSlot] = 1;
+        slots[key] = freeSlot;
+        displacements[buckets[index].index] = - (int) freeSlot - 1;
+    }
+
+    Class->delete((void **) & buckets);
+    Class->delete((void **) & members);
+    Class->delete((void **) & isTaken);
+
+    return status;
+}
+
+
+
+
+static int __placeBucket(char const * const * keys, unsigned int count, JsonKeysBucket const * bucket, unsigned int * members, char * isTaken, unsigned int * slots)
+{
+    unsigned int membersCount = 0;
+    unsigned int member;
+    unsigned int other;
+    unsigned int key;
+    int seed;
+    int isPlaced;
+
+    for (key = 0; key < count; key++) {
+        if (_JsonKeys->hash(0, keys[key], strlen(keys[key])) % count == bucket->index) {
+            members[membersCount++] = key;
+        }
+    }
+
+    for (seed = 1; seed <= JSON_KEYS_MAX_SEED; seed++) {
+        isPlaced = 1;
+        for (member = 0; isPlaced && (member < membersCount); member++) {
+            key = members[member];
+            slots[key] = _JsonKeys->hash(seed, keys[key], strlen(keys[key])) % count;
+            isPlaced = ! isTaken[slots[key]];
+            for (other = 0; isPlaced && (other < member); other++) {
+                isPlaced = (slots[members[other]] != slots[key]);
+            }
+        }
+
+        if (isPlaced) {
+            for (member = 0; member < membersCount; member++) {
+                isTaken[slots[members[member]]] = 1;
+            }
+            return seed;
+        }
+    }
+
+    return -1;
+}
+
+
+static int __compareBuckets(void const * first, void const * second)
+{
+    JsonKeysBucket const * firstBucket = first;
+    JsonKeysBucket const * secondBucket = second;
+
+    if (firstBucket->size != secondBucket->size) {
+        return (firstBucket->size > secondBucket->size) ? -1 : 1;
+    }
+
+    return (firstBucket->index < secondBucket->index) ? -1 : 1;
+}
+
+
+
+
+/**
+ * Init JsonKeys methods table
+ */
+static _JsonKeysMethods methods = {
+    hash,
+    find,
+    build
+};
+_JsonKeysMethods const * const _JsonKeys = & methods;
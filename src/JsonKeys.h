@@ -0,0 +1,97 @@
+#ifndef JSON_KEYS_HEADER
+#define JSON_KEYS_HEADER
+
+
+
+
+/**
+ * A set of known keys with a minimal perfect hash, mapping each key to its slot
+ * Sets are usually generated as headers by `make keys-header` (see tools/src/JsonKeysGenerator.c)
+ */
+typedef struct
+{
+    /**
+     * The number of keys, which is also the number of slots and of buckets
+     */
+    unsigned int count;
+
+    /**
+     * For each bucket, the seed hashing its keys to their slots, -(slot + 1) for single key buckets, 0 for empty buckets
+     */
+    int const * displacements;
+
+    /**
+     * The key in each slot, as written between the quotes of a json-string
+     */
+    char const * const * keys;
+
+} JsonKeySet;
+
+
+/**
+ * Why a perfect hash of keys can't be built
+ */
+typedef enum
+{
+    JSON_KEYS_ERROR_DUPLICATED = -1,
+    JSON_KEYS_ERROR_NO_SEED = -2,
+    JSON_KEYS_ERROR_ALLOCATION = -3
+} JsonKeysError;
+
+
+
+
+/**
+ * JsonKeys methods table
+ * Looking a key up costs two hashes at most and a single comparison, whether the key is known or not
+ */
+typedef struct
+{
+    /**
+     * Hashes a key
+     *
+     * @param seed - the seed of the hash, 0 to find the bucket of the key
+     * @param key - the key
+     * @param length - the length of the key
+     *
+     * @return - the 32 bits hash of the key
+     */
+    unsigned long (* hash)(unsigned long seed, char const * key, size_t length);
+
+    /**
+     * Finds the slot of a key
+     *
+     * @param set - the known keys
+     * @param key - the key to look up, as written between the quotes of a json-string
+     * @param length - the length of the key
+     *
+     * @return - the slot of the key, -1 if it isn't a known key
+     */
+    int (* find)(JsonKeySet const * set, char const * key, size_t length);
+
+    /**
+     * Computes a minimal perfect hash of keys, by hash and displace
+     *
+     * @param keys - the keys
+     * @param count - the number of keys
+     * @param displacements - where to store the displacement of each of the count buckets
+     * @param slots - where to store the slot of each key
+     *
+     * @return - 0 on success, JSON_KEYS_ERROR_DUPLICATED, JSON_KEYS_ERROR_NO_SEED if no displacement is found or JSON_KEYS_ERROR_ALLOCATION otherwise
+     */
+    int (* build)(char const * const * keys, unsigned int count, int * displacements, unsigned int * slots);
+
+} _JsonKeysMethods;
+
+
+
+
+/**
+ * JsonKeys class methods table
+ */
+extern _JsonKeysMethods const * const _JsonKeys;
+
+
+
+
+#endif /* JSON_KEYS_HEADER */
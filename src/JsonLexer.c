@@ -0,0 +1,166 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "JsonToken.h"
+#include "JsonLexer.h"
+
+
+
+
+/**
+ * Checks if the character is a white-space between tokens
+ * 
+ * @param character - the character to check
+ * 
+ * @return - 1 if the character is a white-space, 0 otherwise
+ */
+static int __isWhiteSpace(char character);
+
+
+/**
+ * Checks if characters are the start of a token cut by the end of a chunk
+ * 
+ * @param string - the characters from the start of the token to the end of the chunk
+ * @param length - the number of characters
+ * 
+ * @return - 1 if more characters may complete the token, 0 otherwise
+ */
+static int __isCut(char const * const string, size_t length);
+
+
+
+
+static int next(char const * const string, size_t length, size_t * offset, JsonLexeme * lexeme)
+{
+    while ((* offset < length) && __isWhiteSpace(string[* offset])) {
+        (* offset)++;
+    }
+
+    if (* offset == length) {
+        return 0;
+    }
+
+    lexeme->start = string + * offset;
+    lexeme->type = _JsonToken->scan(lexeme->start, length - * offset, & lexeme->length);
+    if ((int) lexeme->type == -1) {
+        return -1;
+    }
+
+    * offset += lexeme->length;
+
+    return 1;
+}
+
+
+static int nextInChunk(char const * const string, size_t length, size_t * offset, JsonLexeme * lexeme, int isLast)
+{
+    int status = next(string, length, offset, lexeme);
+    int isNumber;
+
+    if (isLast || (status == 0)) {
+        return status;
+    }
+
+    /* a token reaching the end of the chunk may go on in the next one, as may a number followed by a partial exponent */
+    if (status == 1) {
+        isNumber = (lexeme->type == JSON_TOKEN_INTEGER) || (lexeme->type == JSON_TOKEN_FLOAT);
+        if ((lexeme->start + lexeme->length == string + length) || (isNumber && __isCut(lexeme->start, string + length - lexeme->start))) {
+            * offset = lexeme->start - string;
+            return 0;
+        }
+        return 1;
+    }
+
+    return __isCut(string + * offset, length - * offset) ? 0 : -1;
+}
+
+
+static int skipValue(char const * const string, size_t length, size_t * offset)
+{
+    JsonLexeme lexeme;
+    unsigned int depth = 0;
+
+    do {
+        if (_JsonLexer->next(string, length, offset, & lexeme) != 1) {
+            return -1;
+        }
+
+        if (lexeme.type != JSON_TOKEN_OPERATOR) {
+            continue;
+        }
+
+        switch (lexeme.start[0]) {
+            case JSON_OPERATOR_OBJECT_START:
+            case JSON_OPERATOR_ARRAY_START:
+                depth++;
+                break;
+            case JSON_OPERATOR_OBJECT_END:
+            case JSON_OPERATOR_ARRAY_END:
+                if (depth == 0) {
+                    return -1;
+                }
+                depth--;
+                break;
+            default:
+                if (depth == 0) {
+                    return -1;
+                }
+                break;
+        }
+    } while (depth > 0);
+
+    return 0;
+}
+
+
+
+
+static int __isWhiteSpace(char character)
+{
+    return (character == ' ') || (character == '\t') || (character == '\n') || (character == '\r');
+}
+
+
+static int __isCut(char const * const string, size_t length)
+{
+    size_t index;
+
+    switch (string[0]) {
+        case '"':
+            for (index = 1; index < length; index++) {
+                if (string[index] == '\\') {
+                    index++;
+                } else if (string[index] == '"') {
+                    return 0;
+                }
+            }
+            return 1;
+        case 't':
+            return (length < 4) && (strncmp(string, "true", length) == 0);
+        case 'f':
+            return (length < 5) && (strncmp(string, "false", length) == 0);
+        case 'n':
+            return (length < 4) && (strncmp(string, "null", length) == 0);
+        default:
+            for (index = 0; index < length; index++) {
+                if (strchr("0123456789+-.eE", string[index]) == NULL) {
+                    return 0;
+                }
+            }
+            return 1;
+    }
+}
+
+
+
+
+/**
+ * Init JsonLexer methods table
+ */
+static _JsonLexerMethods methods = {
+    next,
+    nextInChunk,
+    skipValue
+};
+_JsonLexerMethods const * const _JsonLexer = & methods;
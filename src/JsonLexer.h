@@ -0,0 +1,89 @@
+#ifndef JSON_LEXER_HEADER
+#define JSON_LEXER_HEADER
+
+#include "JsonToken.h"
+
+
+
+
+/**
+ * A token read from a json-string, borrowing its characters from it
+ */
+typedef struct
+{
+    /**
+     * The type of the token
+     */
+    JsonTokenType type;
+
+    /**
+     * The first character of the token in the json-string
+     */
+    char const * start;
+
+    /**
+     * The number of characters of the token
+     */
+    size_t length;
+
+} JsonLexeme;
+
+
+
+
+/**
+ * JsonLexer methods table
+ * The lexer allocates nothing, its only state is the offset in the json-string
+ */
+typedef struct
+{
+    /**
+     * Reads the next token, skipping the white-spaces before it
+     * 
+     * @param string - the json-string to read from
+     * @param length - the length of the json-string
+     * @param offset - the offset to read from, moved past the token read
+     * @param lexeme - where to store the token read
+     * 
+     * @return - 1 if a token was read, 0 at the end of the json-string, -1 if the characters aren't a valid token
+     */
+    int (* next)(char const * const string, size_t length, size_t * offset, JsonLexeme * lexeme);
+
+    /**
+     * Reads the next token of a chunk of a json-string, which is only complete if it ends before the chunk does
+     * 
+     * @param string - the chunk to read from
+     * @param length - the length of the chunk
+     * @param offset - the offset to read from, moved past the token read, or to the start of a cut token
+     * @param lexeme - where to store the token read
+     * @param isLast - whether the chunk ends the json-string
+     * 
+     * @return - 1 if a complete token was read, 0 at the end of the chunk or on a cut token, -1 if the characters aren't a valid token
+     */
+    int (* nextInChunk)(char const * const string, size_t length, size_t * offset, JsonLexeme * lexeme, int isLast);
+
+    /**
+     * Skips the value following the offset, a whole object or array included, without converting anything
+     * 
+     * @param string - the json-string to read from
+     * @param length - the length of the json-string
+     * @param offset - the offset to read from, moved past the skipped value
+     * 
+     * @return - 0 on success, -1 if the value isn't valid or complete
+     */
+    int (* skipValue)(char const * const string, size_t length, size_t * offset);
+
+} _JsonLexerMethods;
+
+
+
+
+/**
+ * JsonLexer class methods table
+ */
+extern _JsonLexerMethods const * const _JsonLexer;
+
+
+
+
+#endif /* JSON_LEXER_HEADER */
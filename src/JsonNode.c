@@ -0,0 +1,1614 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <float.h>
+
+#include "Class.h"
+#include "LinkedList.h"
+#include "JsonToken.h"
+#include "Json.h"
+#include "JsonNode.h"
+
+
+
+
+/**
+ * Longest representation of a number written by toString
+ */
+#define JSON_NODE_MAX_NUMBER_LENGTH 32
+
+
+/**
+ * Number of members from which an object indexes them by key
+ */
+#define JSON_NODE_INDEXED_MEMBERS 8
+
+
+struct JsonNode
+{
+    /**
+     * The type of the node
+     */
+    JsonNodeType type;
+
+    /**
+     * The number of owners of the node, parents included; it's copied before being modified if there are several
+     */
+    unsigned int referencesCount;
+
+    /**
+     * The value of a scalar node
+     */
+    union
+    {
+        JsonIntegerValue asInteger;
+        JsonFloatValue asFloat;
+        JsonBooleanValue asBoolean;
+        char * asString;
+    } value;
+
+    /**
+     * The representation of a number read from a json, written back as is, NULL for numbers built from a value
+     */
+    char * rawNumber;
+
+    /**
+     * The members of an object or the elements of an array
+     */
+    JsonNode ** children;
+
+    /**
+     * The keys of the members of an object, NULL for arrays
+     */
+    char ** keys;
+
+    /**
+     * The number of children
+     */
+    unsigned int count;
+
+    /**
+     * The number of children there is room for
+     */
+    unsigned int capacity;
+
+    /**
+     * Hash table of the members of a large object, each slot holding a member index + 1, NULL until looked up
+     */
+    unsigned int * slots;
+
+    /**
+     * The number of slots, a power of two
+     */
+    unsigned int slotsCount;
+
+    /**
+     * The structural hash of the node and its children, valid once isHashed is set
+     */
+    unsigned long hash;
+
+    /**
+     * Whether the hash is computed, reset when the node is modified
+     */
+    char isHashed;
+};
+
+
+
+
+/**
+ * Creates a node of the given type, without value
+ *
+ * @param type - the type of the node
+ *
+ * @return - a JsonNode instance if allocation succeeds, NULL otherwise
+ */
+static JsonNode * __new(JsonNodeType type);
+
+
+/**
+ * Creates a string node from a string which isn't terminated
+ *
+ * @param value - the first character of the string
+ * @param length - the number of characters of the string
+ *
+ * @return - a JsonNode instance if allocation succeeds, NULL otherwise
+ */
+static JsonNode * __newString(char const * const value, size_t length);
+
+
+/**
+ * Creates a number node from a token, keeping its representation so that numbers out of range are written back unchanged
+ *
+ * @param token - the integer or float token
+ *
+ * @return - a JsonNode instance if allocation succeeds, NULL otherwise
+ */
+static JsonNode * __newNumber(JsonToken const * token);
+
+
+/**
+ * Copies a node, sharing its children with the original
+ *
+ * @param this - the node to copy
+ *
+ * @return - the copy, referenced once, NULL if allocation fails
+ */
+static JsonNode * __copy(JsonNode const * const this);
+
+
+/**
+ * Makes sure the node in the slot is only referenced from there, copying it if needed
+ *
+ * @param slot - the slot referencing the node
+ *
+ * @return - 0 on success, -1 on allocation failure
+ */
+static int __unshare(JsonNode ** slot);
+
+
+/**
+ * Makes room for the given number of children
+ *
+ * @param this - the object or array to grow
+ * @param count - the number of children needed
+ *
+ * @return - 0 on success, -1 on allocation failure
+ */
+static int __reserve(JsonNode * this, unsigned int count);
+
+
+/**
+ * Adds a child after the last one
+ *
+ * @param this - the object or array to add the child to
+ * @param key - the key of the member, taken by the node, NULL for arrays
+ * @param child - the child, whose reference is taken
+ *
+ * @return - 0 on success, -1 on allocation failure
+ */
+static int __append(JsonNode * this, char * key, JsonNode * child);
+
+
+/**
+ * Hashes a key, or an escaped path segment as the key it designates
+ *
+ * @param string - the key or the json pointer
+ * @param start - the first character of the key or segment
+ * @param end - the end of the key or segment
+ * @param isSegment - whether "~0" and "~1" escapes are decoded
+ *
+ * @return - the FNV-1a hash of the key
+ */
+static unsigned long __hashKey(char const * const string, unsigned int start, unsigned int end, int isSegment);
+
+
+/**
+ * Adds a member to the hash table of an object
+ *
+ * @param this - the indexed object
+ * @param index - the index of the member
+ */
+static void __indexMember(JsonNode * this, unsigned int index);
+
+
+/**
+ * Builds the hash table of an object, sized for its members
+ *
+ * @param this - the object to index
+ *
+ * @return - 0 on success, -1 on allocation failure
+ */
+static int __buildIndex(JsonNode * this);
+
+
+/**
+ * Builds the node of the value starting at the given token
+ *
+ * @param tokens - the token to start from, moved past the value
+ *
+ * @return - the node of the value, NULL if allocation fails
+ */
+static JsonNode * __fromTokens(LinkedList ** tokens);
+
+
+/**
+ * Returns the end of a path segment
+ *
+ * @param path - the json pointer
+ * @param start - the first character of the segment
+ *
+ * @return - the offset of the '/' or '\0' following the segment
+ */
+static unsigned int __segmentEnd(char const * const path, unsigned int start);
+
+
+/**
+ * Checks if an escaped path segment is the given key
+ *
+ * @param path - the json pointer
+ * @param start - the first character of the segment
+ * @param end - the end of the segment
+ * @param key - the key to compare the segment with
+ *
+ * @return - 1 if the segment is the key, 0 otherwise
+ */
+static int __segmentIsKey(char const * const path, unsigned int start, unsigned int end, char const * const key);
+
+
+/**
+ * Copies a path segment, unescaping it
+ *
+ * @param path - the json pointer
+ * @param start - the first character of the segment
+ * @param end - the end of the segment
+ *
+ * @return - the unescaped segment, NULL if allocation fails
+ */
+static char * __decodeSegment(char const * const path, unsigned int start, unsigned int end);
+
+
+/**
+ * Finds the child designated by a path segment
+ *
+ * @param this - the object or array to search
+ * @param path - the json pointer
+ * @param start - the first character of the segment
+ * @param end - the end of the segment
+ * @param allowEnd - whether the index right after the last element ("-" or the size) designates a child
+ *
+ * @return - the index of the child, -1 if there's none
+ */
+static int __findChild(JsonNode const * const this, char const * const path, unsigned int start, unsigned int end, int allowEnd);
+
+
+/**
+ * Finds the parent of the node designated by a path, without modifying anything
+ *
+ * @param this - the root to start from
+ * @param path - the json pointer, not the root
+ * @param last - where to store the start of the last segment
+ *
+ * @return - the parent node, NULL if the path can't be reached
+ */
+static JsonNode * __resolveParent(JsonNode const * const this, char const * const path, unsigned int * last);
+
+
+/**
+ * Finds the parent of the node designated by a reachable path, unsharing every node on the way
+ *
+ * @param root - pointer to the root to start from
+ * @param path - the json pointer, not the root, reachable
+ * @param last - where to store the start of the last segment
+ *
+ * @return - the parent node, only referenced by the tree, NULL on allocation failure
+ */
+static JsonNode * __unshareParent(JsonNode ** root, char const * const path, unsigned int * last);
+
+
+/**
+ * Sets or inserts a node at a path, @see set and insert
+ *
+ * @param root - pointer to the root of the tree
+ * @param path - the json pointer to the node
+ * @param value - the new node
+ * @param inserting - whether array elements are inserted rather than replaced
+ *
+ * @return - 0 on success, -1 on failure
+ */
+static int __place(JsonNode ** root, char const * const path, JsonNode * value, int inserting);
+
+
+/**
+ * Mixes the four low bytes of a value into a hash
+ *
+ * @param hash - the hash to mix into
+ * @param value - the value to mix
+ *
+ * @return - the mixed hash
+ */
+static unsigned long __mix(unsigned long hash, unsigned long value);
+
+
+/**
+ * Scrambles the bits of a hash, so that summing hashes doesn't cancel them out
+ *
+ * @param hash - the hash to scramble
+ *
+ * @return - the scrambled hash
+ */
+static unsigned long __scramble(unsigned long hash);
+
+
+/**
+ * Reads the next character of a string, its escapes and utf-8 sequences decoded
+ *
+ * @param string - the string, with its escapes kept
+ * @param index - the index to read from, moved past the character
+ *
+ * @return - the code point of the character, -1 at the end of the string
+ */
+static long __nextCharacter(char const * const string, unsigned int * index);
+
+
+/**
+ * Decodes the hexadecimal digits of a \u escape
+ *
+ * @param string - the digits, stopping at the first non hexadecimal one
+ * @param digits - where to store the number of digits read, 4 at most
+ *
+ * @return - the value of the digits
+ */
+static long __decodeHexadecimal(char const * const string, unsigned int * digits);
+
+
+/**
+ * Hashes the characters of a string, once decoded
+ *
+ * @param string - the string, with its escapes kept
+ *
+ * @return - the hash of the string
+ */
+static unsigned long __hashString(char const * const string);
+
+
+/**
+ * Checks if two strings have the same characters, once decoded
+ *
+ * @param string - the first string, with its escapes kept
+ * @param other - the second string, with its escapes kept
+ *
+ * @return - 1 if the strings are equal, 0 otherwise
+ */
+static int __equalStrings(char const * const string, char const * const other);
+
+
+/**
+ * Finds the member of an object whose key is equal to the given one, once decoded
+ *
+ * @param this - the object
+ * @param key - the key, with its escapes kept
+ *
+ * @return - the member, NULL if there's none
+ */
+static JsonNode * __findMember(JsonNode const * const this, char const * const key);
+
+
+/**
+ * Writes the json-string of a node
+ *
+ * @param this - the node to serialize
+ * @param output - where to write, NULL to only measure
+ *
+ * @return - the number of characters of the json-string
+ */
+static size_t __write(JsonNode const * const this, char * output);
+
+
+
+
+static JsonNode * newObject(void)
+{
+    return __new(JSON_NODE_OBJECT);
+}
+
+
+static JsonNode * newArray(void)
+{
+    return __new(JSON_NODE_ARRAY);
+}
+
+
+static JsonNode * newString(char const * const value)
+{
+    return __newString(value, strlen(value));
+}
+
+
+static JsonNode * newInteger(JsonIntegerValue value)
+{
+    JsonNode * this = __new(JSON_NODE_INTEGER);
+
+    if (this != NULL) {
+        this->value.asInteger = value;
+    }
+
+    return this;
+}
+
+
+static JsonNode * newFloat(JsonFloatValue value)
+{
+    JsonNode * this;
+
+    /* infinities and NaN have no json representation */
+    if ((value != value) || (value > DBL_MAX) || (value < -DBL_MAX)) {
+        return NULL;
+    }
+
+    this = __new(JSON_NODE_FLOAT);
+
+    if (this != NULL) {
+        this->value.asFloat = value;
+    }
+
+    return this;
+}
+
+
+static JsonNode * newBoolean(JsonBooleanValue value)
+{
+    JsonNode * this = __new(JSON_NODE_BOOLEAN);
+
+    if (this != NULL) {
+        this->value.asBoolean = value;
+    }
+
+    return this;
+}
+
+
+static JsonNode * newNull(void)
+{
+    return __new(JSON_NODE_NULL);
+}
+
+
+static JsonNode * fromJson(Json const * const json)
+{
+    LinkedList * tokens = _Json->getTokens(json);
+
+    if (tokens == NULL) {
+        return NULL;
+    }
+
+    return __fromTokens(& tokens);
+}
+
+
+static void delete(JsonNode ** this)
+{
+    unsigned int index;
+
+    if ((this == NULL) || (* this == NULL)) {
+        return;
+    }
+
+    if (CLASS_RELEASE((* this)->referencesCount) > 0) {
+        * this = NULL;
+        return;
+    }
+
+    for (index = 0; index < (* this)->count; index++) {
+        _JsonNode->delete(& (* this)->children[index]);
+        if ((* this)->keys != NULL) {
+            Class->delete((void **) & (* this)->keys[index]);
+        }
+    }
+    Class->delete((void **) & (* this)->children);
+    Class->delete((void **) & (* this)->keys);
+    Class->delete((void **) & (* this)->slots);
+
+    if ((* this)->type == JSON_NODE_STRING) {
+        Class->delete((void **) & (* this)->value.asString);
+    }
+    Class->delete((void **) & (* this)->rawNumber);
+
+    Class->delete((void **) this);
+}
+
+
+static JsonNode * retain(JsonNode * const this)
+{
+    CLASS_RETAIN(this->referencesCount);
+
+    return this;
+}
+
+
+static int freeze(JsonNode * const this)
+{
+    unsigned int index;
+
+    if ((this->count >= JSON_NODE_INDEXED_MEMBERS) && (this->keys != NULL) && (this->slots == NULL) && (__buildIndex(this) != 0)) {
+        return -1;
+    }
+
+    for (index = 0; index < this->count; index++) {
+        if (_JsonNode->freeze(this->children[index]) != 0) {
+            return -1;
+        }
+    }
+
+    /* hashes are cached along the whole tree */
+    _JsonNode->hash(this);
+
+    return 0;
+}
+
+
+static JsonNodeType getType(JsonNode const * const this)
+{
+    return this->type;
+}
+
+
+static unsigned int size(JsonNode const * const this)
+{
+    return this->count;
+}
+
+
+static char const * getKey(JsonNode const * const this, unsigned int index)
+{
+    if ((this->keys == NULL) || (index >= this->count)) {
+        return NULL;
+    }
+
+    return this->keys[index];
+}
+
+
+static JsonNode * getChild(JsonNode const * const this, unsigned int index)
+{
+    if (index >= this->count) {
+        return NULL;
+    }
+
+    return this->children[index];
+}
+
+
+static JsonNode * getMember(JsonNode const * const this, char const * const key)
+{
+    unsigned int index;
+    unsigned int slot;
+
+    if (this->type != JSON_NODE_OBJECT) {
+        return NULL;
+    }
+
+    if ((this->count >= JSON_NODE_INDEXED_MEMBERS) && ((this->slots != NULL) || (__buildIndex((JsonNode *) this) == 0))) {
+        slot = __hashKey(key, 0, strlen(key), 0) & (this->slotsCount - 1);
+        for (; this->slots[slot] != 0; slot = (slot + 1) & (this->slotsCount - 1)) {
+            if (strcmp(this->keys[this->slots[slot] - 1], key) == 0) {
+                return this->children[this->slots[slot] - 1];
+            }
+        }
+        return NULL;
+    }
+
+    for (index = 0; index < this->count; index++) {
+        if (strcmp(this->keys[index], key) == 0) {
+            return this->children[index];
+        }
+    }
+
+    return NULL;
+}
+
+
+static unsigned long hash(JsonNode const * const this)
+{
+    JsonNode * node = (JsonNode *) this;
+    unsigned char bytes[sizeof(JsonFloatValue)];
+    JsonFloatValue number;
+    unsigned long members = 0;
+    unsigned long value;
+    unsigned int index;
+
+    if (this->isHashed) {
+        return this->hash;
+    }
+
+    /* integers and floats of the same value share their hash */
+    value = __mix(2166136261UL, (this->type == JSON_NODE_FLOAT) ? JSON_NODE_INTEGER : this->type);
+
+    switch (this->type) {
+        case JSON_NODE_STRING:
+            value = __mix(value, __hashString(this->value.asString));
+            break;
+        case JSON_NODE_INTEGER:
+        case JSON_NODE_FLOAT:
+            number = (this->type == JSON_NODE_INTEGER) ? (JsonFloatValue) this->value.asInteger : this->value.asFloat;
+            if (number == 0) {
+                number = 0;
+            }
+            memcpy(bytes, & number, sizeof(bytes));
+            for (index = 0; index < sizeof(bytes); index++) {
+                value = __mix(value, bytes[index]);
+            }
+            break;
+        case JSON_NODE_BOOLEAN:
+            value = __mix(value, this->value.asBoolean != 0);
+            break;
+        case JSON_NODE_ARRAY:
+            for (index = 0; index < this->count; index++) {
+                value = __mix(value, _JsonNode->hash(this->children[index]));
+            }
+            break;
+        case JSON_NODE_OBJECT:
+            /* members are summed, so that their order doesn't matter */
+            for (index = 0; index < this->count; index++) {
+                members += __scramble(__mix(__hashString(this->keys[index]), _JsonNode->hash(this->children[index])));
+            }
+            value = __mix(__mix(value, this->count), members & 0xFFFFFFFFUL);
+            break;
+        default:
+            break;
+    }
+
+    node->hash = value;
+    node->isHashed = 1;
+
+    return value;
+}
+
+
+static int equals(JsonNode const * const this, JsonNode const * const other)
+{
+    JsonNodeType type = this->type;
+    JsonNodeType otherType = other->type;
+    JsonNode const * otherMember;
+    unsigned int index;
+
+    if (this == other) {
+        return 1;
+    }
+
+    if (_JsonNode->hash(this) != _JsonNode->hash(other)) {
+        return 0;
+    }
+
+    if (((type == JSON_NODE_INTEGER) || (type == JSON_NODE_FLOAT)) && ((otherType == JSON_NODE_INTEGER) || (otherType == JSON_NODE_FLOAT))) {
+        if ((type == JSON_NODE_INTEGER) && (otherType == JSON_NODE_INTEGER)) {
+            return this->value.asInteger == other->value.asInteger;
+        }
+        return ((type == JSON_NODE_INTEGER) ? (JsonFloatValue) this->value.asInteger : this->value.asFloat)
+            == ((otherType == JSON_NODE_INTEGER) ? (JsonFloatValue) other->value.asInteger : other->value.asFloat);
+    }
+
+    if ((type != otherType) || (this->count != other->count)) {
+        return 0;
+    }
+
+    switch (type) {
+        case JSON_NODE_STRING:
+            return __equalStrings(this->value.asString, other->value.asString);
+        case JSON_NODE_BOOLEAN:
+            return (this->value.asBoolean != 0) == (other->value.asBoolean != 0);
+        case JSON_NODE_ARRAY:
+            for (index = 0; index < this->count; index++) {
+                if (! _JsonNode->equals(this->children[index], other->children[index])) {
+                    return 0;
+                }
+            }
+            return 1;
+        case JSON_NODE_OBJECT:
+            for (index = 0; index < this->count; index++) {
+                otherMember = __findMember(other, this->keys[index]);
+                if ((otherMember == NULL) || ! _JsonNode->equals(this->children[index], otherMember)) {
+                    return 0;
+                }
+            }
+            return 1;
+        default:
+            return 1;
+    }
+}
+
+
+static JsonNode * get(JsonNode const * const this, char const * const path)
+{
+    JsonNode const * parent;
+    unsigned int last;
+    int index;
+
+    if (path[0] == '\0') {
+        return (JsonNode *) this;
+    }
+
+    parent = __resolveParent(this, path, & last);
+    if (parent == NULL) {
+        return NULL;
+    }
+
+    index = __findChild(parent, path, last, strlen(path), 0);
+    if (index == -1) {
+        return NULL;
+    }
+
+    return parent->children[index];
+}
+
+
+static JsonIntegerValue asInteger(JsonNode const * const this)
+{
+    return this->value.asInteger;
+}
+
+
+static JsonFloatValue asFloat(JsonNode const * const this)
+{
+    return this->value.asFloat;
+}
+
+
+static JsonBooleanValue asBoolean(JsonNode const * const this)
+{
+    return this->value.asBoolean;
+}
+
+
+static char const * asString(JsonNode const * const this)
+{
+    return this->value.asString;
+}
+
+
+static int set(JsonNode ** root, char const * const path, JsonNode * value)
+{
+    return __place(root, path, value, 0);
+}
+
+
+static int insert(JsonNode ** root, char const * const path, JsonNode * value)
+{
+    return __place(root, path, value, 1);
+}
+
+
+static int JsonNode_remove(JsonNode ** root, char const * const path)
+{
+    JsonNode * parent;
+    unsigned int last;
+    unsigned int end = strlen(path);
+    int index;
+
+    if (path[0] == '\0') {
+        return -1;
+    }
+
+    parent = __resolveParent(* root, path, & last);
+    if ((parent == NULL) || (__findChild(parent, path, last, end, 0) == -1)) {
+        return -1;
+    }
+
+    parent = __unshareParent(root, path, & last);
+    if (parent == NULL) {
+        return -1;
+    }
+
+    index = __findChild(parent, path, last, end, 0);
+    _JsonNode->delete(& parent->children[index]);
+    memmove(parent->children + index, parent->children + index + 1, (parent->count - index - 1) * sizeof(JsonNode *));
+    if (parent->keys != NULL) {
+        Class->delete((void **) & parent->keys[index]);
+        memmove(parent->keys + index, parent->keys + index + 1, (parent->count - index - 1) * sizeof(char *));
+        /* member indexes moved, the table is built again on next lookup */
+        Class->delete((void **) & parent->slots);
+    }
+    parent->count--;
+
+    return 0;
+}
+
+
+static char * toString(JsonNode const * const this)
+{
+    char * string;
+    size_t length;
+
+    length = __write(this, NULL);
+    string = Class->new("JsonString", length + 1);
+    if (string == NULL) {
+        return NULL;
+    }
+
+    __write(this, string);
+
+    return string;
+}
+
+
+
+
+static JsonNode * __new(JsonNodeType type)
+{
+    JsonNode * this = Class->new("JsonNode", sizeof(* this));
+
+    if (this != NULL) {
+        this->type = type;
+        this->referencesCount = 1;
+    }
+
+    return this;
+}
+
+
+static JsonNode * __newString(char const * const value, size_t length)
+{
+    JsonNode * this = __new(JSON_NODE_STRING);
+
+    if (this == NULL) {
+        return NULL;
+    }
+
+    this->value.asString = Class->new("JsonString", length + 1);
+    if (this->value.asString == NULL) {
+        _JsonNode->delete(& this);
+        return NULL;
+    }
+    memcpy(this->value.asString, value, length);
+
+    return this;
+}
+
+
+static JsonNode * __newNumber(JsonToken const * token)
+{
+    char const * rawNumber = _JsonToken->getRawNumber(token);
+    JsonNode * this;
+
+    if (_JsonToken->getType(token) == JSON_TOKEN_INTEGER) {
+        this = __new(JSON_NODE_INTEGER);
+        if (this != NULL) {
+            this->value.asInteger = _JsonToken->asInteger(token);
+        }
+    } else {
+        this = __new(JSON_NODE_FLOAT);
+        if (this != NULL) {
+            this->value.asFloat = _JsonToken->asFloat(token);
+        }
+    }
+
+    if (this == NULL) {
+        return NULL;
+    }
+
+    this->rawNumber = Class->new("JsonString", strlen(rawNumber) + 1);
+    if (this->rawNumber == NULL) {
+        _JsonNode->delete(& this);
+        return NULL;
+    }
+    strcpy(this->rawNumber, rawNumber);
+
+    return this;
+}
+
+
+static JsonNode * __copy(JsonNode const * const this)
+{
+    JsonNode * copy;
+    unsigned int index;
+    char * key = NULL;
+
+    if (this->type == JSON_NODE_STRING) {
+        return _JsonNode->newString(this->value.asString);
+    }
+
+    copy = __new(this->type);
+    if ((copy == NULL) || (__reserve(copy, this->count) != 0)) {
+        _JsonNode->delete(& copy);
+        return NULL;
+    }
+    copy->value = this->value;
+
+    if (this->rawNumber != NULL) {
+        copy->rawNumber = Class->new("JsonString", strlen(this->rawNumber) + 1);
+        if (copy->rawNumber == NULL) {
+            _JsonNode->delete(& copy);
+            return NULL;
+        }
+        strcpy(copy->rawNumber, this->rawNumber);
+    }
+
+    for (index = 0; index < this->count; index++) {
+        if (this->keys != NULL) {
+            key = Class->new("JsonString", strlen(this->keys[index]) + 1);
+            if (key == NULL) {
+                _JsonNode->delete(& copy);
+                return NULL;
+            }
+            strcpy(key, this->keys[index]);
+        }
+
+        __append(copy, key, _JsonNode->retain(this->children[index]));
+    }
+
+    return copy;
+}
+
+
+static int __unshare(JsonNode ** slot)
+{
+    JsonNode * copy;
+    JsonNode * original = * slot;
+
+    if ((* slot)->referencesCount == 1) {
+        return 0;
+    }
+
+    copy = __copy(* slot);
+    if (copy == NULL) {
+        return -1;
+    }
+
+    /* the other owners may have released the original meanwhile */
+    _JsonNode->delete(& original);
+    * slot = copy;
+
+    return 0;
+}
+
+
+static int __reserve(JsonNode * this, unsigned int count)
+{
+    unsigned int capacity = this->capacity;
+
+    if (count <= capacity) {
+        return 0;
+    }
+
+    if (capacity == 0) {
+        capacity = 4;
+    }
+    while (capacity < count) {
+        capacity *= 2;
+    }
+
+    if (this->children == NULL) {
+        this->children = Class->new("JsonNode *[]", capacity * sizeof(JsonNode *));
+    } else if (Class->resize((void **) & this->children, this->capacity * sizeof(JsonNode *), capacity * sizeof(JsonNode *)) != 0) {
+        return -1;
+    }
+    if (this->children == NULL) {
+        return -1;
+    }
+
+    if (this->type == JSON_NODE_OBJECT) {
+        if (this->keys == NULL) {
+            this->keys = Class->new("char *[]", capacity * sizeof(char *));
+        } else if (Class->resize((void **) & this->keys, this->capacity * sizeof(char *), capacity * sizeof(char *)) != 0) {
+            return -1;
+        }
+        if (this->keys == NULL) {
+            return -1;
+        }
+    }
+
+    this->capacity = capacity;
+
+    return 0;
+}
+
+
+static int __append(JsonNode * this, char * key, JsonNode * child)
+{
+    if (__reserve(this, this->count + 1) != 0) {
+        return -1;
+    }
+
+    if (this->keys != NULL) {
+        this->keys[this->count] = key;
+    }
+    this->children[this->count] = child;
+    this->count++;
+
+    if (this->slots != NULL) {
+        if (this->count * 2 > this->slotsCount) {
+            Class->delete((void **) & this->slots);
+        } else {
+            __indexMember(this, this->count - 1);
+        }
+    }
+
+    return 0;
+}
+
+
+static unsigned long __hashKey(char const * const string, unsigned int start, unsigned int end, int isSegment)
+{
+    unsigned long hash = 2166136261UL;
+    char character;
+
+    for (; start < end; start++) {
+        character = string[start];
+        if (isSegment && (character == '~') && (start + 1 < end)) {
+            start++;
+            character = (string[start] == '1') ? '/' : '~';
+        }
+
+        hash ^= (unsigned char) character;
+        hash = (hash * 16777619UL) & 0xFFFFFFFFUL;
+    }
+
+    return hash;
+}
+
+
+static void __indexMember(JsonNode * this, unsigned int index)
+{
+    unsigned int slot;
+
+    slot = __hashKey(this->keys[index], 0, strlen(this->keys[index]), 0) & (this->slotsCount - 1);
+    while (this->slots[slot] != 0) {
+        slot = (slot + 1) & (this->slotsCount - 1);
+    }
+
+    this->slots[slot] = index + 1;
+}
+
+
+static int __buildIndex(JsonNode * this)
+{
+    unsigned int slotsCount = 16;
+    unsigned int index;
+
+    while (slotsCount < this->count * 2) {
+        slotsCount *= 2;
+    }
+
+    this->slots = Class->new("unsigned int[]", slotsCount * sizeof(unsigned int));
+    if (this->slots == NULL) {
+        return -1;
+    }
+    this->slotsCount = slotsCount;
+
+    for (index = 0; index < this->count; index++) {
+        __indexMember(this, index);
+    }
+
+    return 0;
+}
+
+
+static JsonNode * __fromTokens(LinkedList ** tokens)
+{
+    JsonToken * token = _LinkedList->getContent(* tokens);
+    JsonNode * this = NULL;
+    JsonNode * child;
+    JsonOperatorValue closing;
+    char const * key = NULL;
+    char * keyCopy = NULL;
+
+    * tokens = _LinkedList->nextElement(* tokens);
+
+    switch (_JsonToken->getType(token)) {
+        case JSON_TOKEN_INTEGER:
+        case JSON_TOKEN_FLOAT:
+            return __newNumber(token);
+        case JSON_TOKEN_BOOLEAN:
+            return _JsonNode->newBoolean(_JsonToken->asBoolean(token));
+        case JSON_TOKEN_NULL:
+            return _JsonNode->newNull();
+        case JSON_TOKEN_STRING:
+            key = _JsonToken->getRawString(token);
+            return __newString(key + 1, strlen(key) - 2);
+        default:
+            break;
+    }
+
+    if (_JsonToken->asOperator(token) == JSON_OPERATOR_OBJECT_START) {
+        this = __new(JSON_NODE_OBJECT);
+        closing = JSON_OPERATOR_OBJECT_END;
+    } else {
+        this = __new(JSON_NODE_ARRAY);
+        closing = JSON_OPERATOR_ARRAY_END;
+    }
+
+    /* the json is validated, tokens are known to follow the grammar */
+    while (this != NULL) {
+        token = _LinkedList->getContent(* tokens);
+        if ((_JsonToken->getType(token) == JSON_TOKEN_OPERATOR) && (_JsonToken->asOperator(token) == closing)) {
+            * tokens = _LinkedList->nextElement(* tokens);
+            break;
+        }
+
+        if ((_JsonToken->getType(token) == JSON_TOKEN_OPERATOR) && (_JsonToken->asOperator(token) == JSON_OPERATOR_COMMA)) {
+            * tokens = _LinkedList->nextElement(* tokens);
+            continue;
+        }
+
+        if (this->type == JSON_NODE_OBJECT) {
+            key = _JsonToken->getRawString(token);
+            keyCopy = Class->new("JsonString", strlen(key) - 1);
+            if (keyCopy != NULL) {
+                memcpy(keyCopy, key + 1, strlen(key) - 2);
+            }
+            /* skips the key and the colon */
+            * tokens = _LinkedList->nextElement(_LinkedList->nextElement(* tokens));
+        }
+
+        child = __fromTokens(tokens);
+        if ((child == NULL) || ((this->type == JSON_NODE_OBJECT) && (keyCopy == NULL)) || (__append(this, keyCopy, child) != 0)) {
+            _JsonNode->delete(& child);
+            Class->delete((void **) & keyCopy);
+            _JsonNode->delete(& this);
+        }
+        keyCopy = NULL;
+    }
+
+    return this;
+}
+
+
+static unsigned int __segmentEnd(char const * const path, unsigned int start)
+{
+    while ((path[start] != '/') && (path[start] != '\0')) {
+        start++;
+    }
+
+    return start;
+}
+
+
+static int __segmentIsKey(char const * const path, unsigned int start, unsigned int end, char const * const key)
+{
+    unsigned int keyIndex = 0;
+    char character;
+
+    for (; start < end; start++, keyIndex++) {
+        character = path[start];
+        if ((character == '~') && (start + 1 < end)) {
+            start++;
+            character = (path[start] == '1') ? '/' : '~';
+        }
+
+        if (key[keyIndex] != character) {
+            return 0;
+        }
+    }
+
+    return key[keyIndex] == '\0';
+}
+
+
+static char * __decodeSegment(char const * const path, unsigned int start, unsigned int end)
+{
+    char * key;
+    unsigned int keyIndex = 0;
+
+    key = Class->new("JsonString", end - start + 1);
+    if (key == NULL) {
+        return NULL;
+    }
+
+    for (; start < end; start++, keyIndex++) {
+        key[keyIndex] = path[start];
+        if ((path[start] == '~') && (start + 1 < end)) {
+            start++;
+            key[keyIndex] = (path[start] == '1') ? '/' : '~';
+        }
+    }
+
+    return key;
+}
+
+
+static int __findChild(JsonNode const * const this, char const * const path, unsigned int start, unsigned int end, int allowEnd)
+{
+    unsigned int index;
+    unsigned long elementIndex = 0;
+    unsigned int slot;
+
+    if ((this->type == JSON_NODE_OBJECT) && (this->count >= JSON_NODE_INDEXED_MEMBERS) && ((this->slots != NULL) || (__buildIndex((JsonNode *) this) == 0))) {
+        slot = __hashKey(path, start, end, 1) & (this->slotsCount - 1);
+        for (; this->slots[slot] != 0; slot = (slot + 1) & (this->slotsCount - 1)) {
+            if (__segmentIsKey(path, start, end, this->keys[this->slots[slot] - 1])) {
+                return this->slots[slot] - 1;
+            }
+        }
+        return -1;
+    }
+
+    if (this->type == JSON_NODE_OBJECT) {
+        for (index = 0; index < this->count; index++) {
+            if (__segmentIsKey(path, start, end, this->keys[index])) {
+                return index;
+            }
+        }
+        return -1;
+    }
+
+    if (this->type != JSON_NODE_ARRAY) {
+        return -1;
+    }
+
+    if ((end == start + 1) && (path[start] == '-')) {
+        return allowEnd ? (int) this->count : -1;
+    }
+
+    /* indexes are decimal, without leading zeros */
+    if ((start == end) || ((path[start] == '0') && (end > start + 1))) {
+        return -1;
+    }
+    for (index = start; index < end; index++) {
+        if ((path[index] < '0') || (path[index] > '9')) {
+            return -1;
+        }
+        elementIndex = elementIndex * 10 + (path[index] - '0');
+        if (elementIndex > this->count) {
+            return -1;
+        }
+    }
+
+    if ((elementIndex < this->count) || (allowEnd && (elementIndex == this->count))) {
+        return elementIndex;
+    }
+
+    return -1;
+}
+
+
+static JsonNode * __resolveParent(JsonNode const * const this, char const * const path, unsigned int * last)
+{
+    JsonNode const * node = this;
+    unsigned int position = 0;
+    unsigned int end;
+    int index;
+
+    while (path[position] == '/') {
+        end = __segmentEnd(path, position + 1);
+        if (path[end] == '\0') {
+            * last = position + 1;
+            return (JsonNode *) node;
+        }
+
+        index = __findChild(node, path, position + 1, end, 0);
+        if (index == -1) {
+            return NULL;
+        }
+
+        node = node->children[index];
+        position = end;
+    }
+
+    return NULL;
+}
+
+
+static JsonNode * __unshareParent(JsonNode ** root, char const * const path, unsigned int * last)
+{
+    JsonNode ** slot = root;
+    unsigned int position = 0;
+    unsigned int end;
+
+    while (__unshare(slot) == 0) {
+        /* every node on the path gets modified */
+        (* slot)->isHashed = 0;
+
+        end = __segmentEnd(path, position + 1);
+        if (path[end] == '\0') {
+            * last = position + 1;
+            return * slot;
+        }
+
+        slot = & (* slot)->children[__findChild(* slot, path, position + 1, end, 0)];
+        position = end;
+    }
+
+    return NULL;
+}
+
+
+static int __place(JsonNode ** root, char const * const path, JsonNode * value, int inserting)
+{
+    JsonNode * parent;
+    unsigned int last;
+    unsigned int end = strlen(path);
+    int index;
+    char * key;
+
+    if (path[0] == '\0') {
+        _JsonNode->delete(root);
+        * root = value;
+        return 0;
+    }
+
+    parent = __resolveParent(* root, path, & last);
+    if ((parent == NULL) || ((parent->type != JSON_NODE_OBJECT) && (__findChild(parent, path, last, end, inserting) == -1))) {
+        return -1;
+    }
+
+    parent = __unshareParent(root, path, & last);
+    if (parent == NULL) {
+        return -1;
+    }
+
+    index = __findChild(parent, path, last, end, inserting);
+
+    if ((parent->type == JSON_NODE_OBJECT) && (index == -1)) {
+        key = __decodeSegment(path, last, end);
+        if ((key == NULL) || (__append(parent, key, value) != 0)) {
+            Class->delete((void **) & key);
+            return -1;
+        }
+        return 0;
+    }
+
+    if ((parent->type == JSON_NODE_OBJECT) || ! inserting) {
+        _JsonNode->delete(& parent->children[index]);
+        parent->children[index] = value;
+        return 0;
+    }
+
+    if (__reserve(parent, parent->count + 1) != 0) {
+        return -1;
+    }
+    memmove(parent->children + index + 1, parent->children + index, (parent->count - index) * sizeof(JsonNode *));
+    parent->children[index] = value;
+    parent->count++;
+
+    return 0;
+}
+
+
+static unsigned long __mix(unsigned long hash, unsigned long value)
+{
+    unsigned int byte;
+
+    for (byte = 0; byte < 4; byte++) {
+        hash ^= (value >> (byte * 8)) & 0xFF;
+        hash = (hash * 16777619UL) & 0xFFFFFFFFUL;
+    }
+
+    return hash;
+}
+
+
+static unsigned long __scramble(unsigned long hash)
+{
+    hash ^= hash >> 16;
+    hash = (hash * 0x85EBCA6BUL) & 0xFFFFFFFFUL;
+    hash ^= hash >> 13;
+    hash = (hash * 0xC2B2AE35UL) & 0xFFFFFFFFUL;
+    hash ^= hash >> 16;
+
+    return hash;
+}
+
+
+static long __nextCharacter(char const * const string, unsigned int * index)
+{
+    unsigned char const * characters = (unsigned char const *) string;
+    long character = characters[* index];
+    long low;
+    unsigned int digits;
+    unsigned int following;
+
+    if (character == '\0') {
+        return -1;
+    }
+    (* index)++;
+
+    if ((character == '\\') && (characters[* index] != '\0')) {
+        character = characters[(* index)++];
+        switch (character) {
+            case 'b':
+                return '\b';
+            case 'f':
+                return '\f';
+            case 'n':
+                return '\n';
+            case 'r':
+                return '\r';
+            case 't':
+                return '\t';
+            case 'u':
+                break;
+            default:
+                return character;
+        }
+
+        character = __decodeHexadecimal(string + * index, & digits);
+        * index += digits;
+
+        /* a high surrogate followed by a low one encodes a single character */
+        if ((character >= 0xD800) && (character < 0xDC00) && (characters[* index] == '\\') && (characters[* index + 1] == 'u')) {
+            low = __decodeHexadecimal(string + * index + 2, & digits);
+            if ((digits == 4) && (low >= 0xDC00) && (low < 0xE000)) {
+                * index += 6;
+                character = 0x10000 + ((character - 0xD800) << 10) + (low - 0xDC00);
+            }
+        }
+        return character;
+    }
+
+    /* utf-8 sequences are decoded to their code point, as \u escapes are */
+    if (character >= 0xC0) {
+        following = (character >= 0xF0) ? 3 : ((character >= 0xE0) ? 2 : 1);
+        character &= 0x3F >> following;
+        for (; (following > 0) && ((characters[* index] & 0xC0) == 0x80); following--, (* index)++) {
+            character = (character << 6) | (characters[* index] & 0x3F);
+        }
+    }
+
+    return character;
+}
+
+
+static long __decodeHexadecimal(char const * const string, unsigned int * digits)
+{
+    long value = 0;
+
+    for (* digits = 0; (* digits < 4) && isxdigit((unsigned char) string[* digits]); (* digits)++) {
+        value = value * 16 + (isdigit((unsigned char) string[* digits]) ? string[* digits] - '0' : tolower((unsigned char) string[* digits]) - 'a' + 10);
+    }
+
+    return value;
+}
+
+
+static unsigned long __hashString(char const * const string)
+{
+    unsigned long hash = 2166136261UL;
+    unsigned int index = 0;
+    long character;
+
+    while ((character = __nextCharacter(string, & index)) != -1) {
+        hash = __mix(hash, character);
+    }
+
+    return hash;
+}
+
+
+static int __equalStrings(char const * const string, char const * const other)
+{
+    unsigned int index = 0;
+    unsigned int otherIndex = 0;
+    long character;
+
+    if (strcmp(string, other) == 0) {
+        return 1;
+    }
+
+    do {
+        character = __nextCharacter(string, & index);
+        if (character != __nextCharacter(other, & otherIndex)) {
+            return 0;
+        }
+    } while (character != -1);
+
+    return 1;
+}
+
+
+static JsonNode * __findMember(JsonNode const * const this, char const * const key)
+{
+    JsonNode * member = _JsonNode->getMember(this, key);
+    unsigned int index;
+
+    if (member != NULL) {
+        return member;
+    }
+
+    /* the key may be escaped differently */
+    for (index = 0; index < this->count; index++) {
+        if (__equalStrings(this->keys[index], key)) {
+            return this->children[index];
+        }
+    }
+
+    return NULL;
+}
+
+
+static size_t __write(JsonNode const * const this, char * output)
+{
+    char number[JSON_NODE_MAX_NUMBER_LENGTH];
+    size_t length = 0;
+    unsigned int index;
+
+    if (this->rawNumber != NULL) {
+        length = strlen(this->rawNumber);
+        if (output != NULL) {
+            memcpy(output, this->rawNumber, length + 1);
+        }
+        return length;
+    }
+
+    switch (this->type) {
+        case JSON_NODE_STRING:
+            length = strlen(this->value.asString) + 2;
+            if (output != NULL) {
+                sprintf(output, "\"%s\"", this->value.asString);
+            }
+            return length;
+        case JSON_NODE_INTEGER:
+            sprintf(number, "%ld", this->value.asInteger);
+            break;
+        case JSON_NODE_FLOAT:
+            sprintf(number, "%.17g", this->value.asFloat);
+            if (strpbrk(number, ".eE") == NULL) {
+                strcat(number, ".0");
+            }
+            break;
+        case JSON_NODE_BOOLEAN:
+            strcpy(number, this->value.asBoolean ? "true" : "false");
+            break;
+        case JSON_NODE_NULL:
+            strcpy(number, "null");
+            break;
+        default:
+            break;
+    }
+
+    if ((this->type != JSON_NODE_OBJECT) && (this->type != JSON_NODE_ARRAY)) {
+        length = strlen(number);
+        if (output != NULL) {
+            memcpy(output, number, length + 1);
+        }
+        return length;
+    }
+
+    if (output != NULL) {
+        output[0] = (this->type == JSON_NODE_OBJECT) ? '{' : '[';
+    }
+    length++;
+
+    for (index = 0; index < this->count; index++) {
+        if (index > 0) {
+            if (output != NULL) {
+                output[length] = ',';
+            }
+            length++;
+        }
+
+        if (this->keys != NULL) {
+            if (output != NULL) {
+                sprintf(output + length, "\"%s\":", this->keys[index]);
+            }
+            length += strlen(this->keys[index]) + 3;
+        }
+
+        length += __write(this->children[index], (output != NULL) ? output + length : NULL);
+    }
+
+    if (output != NULL) {
+        output[length] = (this->type == JSON_NODE_OBJECT) ? '}' : ']';
+        output[length + 1] = '\0';
+    }
+    length++;
+
+    return length;
+}
+
+
+
+
+/**
+ * Init JsonNode methods table
+ */
+static _JsonNodeMethods methods = {
+    newObject,
+    newArray,
+    newString,
+    newInteger,
+    newFloat,
+    newBoolean,
+    newNull,
+    fromJson,
+    delete,
+    retain,
+    freeze,
+    getType,
+    size,
+    getKey,
+    getChild,
+    getMember,
+    hash,
+    equals,
+    get,
+    asInteger,
+    asFloat,
+    asBoolean,
+    asString,
+    set,
+    insert,
+    JsonNode_remove,
+    toString
+};
+_JsonNodeMethods const * const _JsonNode = & methods;
@@ -0,0 +1,305 @@
+#ifndef JSON_NODE_HEADER
+#define JSON_NODE_HEADER
+
+#include "JsonToken.h"
+#include "Json.h"
+
+
+
+
+/**
+ * Types a node may have
+ */
+typedef enum
+{
+    JSON_NODE_OBJECT,
+    JSON_NODE_ARRAY,
+    JSON_NODE_STRING,
+    JSON_NODE_INTEGER,
+    JSON_NODE_FLOAT,
+    JSON_NODE_BOOLEAN,
+    JSON_NODE_NULL
+} JsonNodeType;
+
+
+/**
+ * A mutable json value, which shares its unmodified children with its copies
+ */
+typedef struct JsonNode JsonNode;
+
+
+
+
+/**
+ * JsonNode methods table
+ * Nodes are reference counted, and copied on write: modifying a tree only copies the shared nodes on the modified path
+ * Paths are json pointers ("/users/0/name", with "~0" for '~' and "~1" for '/'), "" being the root
+ */
+typedef struct
+{
+    /**
+     * Constructor of an empty object
+     *
+     * @return - a JsonNode instance if allocation succeeds, NULL otherwise
+     */
+    JsonNode * (* newObject)(void);
+
+    /**
+     * Constructor of an empty array
+     *
+     * @return - a JsonNode instance if allocation succeeds, NULL otherwise
+     */
+    JsonNode * (* newArray)(void);
+
+    /**
+     * Constructor of a string
+     *
+     * @param value - the string, without quotes and with its escapes kept
+     *
+     * @return - a JsonNode instance if allocation succeeds, NULL otherwise
+     */
+    JsonNode * (* newString)(char const * const value);
+
+    /**
+     * Constructor of an integer
+     *
+     * @param value - the integer
+     *
+     * @return - a JsonNode instance if allocation succeeds, NULL otherwise
+     */
+    JsonNode * (* newInteger)(JsonIntegerValue value);
+
+    /**
+     * Constructor of a float
+     *
+     * @param value - the float
+     *
+     * @return - a JsonNode instance if the float is finite and allocation succeeds, NULL otherwise
+     */
+    JsonNode * (* newFloat)(JsonFloatValue value);
+
+    /**
+     * Constructor of a boolean
+     *
+     * @param value - the boolean
+     *
+     * @return - a JsonNode instance if allocation succeeds, NULL otherwise
+     */
+    JsonNode * (* newBoolean)(JsonBooleanValue value);
+
+    /**
+     * Constructor of a null
+     *
+     * @return - a JsonNode instance if allocation succeeds, NULL otherwise
+     */
+    JsonNode * (* newNull)(void);
+
+    /**
+     * Constructor of the tree of a parsed json
+     * Numbers keep their representation, so that those out of range are written back unchanged
+     *
+     * @param json - the json to build the tree of, it can be deleted afterwards
+     *
+     * @return - the root node if allocation succeeds, NULL otherwise
+     */
+    JsonNode * (* fromJson)(Json const * const json);
+
+    /**
+     * Destructor, releases a reference to the node and sets the pointer to NULL
+     * The node and its children are only deleted once every reference is released
+     *
+     * @param this - pointer to the instance to delete
+     */
+    void (* delete)(JsonNode ** this);
+
+    /**
+     * Adds a reference to the node, to be released with delete
+     * A tree whose root is retained is copied on its next modification, the other reference keeps the original
+     *
+     * @param this - the node to share
+     *
+     * @return - the node
+     */
+    JsonNode * (* retain)(JsonNode * const this);
+
+    /**
+     * Builds the member indexes and hashes of a tree at once rather than on first use,
+     * so that any number of threads may read it and retain or delete references to it
+     * Modifications through a reference copy the tree as usual, the frozen tree is left untouched
+     *
+     * @param this - the root of the tree to freeze
+     *
+     * @return - 0 on success, -1 on allocation failure
+     */
+    int (* freeze)(JsonNode * const this);
+
+    /**
+     * Returns the type of the node
+     *
+     * @param this - the node to get the type of
+     *
+     * @return - the type of the node
+     */
+    JsonNodeType (* getType)(JsonNode const * const this);
+
+    /**
+     * Returns the number of members of an object or of elements of an array
+     *
+     * @param this - the node to get the size of
+     *
+     * @return - the number of children, 0 for other types
+     */
+    unsigned int (* size)(JsonNode const * const this);
+
+    /**
+     * Returns the key of a member of an object
+     *
+     * @param this - the object
+     * @param index - the index of the member, in insertion order
+     *
+     * @return - the key of the member, NULL if there's none
+     */
+    char const * (* getKey)(JsonNode const * const this, unsigned int index);
+
+    /**
+     * Returns a member of an object or an element of an array, by index
+     *
+     * @param this - the object or array
+     * @param index - the index of the child
+     *
+     * @return - the child, borrowed from the node, NULL if there's none
+     */
+    JsonNode * (* getChild)(JsonNode const * const this, unsigned int index);
+
+    /**
+     * Returns a member of an object, by key
+     * Large objects index their members, looking them up doesn't depend on their number
+     *
+     * @param this - the object
+     * @param key - the key of the member, without quotes and with its escapes kept
+     *
+     * @return - the member, borrowed from the node, NULL if there's none
+     */
+    JsonNode * (* getMember)(JsonNode const * const this, char const * const key);
+
+    /**
+     * Returns a structural hash of the node: members in any order, numbers by value and strings once decoded give the same hash
+     * Hashes are kept by the nodes and only computed again for the modified ones
+     *
+     * @param this - the node to hash
+     *
+     * @return - the hash of the node and its children
+     */
+    unsigned long (* hash)(JsonNode const * const this);
+
+    /**
+     * Checks if two nodes are structurally equal: members in any order, numbers by value and strings once decoded
+     *
+     * @param this - the first node
+     * @param other - the second node
+     *
+     * @return - 1 if the nodes are equal, 0 otherwise
+     */
+    int (* equals)(JsonNode const * const this, JsonNode const * const other);
+
+    /**
+     * Returns the node at the given path
+     *
+     * @param this - the root to start from
+     * @param path - the json pointer to the node
+     *
+     * @return - the node, borrowed from the tree, NULL if there's none
+     */
+    JsonNode * (* get)(JsonNode const * const this, char const * const path);
+
+    /**
+     * Returns the value of an integer
+     *
+     * @param this - the integer node
+     *
+     * @return - the value of the node
+     */
+    JsonIntegerValue (* asInteger)(JsonNode const * const this);
+
+    /**
+     * Returns the value of a float
+     *
+     * @param this - the float node
+     *
+     * @return - the value of the node
+     */
+    JsonFloatValue (* asFloat)(JsonNode const * const this);
+
+    /**
+     * Returns the value of a boolean
+     *
+     * @param this - the boolean node
+     *
+     * @return - the value of the node
+     */
+    JsonBooleanValue (* asBoolean)(JsonNode const * const this);
+
+    /**
+     * Returns the value of a string
+     *
+     * @param this - the string node
+     *
+     * @return - the value of the node, without quotes and with its escapes kept
+     */
+    char const * (* asString)(JsonNode const * const this);
+
+    /**
+     * Replaces the node at the given path, or adds the member if the object has none with this key
+     *
+     * @param root - pointer to the root of the tree, replaced if the root gets copied or replaced
+     * @param path - the json pointer to the node
+     * @param value - the new node, whose reference is taken on success only
+     *
+     * @return - 0 on success, -1 if the path can't be reached or allocation fails
+     */
+    int (* set)(JsonNode ** root, char const * const path, JsonNode * value);
+
+    /**
+     * Inserts an element before the one at the given path ("-" after the last one), or sets an object member
+     *
+     * @param root - pointer to the root of the tree, replaced if the root gets copied or replaced
+     * @param path - the json pointer to the new node
+     * @param value - the new node, whose reference is taken on success only
+     *
+     * @return - 0 on success, -1 if the path can't be reached or allocation fails
+     */
+    int (* insert)(JsonNode ** root, char const * const path, JsonNode * value);
+
+    /**
+     * Removes the node at the given path
+     *
+     * @param root - pointer to the root of the tree, replaced if the root gets copied
+     * @param path - the json pointer to the node, not the root
+     *
+     * @return - 0 on success, -1 if there's no such node or allocation fails
+     */
+    int (* remove)(JsonNode ** root, char const * const path);
+
+    /**
+     * Serializes the node and its children, without white-spaces
+     *
+     * @param this - the node to serialize
+     *
+     * @return - the json-string, to delete with Class->delete, NULL if allocation fails
+     */
+    char * (* toString)(JsonNode const * const this);
+
+} _JsonNodeMethods;
+
+
+
+
+/**
+ * JsonNode class methods table
+ */
+extern _JsonNodeMethods const * const _JsonNode;
+
+
+
+
+#endif /* JSON_NODE_HEADER */
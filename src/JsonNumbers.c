@@ -0,0 +1,277 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Class.h"
+#include "JsonToken.h"
+#include "JsonLexer.h"
+#include "JsonNumbers.h"
+
+
+
+
+/**
+ * Most significant digits a double holds exactly
+ */
+#define JSON_NUMBERS_MAX_EXACT_DIGITS 15
+
+
+/**
+ * Largest power of ten a double holds exactly
+ */
+#define JSON_NUMBERS_MAX_EXACT_EXPONENT 22
+
+
+/**
+ * Most digits an integer is read with before overflowing, depending on the width of longs
+ */
+#define JSON_NUMBERS_MAX_INTEGER_DIGITS ((sizeof(JsonIntegerValue) > 4) ? JSON_NUMBERS_MAX_EXACT_DIGITS : 9)
+
+
+/**
+ * Longest number converted from a buffer on the stack by the C library
+ */
+#define JSON_NUMBERS_MAX_BUFFERED_LENGTH 63
+
+
+/**
+ * Powers of ten held exactly by a double
+ */
+static double const powersOfTen[JSON_NUMBERS_MAX_EXACT_EXPONENT + 1] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+
+
+
+/**
+ * Reads a run of digits, four at a time
+ *
+ * @param digits - the digits
+ * @param count - the number of digits
+ *
+ * @return - the value of the digits, as a double to hold up to 15 digits exactly
+ */
+static double __readDigits(char const * digits, unsigned int count);
+
+
+/**
+ * Reads four digits at once, each byte of a word holding one of them
+ *
+ * @param digits - the four digits
+ *
+ * @return - the value of the digits
+ */
+static unsigned long __readFourDigits(char const * digits);
+
+
+/**
+ * Converts a float token with a single exact multiplication or division, when its digits and exponent allow it
+ *
+ * @param lexeme - the token
+ * @param value - where to store the value
+ *
+ * @return - 0 on success, -1 if the token must be left to the C library
+ */
+static int __convertExactFloat(JsonLexeme const * lexeme, JsonFloatValue * value);
+
+
+/**
+ * Converts a number with the C library, from a terminated copy of its characters
+ *
+ * @param lexeme - the token
+ * @param isFloat - whether to convert to a float rather than to an integer
+ * @param integer - where to store the value of an integer
+ * @param floating - where to store the value of a float
+ *
+ * @return - 0 on success, -1 if the number is too long for the stack and can't be copied
+ */
+static int __convertWithLibrary(JsonLexeme const * lexeme, int isFloat, JsonIntegerValue * integer, JsonFloatValue * floating);
+
+
+
+
+static int convertIntegers(JsonLexeme const * lexemes, unsigned int count, JsonIntegerValue * values)
+{
+    unsigned int index;
+    unsigned int isNegative;
+    unsigned int digitsCount;
+
+    for (index = 0; index < count; index++) {
+        isNegative = (lexemes[index].start[0] == '-');
+        digitsCount = lexemes[index].length - isNegative;
+
+        if (digitsCount > JSON_NUMBERS_MAX_INTEGER_DIGITS) {
+            if (__convertWithLibrary(& lexemes[index], 0, & values[index], NULL) != 0) {
+                return -1;
+            }
+            continue;
+        }
+
+        values[index] = (JsonIntegerValue) __readDigits(lexemes[index].start + isNegative, digitsCount);
+        values[index] = isNegative ? - values[index] : values[index];
+    }
+
+    return 0;
+}
+
+
+static int convertFloats(JsonLexeme const * lexemes, unsigned int count, JsonFloatValue * values)
+{
+    unsigned int index;
+
+    for (index = 0; index < count; index++) {
+        if ((__convertExactFloat(& lexemes[index], & values[index]) != 0) && (__convertWithLibrary(& lexemes[index], 1, NULL, & values[index]) != 0)) {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+
+
+
+static double __readDigits(char const * digits, unsigned int count)
+{
+    double value = 0;
+    unsigned int index = 0;
+
+    for (; index + 4 <= count; index += 4) {
+        value = value * 10000 + __readFourDigits(digits + index);
+    }
+
+    for (; index < count; index++) {
+        value = value * 10 + (digits[index] - '0');
+    }
+
+    return value;
+}
+
+
+static unsigned long __readFourDigits(char const * digits)
+{
+    unsigned long word;
+
+    /* the first digit goes to the lowest byte, whatever the endianness */
+    word = ((unsigned long) (unsigned char) digits[0])
+        | ((unsigned long) (unsigned char) digits[1] << 8)
+        | ((unsigned long) (unsigned char) digits[2] << 16)
+        | ((unsigned long) (unsigned char) digits[3] << 24);
+    word -= 0x30303030UL;
+
+    /* pairs of digits, then the pair of pairs, are combined in parallel */
+    word = ((word * 10) + (word >> 8)) & 0x00FF00FFUL;
+    word = ((word * 100) + (word >> 16)) & 0x0000FFFFUL;
+
+    return word;
+}
+
+
+static int __convertExactFloat(JsonLexeme const * lexeme, JsonFloatValue * value)
+{
+    char const * character = lexeme->start;
+    char const * end = lexeme->start + lexeme->length;
+    char const * integerStart;
+    char const * fractionStart = NULL;
+    unsigned int integerCount;
+    unsigned int fractionCount = 0;
+    int exponent = 0;
+    int exponentSign = 1;
+    int isNegative = (* character == '-');
+    double mantissa;
+
+    character += isNegative;
+    integerStart = character;
+    while ((character < end) && (* character >= '0') && (* character <= '9')) {
+        character++;
+    }
+    integerCount = character - integerStart;
+
+    /* a lone zero isn't a significant digit */
+    if ((integerCount == 1) && (* integerStart == '0')) {
+        integerCount = 0;
+    }
+
+    if ((character < end) && (* character == '.')) {
+        fractionStart = ++character;
+        while ((character < end) && (* character >= '0') && (* character <= '9')) {
+            character++;
+        }
+        fractionCount = character - fractionStart;
+    }
+
+    if ((character < end) && ((* character == 'e') || (* character == 'E'))) {
+        character++;
+        if ((* character == '-') || (* character == '+')) {
+            exponentSign = (* character == '-') ? -1 : 1;
+            character++;
+        }
+        for (; character < end; character++) {
+            if (exponent > 1000) {
+                return -1;
+            }
+            exponent = exponent * 10 + (* character - '0');
+        }
+    }
+
+    /* the fraction digits are read as part of the mantissa, the exponent making up for them */
+    exponent = exponentSign * exponent - (int) fractionCount;
+    if ((integerCount + fractionCount > JSON_NUMBERS_MAX_EXACT_DIGITS) || (exponent > JSON_NUMBERS_MAX_EXACT_EXPONENT) || (exponent < - JSON_NUMBERS_MAX_EXACT_EXPONENT)) {
+        return -1;
+    }
+
+    mantissa = __readDigits(integerStart, integerCount);
+    if (fractionCount > 0) {
+        mantissa = mantissa * powersOfTen[fractionCount] + __readDigits(fractionStart, fractionCount);
+    }
+
+    * value = (exponent >= 0) ? mantissa * powersOfTen[exponent] : mantissa / powersOfTen[- exponent];
+    * value = isNegative ? - * value : * value;
+
+    return 0;
+}
+
+
+static int __convertWithLibrary(JsonLexeme const * lexeme, int isFloat, JsonIntegerValue * integer, JsonFloatValue * floating)
+{
+    char buffer[JSON_NUMBERS_MAX_BUFFERED_LENGTH + 1];
+    char * number = buffer;
+    size_t length = lexeme->length;
+
+    /* a truncated copy would convert to another value, so longer numbers are only converted from a full copy */
+    if (length > JSON_NUMBERS_MAX_BUFFERED_LENGTH) {
+        number = Class->new("JsonString", length + 1);
+        if (number == NULL) {
+            return -1;
+        }
+    }
+
+    memcpy(number, lexeme->start, length);
+    number[length] = '\0';
+
+    if (isFloat) {
+        * floating = strtod(number, NULL);
+    } else {
+        * integer = strtol(number, NULL, 10);
+    }
+
+    if (number != buffer) {
+        Class->delete((void **) & number);
+    }
+
+    return 0;
+}
+
+
+
+
+/**
+ * Init JsonNumbers methods table
+ */
+static _JsonNumbersMethods methods = {
+    convertIntegers,
+    convertFloats
+};
+_JsonNumbersMethods const * const _JsonNumbers = & methods;
@@ -0,0 +1,81 @@
+#ifndef JSON_NUMBERS_HEADER
+#define JSON_NUMBERS_HEADER
+
+#include "JsonToken.h"
+#include "JsonLexer.h"
+
+
+
+
+/**
+ * Number of numbers converted at once by callers gathering them (@see Json.getNumbers)
+ */
+#define JSON_NUMBERS_BATCH_SIZE 64
+
+
+
+
+/**
+ * A number of a json, tagged with its type
+ */
+typedef struct
+{
+    /**
+     * JSON_TOKEN_INTEGER or JSON_TOKEN_FLOAT
+     */
+    JsonTokenType type;
+
+    /**
+     * The value of the number, asInteger or asFloat depending on its type
+     */
+    JsonValue value;
+
+} JsonNumber;
+
+
+
+
+/**
+ * JsonNumbers methods table
+ * Converts numbers recorded by the lexer in bulk, once the whole json-string is read
+ * Digits are read four at a time, and floats of at most 15 significant digits and exponents within 22
+ * are scaled with a single exact operation, other numbers being left to the C library
+ */
+typedef struct
+{
+    /**
+     * Converts integer tokens, integers out of range saturating as with strtol
+     *
+     * @param lexemes - the integer tokens, which must be valid
+     * @param count - the number of tokens
+     * @param values - where to store the value of each token
+     *
+     * @return - 0 on success, -1 if a number too long for the stack can't be copied
+     */
+    int (* convertIntegers)(JsonLexeme const * lexemes, unsigned int count, JsonIntegerValue * values);
+
+    /**
+     * Converts integer and float tokens to floats
+     *
+     * @param lexemes - the number tokens, which must be valid
+     * @param count - the number of tokens
+     * @param values - where to store the value of each token, the same as strtod would convert to
+     *
+     * @return - 0 on success, -1 if a number too long for the stack can't be copied
+     */
+    int (* convertFloats)(JsonLexeme const * lexemes, unsigned int count, JsonFloatValue * values);
+
+} _JsonNumbersMethods;
+
+
+
+
+/**
+ * JsonNumbers class methods table
+ */
+extern _JsonNumbersMethods const * const _JsonNumbers;
+
+
+
+
+#endif /* JSON_NUMBERS_HEADER */
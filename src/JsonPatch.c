@@ -0,0 +1,325 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Class.h"
+#include "JsonNode.h"
+#include "JsonPatch.h"
+
+
+
+
+/**
+ * Applies a single operation of a json patch
+ *
+ * @param root - pointer to the root of the tree to patch
+ * @param operation - the operation object
+ *
+ * @return - 0 on success, -1 on failure
+ */
+static int __applyOperation(JsonNode ** root, JsonNode const * const operation);
+
+
+/**
+ * Adds a value at a path, as the add operation does
+ *
+ * @param root - pointer to the root of the tree to patch
+ * @param path - the json pointer to add the value at
+ * @param value - the value, shared with the tree on success
+ *
+ * @return - 0 on success, -1 on failure
+ */
+static int __add(JsonNode ** root, char const * const path, JsonNode * value);
+
+
+/**
+ * Returns the string member of an operation
+ *
+ * @param operation - the operation object
+ * @param key - the key of the member
+ *
+ * @return - the string, NULL if there's no such string member
+ */
+static char const * __stringMember(JsonNode const * const operation, char const * const key);
+
+
+/**
+ * Merges a merge patch into a node
+ *
+ * @param target - pointer to the node to patch, replaced if the patch replaces it
+ * @param patch - the merge patch
+ *
+ * @return - 0 on success, -1 on allocation failure
+ */
+static int __merge(JsonNode ** target, JsonNode const * const patch);
+
+
+/**
+ * Builds the json pointer to a member of the root
+ *
+ * @param key - the key of the member
+ *
+ * @return - the json pointer, NULL if allocation fails
+ */
+static char * __memberPath(char const * const key);
+
+
+
+
+static int apply(JsonNode ** root, JsonNode const * const patch, unsigned int * failedIndex)
+{
+    JsonNode * working;
+    unsigned int index;
+
+    if (failedIndex != NULL) {
+        * failedIndex = 0;
+    }
+
+    if (_JsonNode->getType(patch) != JSON_NODE_ARRAY) {
+        return -1;
+    }
+
+    working = _JsonNode->retain(* root);
+
+    for (index = 0; index < _JsonNode->size(patch); index++) {
+        if (__applyOperation(& working, _JsonNode->getChild(patch, index)) != 0) {
+            _JsonNode->delete(& working);
+            if (failedIndex != NULL) {
+                * failedIndex = index;
+            }
+            return -1;
+        }
+    }
+
+    _JsonNode->delete(root);
+    * root = working;
+
+    return 0;
+}
+
+
+static int merge(JsonNode ** root, JsonNode const * const patch)
+{
+    JsonNode * working = _JsonNode->retain(* root);
+
+    if (__merge(& working, patch) != 0) {
+        _JsonNode->delete(& working);
+        return -1;
+    }
+
+    _JsonNode->delete(root);
+    * root = working;
+
+    return 0;
+}
+
+
+
+
+static int __applyOperation(JsonNode ** root, JsonNode const * const operation)
+{
+    char const * type = __stringMember(operation, "op");
+    char const * path = __stringMember(operation, "path");
+    char const * from = __stringMember(operation, "from");
+    JsonNode * value = NULL;
+    JsonNode const * target;
+    unsigned int fromLength;
+
+    if ((type == NULL) || (path == NULL)) {
+        return -1;
+    }
+
+    if (strcmp(type, "remove") == 0) {
+        return _JsonNode->remove(root, path);
+    }
+
+    if ((strcmp(type, "move") == 0) || (strcmp(type, "copy") == 0)) {
+        if (from == NULL) {
+            return -1;
+        }
+        value = _JsonNode->get(* root, from);
+    } else {
+        value = _JsonNode->getMember(operation, "value");
+    }
+
+    if (value == NULL) {
+        return -1;
+    }
+
+    if (strcmp(type, "add") == 0) {
+        return __add(root, path, value);
+    }
+
+    if (strcmp(type, "replace") == 0) {
+        if (_JsonNode->get(* root, path) == NULL) {
+            return -1;
+        }
+        _JsonNode->retain(value);
+        if (_JsonNode->set(root, path, value) != 0) {
+            _JsonNode->delete(& value);
+            return -1;
+        }
+        return 0;
+    }
+
+    if (strcmp(type, "copy") == 0) {
+        return __add(root, path, value);
+    }
+
+    if (strcmp(type, "move") == 0) {
+        if (strcmp(from, path) == 0) {
+            return 0;
+        }
+
+        /* a value can't be moved into itself */
+        fromLength = strlen(from);
+        if ((strncmp(from, path, fromLength) == 0) && (path[fromLength] == '/')) {
+            return -1;
+        }
+
+        _JsonNode->retain(value);
+        if (_JsonNode->remove(root, from) != 0) {
+            _JsonNode->delete(& value);
+            return -1;
+        }
+        if (_JsonNode->insert(root, path, value) != 0) {
+            _JsonNode->delete(& value);
+            return -1;
+        }
+        return 0;
+    }
+
+    if (strcmp(type, "test") == 0) {
+        target = _JsonNode->get(* root, path);
+        return ((target != NULL) && _JsonNode->equals(target, value)) ? 0 : -1;
+    }
+
+    return -1;
+}
+
+
+static int __add(JsonNode ** root, char const * const path, JsonNode * value)
+{
+    _JsonNode->retain(value);
+
+    if (_JsonNode->insert(root, path, value) != 0) {
+        _JsonNode->delete(& value);
+        return -1;
+    }
+
+    return 0;
+}
+
+
+static char const * __stringMember(JsonNode const * const operation, char const * const key)
+{
+    JsonNode const * member;
+
+    if (_JsonNode->getType(operation) != JSON_NODE_OBJECT) {
+        return NULL;
+    }
+
+    member = _JsonNode->getMember(operation, key);
+    if ((member == NULL) || (_JsonNode->getType(member) != JSON_NODE_STRING)) {
+        return NULL;
+    }
+
+    return _JsonNode->asString(member);
+}
+
+
+static int __merge(JsonNode ** target, JsonNode const * const patch)
+{
+    JsonNode * replacement;
+    JsonNode * member;
+    JsonNode const * patchMember;
+    char const * key;
+    char * path;
+    unsigned int index;
+    int status = 0;
+
+    if (_JsonNode->getType(patch) != JSON_NODE_OBJECT) {
+        replacement = _JsonNode->retain((JsonNode *) patch);
+        _JsonNode->delete(target);
+        * target = replacement;
+        return 0;
+    }
+
+    if (_JsonNode->getType(* target) != JSON_NODE_OBJECT) {
+        replacement = _JsonNode->newObject();
+        if (replacement == NULL) {
+            return -1;
+        }
+        _JsonNode->delete(target);
+        * target = replacement;
+    }
+
+    for (index = 0; (status == 0) && (index < _JsonNode->size(patch)); index++) {
+        key = _JsonNode->getKey(patch, index);
+        patchMember = _JsonNode->getChild(patch, index);
+
+        path = __memberPath(key);
+        if (path == NULL) {
+            return -1;
+        }
+
+        member = _JsonNode->getMember(* target, key);
+        if (_JsonNode->getType(patchMember) == JSON_NODE_NULL) {
+            status = (member != NULL) ? _JsonNode->remove(target, path) : 0;
+        } else {
+            member = (member != NULL) ? _JsonNode->retain(member) : _JsonNode->newNull();
+            status = (member != NULL) ? __merge(& member, patchMember) : -1;
+            if ((status == 0) && (_JsonNode->set(target, path, member) != 0)) {
+                status = -1;
+            }
+            if (status != 0) {
+                _JsonNode->delete(& member);
+            }
+        }
+
+        Class->delete((void **) & path);
+    }
+
+    return status;
+}
+
+
+static char * __memberPath(char const * const key)
+{
+    char * path;
+    unsigned int keyIndex;
+    unsigned int pathIndex = 0;
+
+    /* each character takes two at worst once escaped */
+    path = Class->new("JsonString", strlen(key) * 2 + 2);
+    if (path == NULL) {
+        return NULL;
+    }
+
+    path[pathIndex++] = '/';
+    for (keyIndex = 0; key[keyIndex] != '\0'; keyIndex++) {
+        if (key[keyIndex] == '~') {
+            path[pathIndex++] = '~';
+            path[pathIndex++] = '0';
+        } else if (key[keyIndex] == '/') {
+            path[pathIndex++] = '~';
+            path[pathIndex++] = '1';
+        } else {
+            path[pathIndex++] = key[keyIndex];
+        }
+    }
+
+    return path;
+}
+
+
+
+
+/**
+ * Init JsonPatch methods table
+ */
+static _JsonPatchMethods methods = {
+    apply,
+    merge
+};
+_JsonPatchMethods const * const _JsonPatch = & methods;
@@ -0,0 +1,53 @@
+#ifndef JSON_PATCH_HEADER
+#define JSON_PATCH_HEADER
+
+#include "JsonNode.h"
+
+
+
+
+/**
+ * JsonPatch methods table
+ * Patches are applied to a copy-on-write view of the tree: only the touched paths are copied,
+ * and the tree is only replaced once the whole patch succeeds
+ * Values of the patch are shared with the patched tree rather than copied
+ */
+typedef struct
+{
+    /**
+     * Applies a json patch (RFC 6902): an array of add, remove, replace, move, copy and test operations
+     * Pointers are matched against keys as written, json escapes of keys aren't decoded
+     * test compares values structurally, strings once decoded (@see JsonNode.equals)
+     *
+     * @param root - pointer to the root of the tree to patch, replaced on success only
+     * @param patch - the array of operations
+     * @param failedIndex - where to store the index of the operation which failed, NULL to ignore it
+     *
+     * @return - 0 if every operation succeeds, -1 otherwise and the tree is left untouched
+     */
+    int (* apply)(JsonNode ** root, JsonNode const * const patch, unsigned int * failedIndex);
+
+    /**
+     * Applies a json merge patch (RFC 7386): members of the patch replace the ones of the tree, null members remove them
+     *
+     * @param root - pointer to the root of the tree to patch, replaced on success only
+     * @param patch - the merge patch
+     *
+     * @return - 0 on success, -1 on allocation failure and the tree is left untouched
+     */
+    int (* merge)(JsonNode ** root, JsonNode const * const patch);
+
+} _JsonPatchMethods;
+
+
+
+
+/**
+ * JsonPatch class methods table
+ */
+extern _JsonPatchMethods const * const _JsonPatch;
+
+
+
+
+#endif /* JSON_PATCH_HEADER */
@@ -0,0 +1,900 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <pthread.h>
+
+#include "Class.h"
+#include "JsonToken.h"
+#include "Json.h"
+#include "JsonPath.h"
+
+
+
+
+/**
+ * What a step of a query selects among the children of a value
+ */
+typedef enum
+{
+    JSON_PATH_STEP_KEY,
+    JSON_PATH_STEP_INDEX,
+    JSON_PATH_STEP_WILDCARD,
+    JSON_PATH_STEP_FILTER
+} JsonPathStepType;
+
+
+/**
+ * How a filter compares the value it reaches with its literal
+ */
+typedef enum
+{
+    JSON_PATH_EXISTS,
+    JSON_PATH_EQUAL,
+    JSON_PATH_NOT_EQUAL,
+    JSON_PATH_LESS,
+    JSON_PATH_LESS_OR_EQUAL,
+    JSON_PATH_GREATER,
+    JSON_PATH_GREATER_OR_EQUAL
+} JsonPathOperator;
+
+
+/**
+ * A compiled step of a query
+ */
+typedef struct
+{
+    /**
+     * What the step selects
+     */
+    JsonPathStepType type;
+
+    /**
+     * Whether the step applies to every descendant rather than to the children only
+     */
+    char isDescendant;
+
+    /**
+     * The offset in the expression of the key, or of the keys following the '@' of a filter
+     */
+    unsigned int start;
+
+    /**
+     * The number of characters of the key, or of the keys of a filter
+     */
+    unsigned int length;
+
+    /**
+     * The index of the selected element
+     */
+    unsigned long index;
+
+    /**
+     * How a filter compares the value it reaches
+     */
+    JsonPathOperator operator;
+
+    /**
+     * The type of the literal of a filter: JSON_TOKEN_FLOAT for any number
+     */
+    JsonTokenType literalType;
+
+    /**
+     * The offset of a string literal in the expression, without quotes
+     */
+    unsigned int literalStart;
+
+    /**
+     * The number of characters of a string literal
+     */
+    unsigned int literalLength;
+
+    /**
+     * The value of a number or boolean literal
+     */
+    JsonFloatValue number;
+
+} JsonPathStep;
+
+
+/**
+ * The matches of a query being evaluated
+ */
+typedef struct
+{
+    /**
+     * Where to store the token index of each match
+     */
+    unsigned int * indexes;
+
+    /**
+     * The number of indexes there is room for
+     */
+    unsigned int capacity;
+
+    /**
+     * The number of matches found so far
+     */
+    unsigned int count;
+
+} JsonPathMatches;
+
+
+/**
+ * The share of a batch of jsons queried by a thread
+ */
+typedef struct
+{
+    /**
+     * The query
+     */
+    JsonPath const * path;
+
+    /**
+     * The jsons of the whole batch
+     */
+    Json const * const * jsons;
+
+    /**
+     * The number of jsons of the whole batch
+     */
+    unsigned int jsonsCount;
+
+    /**
+     * Where to store the number of matches of each json
+     */
+    unsigned int * counts;
+
+    /**
+     * Where to store the token indexes of the matches, capacity per json
+     */
+    unsigned int * indexes;
+
+    /**
+     * The number of indexes there is room for per json
+     */
+    unsigned int capacity;
+
+    /**
+     * The first json of the share
+     */
+    unsigned int first;
+
+    /**
+     * The distance between two jsons of the share, the number of threads
+     */
+    unsigned int stride;
+
+} JsonPathShare;
+
+
+struct JsonPath
+{
+    /**
+     * A copy of the expression, which keys and string literals are read from
+     */
+    char * expression;
+
+    /**
+     * The compiled steps
+     */
+    JsonPathStep * steps;
+
+    /**
+     * The number of steps
+     */
+    unsigned int stepsCount;
+};
+
+
+
+
+/**
+ * Compiles the step at the given position of an expression
+ *
+ * @param expression - the expression
+ * @param position - the position of the step, moved past it
+ * @param step - where to store the compiled step
+ *
+ * @return - 0 on success, -1 if the step isn't valid
+ */
+static int __compileStep(char const * const expression, unsigned int * position, JsonPathStep * step);
+
+
+/**
+ * Compiles a step between brackets
+ *
+ * @param expression - the expression
+ * @param position - the position of the opening bracket, moved past the closing one
+ * @param step - where to store the compiled step
+ *
+ * @return - 0 on success, -1 if the step isn't valid
+ */
+static int __compileBracket(char const * const expression, unsigned int * position, JsonPathStep * step);
+
+
+/**
+ * Compiles a filter, from its '?' to its closing parenthesis
+ *
+ * @param expression - the expression
+ * @param position - the position of the '?', moved past the closing parenthesis
+ * @param step - where to store the compiled filter
+ *
+ * @return - 0 on success, -1 if the filter isn't valid
+ */
+static int __compileFilter(char const * const expression, unsigned int * position, JsonPathStep * step);
+
+
+/**
+ * Compiles the keys of a filter following its '@'
+ *
+ * @param expression - the expression
+ * @param position - the position following the '@', moved past the keys
+ *
+ * @return - 0 on success, -1 if a key is empty
+ */
+static int __compileKeys(char const * const expression, unsigned int * position);
+
+
+/**
+ * Checks if a character may be part of a key written without quotes
+ *
+ * @param character - the character to check
+ *
+ * @return - 1 if the character belongs to the key, 0 otherwise
+ */
+static int __isKeyCharacter(char character);
+
+
+/**
+ * Applies the steps from the given one to a value, recording the values reached by the last step
+ *
+ * @param this - the query
+ * @param json - the json the value belongs to
+ * @param stepIndex - the index of the step to apply
+ * @param valueIndex - the token index of the value
+ * @param matches - the matches to record into
+ */
+static void __evaluate(JsonPath const * const this, Json const * const json, unsigned int stepIndex, unsigned int valueIndex, JsonPathMatches * matches);
+
+
+/**
+ * Checks if a child of a container is selected by a step
+ *
+ * @param this - the query
+ * @param json - the json the child belongs to
+ * @param step - the step
+ * @param keyIndex - the token index of the key of the child, -1 for array elements
+ * @param valueIndex - the token index of the child
+ * @param position - the position of the child in its container
+ *
+ * @return - 1 if the child is selected, 0 otherwise
+ */
+static int __matchesStep(JsonPath const * const this, Json const * const json, JsonPathStep const * step, int keyIndex, unsigned int valueIndex, unsigned long position);
+
+
+/**
+ * Checks if a value passes a filter
+ *
+ * @param this - the query
+ * @param json - the json the value belongs to
+ * @param step - the filter
+ * @param valueIndex - the token index of the value
+ *
+ * @return - 1 if the value passes, 0 otherwise
+ */
+static int __matchesFilter(JsonPath const * const this, Json const * const json, JsonPathStep const * step, unsigned int valueIndex);
+
+
+/**
+ * Compares a token with the literal of a filter
+ *
+ * @param this - the query
+ * @param step - the filter
+ * @param token - the token reached by the filter
+ *
+ * @return - 1 if the comparison holds, 0 otherwise
+ */
+static int __compare(JsonPath const * const this, JsonPathStep const * step, JsonToken const * token);
+
+
+/**
+ * Returns the first child of a container
+ *
+ * @param json - the json the container belongs to
+ * @param containerIndex - the token index of the container
+ * @param isObject - where to store whether the container is an object
+ *
+ * @return - the token index of the key of the first member or of the first element, -1 if there's none or the value isn't a container
+ */
+static int __firstChild(Json const * const json, unsigned int containerIndex, int * isObject);
+
+
+/**
+ * Returns the child following another one, skipping the value of the other one at once
+ *
+ * @param json - the json the child belongs to
+ * @param valueIndex - the token index of the value of the child
+ *
+ * @return - the token index of the key of the next member or of the next element, -1 if there's none
+ */
+static int __nextChild(Json const * const json, unsigned int valueIndex);
+
+
+/**
+ * Finds a member of an object
+ *
+ * @param json - the json the object belongs to
+ * @param objectIndex - the token index of the object
+ * @param key - the key, as written
+ * @param length - the number of characters of the key
+ *
+ * @return - the token index of the value of the member, -1 if there's none
+ */
+static int __findMember(Json const * const json, unsigned int objectIndex, char const * const key, unsigned int length);
+
+
+/**
+ * Checks if a string token holds the given characters
+ *
+ * @param token - the string token
+ * @param characters - the characters, as written
+ * @param length - the number of characters
+ *
+ * @return - 1 if the token holds the characters, 0 otherwise
+ */
+static int __tokenIs(JsonToken const * token, char const * const characters, unsigned int length);
+
+
+/**
+ * Queries a share of a batch of jsons, run by each thread
+ *
+ * @param share - the share to query (JsonPathShare *)
+ *
+ * @return - NULL
+ */
+static void * __selectShare(void * share);
+
+
+
+
+static JsonPath * new(char const * const expression)
+{
+    JsonPath * this;
+    unsigned int stepsCapacity = 1;
+    unsigned int position;
+
+    if (expression[0] != '$') {
+        return NULL;
+    }
+
+    /* every step starts with a '.' or a '[' */
+    for (position = 0; expression[position] != '\0'; position++) {
+        if ((expression[position] == '.') || (expression[position] == '[')) {
+            stepsCapacity++;
+        }
+    }
+
+    this = Class->new("JsonPath", sizeof(* this));
+    if (this == NULL) {
+        return NULL;
+    }
+
+    this->expression = Class->new("JsonString", strlen(expression) + 1);
+    this->steps = Class->new("JsonPathStep[]", stepsCapacity * sizeof(JsonPathStep));
+    if ((this->expression == NULL) || (this->steps == NULL)) {
+        _JsonPath->delete(& this);
+        return NULL;
+    }
+    strcpy(this->expression, expression);
+
+    position = 1;
+    while (this->expression[position] != '\0') {
+        if (__compileStep(this->expression, & position, & this->steps[this->stepsCount]) != 0) {
+            _JsonPath->delete(& this);
+            return NULL;
+        }
+        this->stepsCount++;
+    }
+
+    return this;
+}
+
+
+static void delete(JsonPath ** this)
+{
+    if (* this == NULL) {
+        return;
+    }
+
+    Class->delete((void **) & (* this)->expression);
+    Class->delete((void **) & (* this)->steps);
+    Class->delete((void **) this);
+}
+
+
+static unsigned int JsonPath_select(JsonPath const * const this, Json const * const json, unsigned int * indexes, unsigned int capacity)
+{
+    JsonPathMatches matches;
+
+    matches.indexes = indexes;
+    matches.capacity = capacity;
+    matches.count = 0;
+
+    if (_Json->getTokensCount(json) > 0) {
+        __evaluate(this, json, 0, 0, & matches);
+    }
+
+    return matches.count;
+}
+
+
+static unsigned long selectBatch(JsonPath const * const this, Json const * const * jsons, unsigned int jsonsCount, unsigned int * counts, unsigned int * indexes, unsigned int capacity, unsigned int threadsCount)
+{
+    JsonPathShare share;
+    JsonPathShare * shares;
+    pthread_t * threads;
+    unsigned long matchesCount = 0;
+    unsigned int thread;
+    unsigned int index;
+
+    share.path = this;
+    share.jsons = jsons;
+    share.jsonsCount = jsonsCount;
+    share.counts = counts;
+    share.indexes = indexes;
+    share.capacity = capacity;
+    share.first = 0;
+    share.stride = (threadsCount < jsonsCount) ? threadsCount : jsonsCount;
+
+    shares = (share.stride > 1) ? Class->new("JsonPathShare[]", share.stride * sizeof(JsonPathShare)) : NULL;
+    threads = (shares != NULL) ? Class->new("pthread_t[]", share.stride * sizeof(pthread_t)) : NULL;
+    if (threads == NULL) {
+        share.stride = 1;
+    }
+
+    /* the calling thread queries the first share, and any share a thread couldn't be started for */
+    for (thread = 1; thread < share.stride; thread++) {
+        shares[thread] = share;
+        shares[thread].first = thread;
+        if (pthread_create(& threads[thread], NULL, __selectShare, & shares[thread]) != 0) {
+            __selectShare(& shares[thread]);
+            shares[thread].jsonsCount = 0;
+        }
+    }
+    __selectShare(& share);
+
+    for (thread = 1; thread < share.stride; thread++) {
+        if (shares[thread].jsonsCount != 0) {
+            pthread_join(threads[thread], NULL);
+        }
+    }
+
+    Class->delete((void **) & shares);
+    Class->delete((void **) & threads);
+
+    for (index = 0; index < jsonsCount; index++) {
+        matchesCount += counts[index];
+    }
+
+    return matchesCount;
+}
+
+
+
+
+static int __compileStep(char const * const expression, unsigned int * position, JsonPathStep * step)
+{
+    unsigned int start;
+
+    if (expression[* position] == '[') {
+        return __compileBracket(expression, position, step);
+    }
+
+    if (expression[* position] != '.') {
+        return -1;
+    }
+    (* position)++;
+
+    if (expression[* position] == '.') {
+        step->isDescendant = 1;
+        (* position)++;
+        if (expression[* position] == '[') {
+            return __compileBracket(expression, position, step);
+        }
+    }
+
+    if (expression[* position] == '*') {
+        step->type = JSON_PATH_STEP_WILDCARD;
+        (* position)++;
+        return 0;
+    }
+
+    start = * position;
+    while (__isKeyCharacter(expression[* position])) {
+        (* position)++;
+    }
+
+    step->type = JSON_PATH_STEP_KEY;
+    step->start = start;
+    step->length = * position - start;
+
+    return (step->length > 0) ? 0 : -1;
+}
+
+
+static int __compileBracket(char const * const expression, unsigned int * position, JsonPathStep * step)
+{
+    char quote = expression[++(* position)];
+
+    if (quote == '*') {
+        step->type = JSON_PATH_STEP_WILDCARD;
+        (* position)++;
+    } else if ((quote == '\'') || (quote == '"')) {
+        step->type = JSON_PATH_STEP_KEY;
+        step->start = ++(* position);
+        while (expression[* position] != quote) {
+            if (expression[* position] == '\0') {
+                return -1;
+            }
+            (* position)++;
+        }
+        step->length = * position - step->start;
+        (* position)++;
+    } else if (isdigit((unsigned char) quote)) {
+        step->type = JSON_PATH_STEP_INDEX;
+        step->index = 0;
+        while (isdigit((unsigned char) expression[* position])) {
+            step->index = step->index * 10 + (expression[* position] - '0');
+            (* position)++;
+        }
+    } else if ((quote != '?') || (__compileFilter(expression, position, step) != 0)) {
+        return -1;
+    }
+
+    if (expression[* position] != ']') {
+        return -1;
+    }
+    (* position)++;
+
+    return 0;
+}
+
+
+static int __compileFilter(char const * const expression, unsigned int * position, JsonPathStep * step)
+{
+    static char const * const operators[] = { "==", "!=", "<=", ">=", "<", ">" };
+    static JsonPathOperator const operatorValues[] = {
+        JSON_PATH_EQUAL, JSON_PATH_NOT_EQUAL, JSON_PATH_LESS_OR_EQUAL, JSON_PATH_GREATER_OR_EQUAL, JSON_PATH_LESS, JSON_PATH_GREATER
+    };
+    char * end;
+    char quote;
+    unsigned int operator;
+
+    if (strncmp(expression + * position, "?(@", 3) != 0) {
+        return -1;
+    }
+    * position += 3;
+
+    step->type = JSON_PATH_STEP_FILTER;
+    step->start = * position;
+    if (__compileKeys(expression, position) != 0) {
+        return -1;
+    }
+    step->length = * position - step->start;
+
+    while (expression[* position] == ' ') {
+        (* position)++;
+    }
+
+    step->operator = JSON_PATH_EXISTS;
+    for (operator = 0; operator < sizeof(operators) / sizeof(operators[0]); operator++) {
+        if (strncmp(expression + * position, operators[operator], strlen(operators[operator])) == 0) {
+            step->operator = operatorValues[operator];
+            * position += strlen(operators[operator]);
+            break;
+        }
+    }
+
+    while ((step->operator != JSON_PATH_EXISTS) && (expression[* position] == ' ')) {
+        (* position)++;
+    }
+
+    quote = expression[* position];
+    if (step->operator == JSON_PATH_EXISTS) {
+        /* nothing to compare with */
+    } else if ((quote == '\'') || (quote == '"')) {
+        step->literalType = JSON_TOKEN_STRING;
+        step->literalStart = ++(* position);
+        while (expression[* position] != quote) {
+            if (expression[* position] == '\0') {
+                return -1;
+            }
+            (* position)++;
+        }
+        step->literalLength = * position - step->literalStart;
+        (* position)++;
+    } else if ((strncmp(expression + * position, "true", 4) == 0) || (strncmp(expression + * position, "false", 5) == 0)) {
+        step->literalType = JSON_TOKEN_BOOLEAN;
+        step->number = (quote == 't');
+        * position += (quote == 't') ? 4 : 5;
+    } else if (strncmp(expression + * position, "null", 4) == 0) {
+        step->literalType = JSON_TOKEN_NULL;
+        * position += 4;
+    } else {
+        step->literalType = JSON_TOKEN_FLOAT;
+        step->number = strtod(expression + * position, & end);
+        if (end == expression + * position) {
+            return -1;
+        }
+        * position = end - expression;
+    }
+
+    while (expression[* position] == ' ') {
+        (* position)++;
+    }
+
+    if (expression[* position] != ')') {
+        return -1;
+    }
+    (* position)++;
+
+    return 0;
+}
+
+
+static int __compileKeys(char const * const expression, unsigned int * position)
+{
+    unsigned int start;
+
+    while (expression[* position] == '.') {
+        start = ++(* position);
+        while (__isKeyCharacter(expression[* position])) {
+            (* position)++;
+        }
+        if (* position == start) {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+
+static int __isKeyCharacter(char character)
+{
+    return isalnum((unsigned char) character) || (character == '_') || (character == '-') || (character == '$') || ((unsigned char) character >= 0x80);
+}
+
+
+static void __evaluate(JsonPath const * const this, Json const * const json, unsigned int stepIndex, unsigned int valueIndex, JsonPathMatches * matches)
+{
+    JsonPathStep const * step;
+    unsigned long position = 0;
+    int isObject;
+    int child;
+    int value;
+    int isMatch;
+
+    if (stepIndex == this->stepsCount) {
+        if (matches->count < matches->capacity) {
+            matches->indexes[matches->count] = valueIndex;
+        }
+        matches->count++;
+        return;
+    }
+
+    step = & this->steps[stepIndex];
+    child = __firstChild(json, valueIndex, & isObject);
+
+    /* children which can't match are only walked into by descendant steps */
+    if (! step->isDescendant && (((step->type == JSON_PATH_STEP_KEY) && ! isObject) || ((step->type == JSON_PATH_STEP_INDEX) && isObject))) {
+        return;
+    }
+
+    for (; child != -1; child = __nextChild(json, value), position++) {
+        value = isObject ? child + 2 : child;
+
+        isMatch = __matchesStep(this, json, step, isObject ? child : -1, value, position);
+        if (isMatch) {
+            __evaluate(this, json, stepIndex + 1, value, matches);
+        }
+
+        if (step->isDescendant) {
+            __evaluate(this, json, stepIndex, value, matches);
+        } else if (isMatch && ((step->type == JSON_PATH_STEP_KEY) || (step->type == JSON_PATH_STEP_INDEX))) {
+            return;
+        }
+    }
+}
+
+
+static int __matchesStep(JsonPath const * const this, Json const * const json, JsonPathStep const * step, int keyIndex, unsigned int valueIndex, unsigned long position)
+{
+    switch (step->type) {
+        case JSON_PATH_STEP_KEY:
+            return (keyIndex != -1) && __tokenIs(_Json->getToken(json, keyIndex), this->expression + step->start, step->length);
+        case JSON_PATH_STEP_INDEX:
+            return (keyIndex == -1) && (position == step->index);
+        case JSON_PATH_STEP_WILDCARD:
+            return 1;
+        case JSON_PATH_STEP_FILTER:
+            return __matchesFilter(this, json, step, valueIndex);
+    }
+
+    return 0;
+}
+
+
+static int __matchesFilter(JsonPath const * const this, Json const * const json, JsonPathStep const * step, unsigned int valueIndex)
+{
+    unsigned int position = step->start;
+    unsigned int end = step->start + step->length;
+    unsigned int start;
+    int target = valueIndex;
+
+    while ((position < end) && (target != -1)) {
+        start = ++position;
+        while ((position < end) && (this->expression[position] != '.')) {
+            position++;
+        }
+        target = __findMember(json, target, this->expression + start, position - start);
+    }
+
+    if (target == -1) {
+        return 0;
+    }
+
+    return (step->operator == JSON_PATH_EXISTS) || __compare(this, step, _Json->getToken(json, target));
+}
+
+
+static int __compare(JsonPath const * const this, JsonPathStep const * step, JsonToken const * token)
+{
+    JsonTokenType type = _JsonToken->getType(token);
+    char const * string;
+    unsigned int length;
+    JsonFloatValue number;
+    int order;
+
+    if ((type == JSON_TOKEN_INTEGER) || (type == JSON_TOKEN_FLOAT)) {
+        type = JSON_TOKEN_FLOAT;
+    }
+
+    /* values of different types are only different */
+    if ((type != step->literalType) || (type == JSON_TOKEN_OPERATOR)) {
+        return step->operator == JSON_PATH_NOT_EQUAL;
+    }
+
+    switch (type) {
+        case JSON_TOKEN_FLOAT:
+            number = (_JsonToken->getType(token) == JSON_TOKEN_INTEGER) ? (JsonFloatValue) _JsonToken->asInteger(token) : _JsonToken->asFloat(token);
+            order = (number < step->number) ? -1 : (number > step->number);
+            break;
+        case JSON_TOKEN_STRING:
+            string = _JsonToken->getRawString(token) + 1;
+            length = strlen(string) - 1;
+            order = memcmp(string, this->expression + step->literalStart, (length < step->literalLength) ? length : step->literalLength);
+            if (order == 0) {
+                order = (length < step->literalLength) ? -1 : (length > step->literalLength);
+            }
+            break;
+        case JSON_TOKEN_BOOLEAN:
+            order = (_JsonToken->asBoolean(token) != 0) - (step->number != 0);
+            break;
+        default:
+            order = 0;
+            break;
+    }
+
+    switch (step->operator) {
+        case JSON_PATH_EQUAL:
+            return order == 0;
+        case JSON_PATH_NOT_EQUAL:
+            return order != 0;
+        case JSON_PATH_LESS:
+            return order < 0;
+        case JSON_PATH_LESS_OR_EQUAL:
+            return order <= 0;
+        case JSON_PATH_GREATER:
+            return order > 0;
+        case JSON_PATH_GREATER_OR_EQUAL:
+            return order >= 0;
+        default:
+            return 1;
+    }
+}
+
+
+static int __firstChild(Json const * const json, unsigned int containerIndex, int * isObject)
+{
+    JsonToken const * token = _Json->getToken(json, containerIndex);
+    JsonOperatorValue operator;
+
+    * isObject = 0;
+    if (_JsonToken->getType(token) != JSON_TOKEN_OPERATOR) {
+        return -1;
+    }
+
+    operator = _JsonToken->asOperator(token);
+    * isObject = (operator == JSON_OPERATOR_OBJECT_START);
+    if ((! * isObject) && (operator != JSON_OPERATOR_ARRAY_START)) {
+        return -1;
+    }
+
+    /* an empty container matches itself with the following token */
+    if ((unsigned int) _Json->getMatchingIndex(json, containerIndex) == containerIndex + 1) {
+        return -1;
+    }
+
+    return containerIndex + 1;
+}
+
+
+static int __nextChild(Json const * const json, unsigned int valueIndex)
+{
+    unsigned int following = _Json->getMatchingIndex(json, valueIndex) + 1;
+    JsonToken const * token = _Json->getToken(json, following);
+
+    if ((token != NULL) && (_JsonToken->getType(token) == JSON_TOKEN_OPERATOR) && (_JsonToken->asOperator(token) == JSON_OPERATOR_COMMA)) {
+        return following + 1;
+    }
+
+    return -1;
+}
+
+
+static int __findMember(Json const * const json, unsigned int objectIndex, char const * const key, unsigned int length)
+{
+    int isObject;
+    int child = __firstChild(json, objectIndex, & isObject);
+
+    if (! isObject) {
+        return -1;
+    }
+
+    for (; child != -1; child = __nextChild(json, child + 2)) {
+        if (__tokenIs(_Json->getToken(json, child), key, length)) {
+            return child + 2;
+        }
+    }
+
+    return -1;
+}
+
+
+static void * __selectShare(void * share)
+{
+    JsonPathShare const * this = share;
+    unsigned int index;
+
+    for (index = this->first; index < this->jsonsCount; index += this->stride) {
+        this->counts[index] = _JsonPath->select(this->path, this->jsons[index], this->indexes + (unsigned long) index * this->capacity, this->capacity);
+    }
+
+    return NULL;
+}
+
+
+static int __tokenIs(JsonToken const * token, char const * const characters, unsigned int length)
+{
+    char const * string = _JsonToken->getRawString(token);
+
+    return (strlen(string) == length + 2) && (memcmp(string + 1, characters, length) == 0);
+}
+
+
+
+
+/**
+ * Init JsonPath methods table
+ */
+static _JsonPathMethods methods = {
+    new,
+    delete,
+    JsonPath_select,
+    selectBatch
+};
+_JsonPathMethods const * const _JsonPath = & methods;
@@ -0,0 +1,85 @@
+#ifndef JSON_PATH_HEADER
+#define JSON_PATH_HEADER
+
+#include "Json.h"
+
+
+
+
+/**
+ * A compiled JSONPath query
+ */
+typedef struct JsonPath JsonPath;
+
+
+
+
+/**
+ * JsonPath methods table
+ * Queries are compiled once and evaluated over the tokens of any number of jsons, without allocating
+ * Supported steps are ".key", "['key']", "[n]", "[*]", ".*", ".." before any of them,
+ * and filters "[?(@.key)]" or "[?(@.key <op> literal)]" with ==, !=, <, <=, >, >= against numbers, 'strings', true, false and null
+ * Keys and strings are compared as written, json escapes aren't decoded
+ */
+typedef struct
+{
+    /**
+     * Constructor, compiles a query
+     *
+     * @param expression - the query, starting with "$"
+     *
+     * @return - a JsonPath instance if the query is valid and allocation succeeds, NULL otherwise
+     */
+    JsonPath * (* new)(char const * const expression);
+
+    /**
+     * Destructor
+     *
+     * @param this - pointer to the instance to delete
+     */
+    void (* delete)(JsonPath ** this);
+
+    /**
+     * Finds the values matching the query, in document order
+     * Containers which can't hold a match are skipped at once through their matching bracket
+     *
+     * @param this - the query
+     * @param json - the json to query
+     * @param indexes - where to store the token index of each matching value (@see Json.getToken)
+     * @param capacity - the number of indexes there is room for, further matches are only counted
+     *
+     * @return - the number of matching values
+     */
+    unsigned int (* select)(JsonPath const * const this, Json const * const json, unsigned int * indexes, unsigned int capacity);
+
+    /**
+     * Finds the values matching the query in each of many jsons, spreading the jsons over several threads
+     * The jsons must be frozen (@see Json.freeze), the query is only read
+     * If threads can't be started, their jsons are queried by the calling thread
+     *
+     * @param this - the query
+     * @param jsons - the jsons to query
+     * @param jsonsCount - the number of jsons
+     * @param counts - where to store the number of matching values of each json
+     * @param indexes - where to store the token indexes of the matches, capacity indexes per json, those of json i starting at indexes + i * capacity
+     * @param capacity - the number of indexes there is room for per json, further matches are only counted
+     * @param threadsCount - the number of threads to query with, the calling thread being one of them
+     *
+     * @return - the number of matching values of every json
+     */
+    unsigned long (* selectBatch)(JsonPath const * const this, Json const * const * jsons, unsigned int jsonsCount, unsigned int * counts, unsigned int * indexes, unsigned int capacity, unsigned int threadsCount);
+
+} _JsonPathMethods;
+
+
+
+
+/**
+ * JsonPath class methods table
+ */
+extern _JsonPathMethods const * const _JsonPath;
+
+
+
+
+#endif /* JSON_PATH_HEADER */
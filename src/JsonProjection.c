@@ -0,0 +1,434 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "JsonToken.h"
+#include "JsonLexer.h"
+#include "LinkedList.h"
+#include "JsonStats.h"
+#include "JsonProjection.h"
+
+
+
+
+/**
+ * Position of a path which doesn't match the current member
+ */
+#define PATH_MISMATCH ((unsigned int) -1)
+
+
+/**
+ * Returned once every path was found, to stop reading
+ */
+#define PROJECTION_COMPLETE 1
+
+
+/**
+ * State of an extraction
+ */
+typedef struct
+{
+    /**
+     * The json-string being read
+     */
+    char const * string;
+
+    /**
+     * The length of the json-string
+     */
+    size_t length;
+
+    /**
+     * The offset of the next character to read
+     */
+    size_t offset;
+
+    /**
+     * The requested paths
+     */
+    char const * const * paths;
+
+    /**
+     * The number of requested paths
+     */
+    unsigned int pathsCount;
+
+    /**
+     * Whether each path was found
+     */
+    char found[JSON_PROJECTION_MAX_PATHS];
+
+    /**
+     * The number of paths found
+     */
+    unsigned int foundCount;
+
+    /**
+     * The pool tokens are taken from
+     */
+    Pool * tokenPool;
+
+    /**
+     * The pool list elements are taken from
+     */
+    Pool * nodePool;
+
+    /**
+     * Whether numbers are converted on first access
+     */
+    int lazyNumbers;
+
+    /**
+     * The extracted tokens
+     */
+    LinkedList * tokens;
+
+    /**
+     * The last extracted token, to append in constant time
+     */
+    LinkedList * lastToken;
+
+} Projection;
+
+
+
+
+/**
+ * Creates a token and appends it to the extracted ones
+ * 
+ * @param this - the extraction
+ * @param start - the first character of the token
+ * @param length - the number of characters of the token
+ * 
+ * @return - 0 on success, -1 on failure
+ */
+static int __appendToken(Projection * const this, char const * const start, size_t length);
+
+
+/**
+ * Deletes the extracted tokens and their list
+ * 
+ * @param this - the extraction
+ */
+static void __deleteTokens(Projection * const this);
+
+
+/**
+ * Reads the next token, without moving past it
+ * 
+ * @param this - the extraction
+ * @param lexeme - where to store the token
+ * 
+ * @return - 1 if a token was read, 0 or -1 otherwise (@see JsonLexer.next)
+ */
+static int __peek(Projection const * const this, JsonLexeme * lexeme);
+
+
+/**
+ * Extracts every token of the value following the offset
+ * 
+ * @param this - the extraction
+ * 
+ * @return - 0 on success, -1 on failure
+ */
+static int __copyValue(Projection * const this);
+
+
+/**
+ * Extracts the members of the object following the offset which match the paths
+ * 
+ * @param this - the extraction
+ * @param positions - for each path, the position of its next segment, or PATH_MISMATCH
+ * 
+ * @return - 0 on success, PROJECTION_COMPLETE once every path was found, -1 on failure
+ */
+static int __projectObject(Projection * const this, unsigned int const * positions);
+
+
+/**
+ * Checks if the segment of the path at the position is the member key, and returns the position of the next one
+ * 
+ * @param path - the path to check
+ * @param position - the position of the segment, or PATH_MISMATCH
+ * @param key - the member key token, with quotes
+ * 
+ * @return - the position after the segment, PATH_MISMATCH if it doesn't match
+ */
+static unsigned int __matchSegment(char const * const path, unsigned int position, JsonLexeme const * const key);
+
+
+
+
+static int extractTokens(char const * const string, size_t length, char const * const * paths, unsigned int pathsCount, Pool * const tokenPool, Pool * const nodePool, int lazyNumbers, LinkedList ** tokens)
+{
+    Projection this;
+    unsigned int positions[JSON_PROJECTION_MAX_PATHS];
+    unsigned int pathIndex;
+    JsonLexeme lexeme;
+    int status = 0;
+
+    * tokens = NULL;
+
+    if ((string == NULL) || (pathsCount > JSON_PROJECTION_MAX_PATHS)) {
+        return -1;
+    }
+
+    memset(& this, 0, sizeof(this));
+    this.string = string;
+    this.length = length;
+    this.paths = paths;
+    this.pathsCount = pathsCount;
+    this.tokenPool = tokenPool;
+    this.nodePool = nodePool;
+    this.lazyNumbers = lazyNumbers;
+
+    for (pathIndex = 0; pathIndex < pathsCount; pathIndex++) {
+        positions[pathIndex] = 0;
+        if (paths[pathIndex][0] == '\0') {
+            break;
+        }
+    }
+
+    if (pathIndex < pathsCount) {
+        /* the whole json is requested */
+        status = __copyValue(& this);
+    } else if ((pathsCount > 0) && (__peek(& this, & lexeme) == 1) && (lexeme.start[0] == JSON_OPERATOR_OBJECT_START)) {
+        status = __projectObject(& this, positions);
+    }
+
+    if (status == -1) {
+        __deleteTokens(& this);
+        return -1;
+    }
+
+    * tokens = this.tokens;
+
+    return 0;
+}
+
+
+
+
+static int __appendToken(Projection * const this, char const * const start, size_t length)
+{
+    JsonToken * token;
+    LinkedList * element;
+
+    token = _JsonToken->newInPool(this->tokenPool, start, length, this->lazyNumbers);
+    if (token == NULL) {
+        return -1;
+    }
+    JSON_STATS_TOKEN(token);
+
+    element = _LinkedList->newInPool(this->nodePool, token);
+    if (element == NULL) {
+        _JsonToken->deleteInPool(this->tokenPool, & token);
+        return -1;
+    }
+
+    _LinkedList->append(& this->lastToken, element);
+    this->lastToken = element;
+    if (this->tokens == NULL) {
+        this->tokens = element;
+    }
+
+    return 0;
+}
+
+
+static void __deleteTokens(Projection * const this)
+{
+    LinkedList * element;
+    JsonToken * token;
+
+    for (element = this->tokens; element != NULL; element = _LinkedList->nextElement(element)) {
+        token = _LinkedList->getContent(element);
+        _JsonToken->deleteInPool(this->tokenPool, & token);
+    }
+
+    _LinkedList->deleteInPool(this->nodePool, & this->tokens);
+    this->lastToken = NULL;
+}
+
+
+static int __peek(Projection const * const this, JsonLexeme * lexeme)
+{
+    size_t offset = this->offset;
+
+    return _JsonLexer->next(this->string, this->length, & offset, lexeme);
+}
+
+
+static int __copyValue(Projection * const this)
+{
+    JsonLexeme lexeme;
+    unsigned int depth = 0;
+
+    do {
+        if (_JsonLexer->next(this->string, this->length, & this->offset, & lexeme) != 1) {
+            return -1;
+        }
+
+        if (__appendToken(this, lexeme.start, lexeme.length) != 0) {
+            return -1;
+        }
+
+        if (lexeme.type == JSON_TOKEN_OPERATOR) {
+            if ((lexeme.start[0] == JSON_OPERATOR_OBJECT_START) || (lexeme.start[0] == JSON_OPERATOR_ARRAY_START)) {
+                depth++;
+            } else if ((lexeme.start[0] == JSON_OPERATOR_OBJECT_END) || (lexeme.start[0] == JSON_OPERATOR_ARRAY_END)) {
+                if (depth == 0) {
+                    return -1;
+                }
+                depth--;
+            } else if (depth == 0) {
+                return -1;
+            }
+        }
+    } while (depth > 0);
+
+    return 0;
+}
+
+
+static int __projectObject(Projection * const this, unsigned int const * positions)
+{
+    unsigned int childPositions[JSON_PROJECTION_MAX_PATHS];
+    unsigned int pathIndex;
+    unsigned int membersCount = 0;
+    int isRequested;
+    int isAncestor;
+    int status;
+    JsonLexeme key;
+    JsonLexeme lexeme;
+
+    /* the opening curly brace was peeked by the caller */
+    _JsonLexer->next(this->string, this->length, & this->offset, & lexeme);
+    if (__appendToken(this, lexeme.start, lexeme.length) != 0) {
+        return -1;
+    }
+
+    if ((__peek(this, & lexeme) == 1) && (lexeme.start[0] == JSON_OPERATOR_OBJECT_END)) {
+        _JsonLexer->next(this->string, this->length, & this->offset, & lexeme);
+        return __appendToken(this, "}", 1);
+    }
+
+    for (;;) {
+        if ((_JsonLexer->next(this->string, this->length, & this->offset, & key) != 1) || (key.type != JSON_TOKEN_STRING)) {
+            return -1;
+        }
+        if ((_JsonLexer->next(this->string, this->length, & this->offset, & lexeme) != 1) || (lexeme.start[0] != JSON_OPERATOR_COLON)) {
+            return -1;
+        }
+
+        isRequested = 0;
+        isAncestor = 0;
+        for (pathIndex = 0; pathIndex < this->pathsCount; pathIndex++) {
+            childPositions[pathIndex] = PATH_MISMATCH;
+            if (this->found[pathIndex]) {
+                continue;
+            }
+
+            childPositions[pathIndex] = __matchSegment(this->paths[pathIndex], positions[pathIndex], & key);
+            if (childPositions[pathIndex] == PATH_MISMATCH) {
+                continue;
+            }
+
+            if (this->paths[pathIndex][childPositions[pathIndex]] == '\0') {
+                this->found[pathIndex] = 1;
+                this->foundCount++;
+                isRequested = 1;
+            } else {
+                isAncestor = 1;
+            }
+        }
+
+        if (isRequested) {
+            /* deeper paths are copied along with the requested value */
+            for (pathIndex = 0; pathIndex < this->pathsCount; pathIndex++) {
+                if ((childPositions[pathIndex] != PATH_MISMATCH) && ! this->found[pathIndex]) {
+                    this->found[pathIndex] = 1;
+                    this->foundCount++;
+                }
+            }
+        }
+
+        if (__peek(this, & lexeme) != 1) {
+            return -1;
+        }
+        if (! isRequested && (lexeme.start[0] != JSON_OPERATOR_OBJECT_START)) {
+            isAncestor = 0;
+        }
+
+        if (isRequested || isAncestor) {
+            if ((membersCount > 0) && (__appendToken(this, ",", 1) != 0)) {
+                return -1;
+            }
+            if ((__appendToken(this, key.start, key.length) != 0) || (__appendToken(this, ":", 1) != 0)) {
+                return -1;
+            }
+            membersCount++;
+        }
+
+        if (isRequested) {
+            status = __copyValue(this);
+        } else if (isAncestor) {
+            status = __projectObject(this, childPositions);
+        } else {
+            status = _JsonLexer->skipValue(this->string, this->length, & this->offset);
+        }
+
+        if (status == -1) {
+            return -1;
+        }
+        if ((status == PROJECTION_COMPLETE) || (this->foundCount == this->pathsCount)) {
+            if (__appendToken(this, "}", 1) != 0) {
+                return -1;
+            }
+            return PROJECTION_COMPLETE;
+        }
+
+        if (_JsonLexer->next(this->string, this->length, & this->offset, & lexeme) != 1) {
+            return -1;
+        }
+        if (lexeme.start[0] == JSON_OPERATOR_OBJECT_END) {
+            return __appendToken(this, "}", 1);
+        }
+        if (lexeme.start[0] != JSON_OPERATOR_COMMA) {
+            return -1;
+        }
+    }
+}
+
+
+static unsigned int __matchSegment(char const * const path, unsigned int position, JsonLexeme const * const key)
+{
+    size_t keyLength = key->length - 2;
+
+    if ((position == PATH_MISMATCH) || (path[position] != '/')) {
+        return PATH_MISMATCH;
+    }
+    position++;
+
+    if (strncmp(path + position, key->start + 1, keyLength) != 0) {
+        return PATH_MISMATCH;
+    }
+    position += keyLength;
+
+    if ((path[position] != '/') && (path[position] != '\0')) {
+        return PATH_MISMATCH;
+    }
+
+    return position;
+}
+
+
+
+
+/**
+ * Init JsonProjection methods table
+ */
+static _JsonProjectionMethods methods = {
+    extractTokens
+};
+_JsonProjectionMethods const * const _JsonProjection = & methods;
@@ -0,0 +1,53 @@
+#ifndef JSON_PROJECTION_HEADER
+#define JSON_PROJECTION_HEADER
+
+#include "LinkedList.h"
+
+
+
+
+/**
+ * Maximum number of paths a projection may request
+ */
+#define JSON_PROJECTION_MAX_PATHS 32
+
+
+
+
+/**
+ * JsonProjection methods table
+ */
+typedef struct
+{
+    /**
+     * Extracts the tokens of the requested paths and of their ancestors only
+     * Paths are json pointers through object members ("/user/country"), "" being the whole json
+     * Other members are skipped without creating tokens, and reading stops once every path is found
+     * 
+     * @param string - the json-string to read from, doesn't need to be NUL-terminated
+     * @param length - the length of the json-string
+     * @param paths - the paths to extract
+     * @param pathsCount - the number of paths, up to JSON_PROJECTION_MAX_PATHS
+     * @param tokenPool - the pool to take tokens from, NULL to allocate them one by one
+     * @param nodePool - the pool to take list elements from, NULL to allocate them one by one
+     * @param lazyNumbers - whether numbers are converted on first access rather than on creation
+     * @param tokens - where to store the list of extracted tokens, NULL if none was found
+     * 
+     * @return - 0 on success, -1 if the json is malformed or allocation failed
+     */
+    int (* extractTokens)(char const * const string, size_t length, char const * const * paths, unsigned int pathsCount, Pool * const tokenPool, Pool * const nodePool, int lazyNumbers, LinkedList ** tokens);
+
+} _JsonProjectionMethods;
+
+
+
+
+/**
+ * JsonProjection class methods table
+ */
+extern _JsonProjectionMethods const * const _JsonProjection;
+
+
+
+
+#endif /* JSON_PROJECTION_HEADER */
@@ -0,0 +1,790 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "Class.h"
+#include "JsonToken.h"
+#include "JsonLexer.h"
+#include "JsonNumbers.h"
+#include "JsonGrammar.h"
+#include "JsonKeys.h"
+#include "JsonSax.h"
+
+
+
+
+/**
+ * Number of characters read at once from a file
+ */
+#define JSON_SAX_CHUNK_SIZE 65536
+
+
+/**
+ * Number of characters of a regular file mapped at once
+ */
+#define JSON_SAX_MAP_WINDOW_SIZE (1 << 24)
+
+
+/**
+ * Number of chunks a file which can't be mapped is read ahead by
+ */
+#define JSON_SAX_RING_SIZE 4
+
+
+/**
+ * Number of characters of the next chunk first appended to a carried token, doubled until the token is complete
+ */
+#define JSON_SAX_CARRY_STEP 64
+
+
+
+
+/**
+ * Buffers filled by a reader thread while the parsing thread feeds the previous ones
+ */
+typedef struct
+{
+    /**
+     * The source the reader thread decodes from
+     */
+    JsonSaxSource const * source;
+
+    /**
+     * The buffers, one after the other
+     */
+    char * buffers;
+
+    /**
+     * The number of characters read into each buffer, 0 at the end of the json-string, -1 on failure
+     */
+    int * lengths;
+
+    /**
+     * The number of buffers
+     */
+    unsigned int buffersCount;
+
+    /**
+     * The size of each buffer
+     */
+    unsigned int bufferSize;
+
+    /**
+     * The number of buffers filled so far, the next one to fill being at this count modulo buffersCount
+     */
+    unsigned long filledCount;
+
+    /**
+     * The number of buffers fed so far, the next one to feed being at this count modulo buffersCount
+     */
+    unsigned long fedCount;
+
+    /**
+     * Whether the parse is over, so that the reader thread stops
+     */
+    int isOver;
+
+    /**
+     * Guards the counts and isOver
+     */
+    pthread_mutex_t mutex;
+
+    /**
+     * Signaled when a buffer is filled
+     */
+    pthread_cond_t filled;
+
+    /**
+     * Signaled when a buffer is fed, or the parse is over
+     */
+    pthread_cond_t fed;
+
+} JsonSaxRing;
+
+
+
+
+/**
+ * Fills the buffers of a ring from its source, waiting while they are all full, run by the reader thread
+ *
+ * @param ring - the ring to fill (JsonSaxRing *)
+ *
+ * @return - NULL
+ */
+static void * __fillRing(void * ring);
+
+
+/**
+ * Feeds the buffers of a ring as they are filled, until the end of the json-string or of the parse
+ *
+ * @param ring - the ring to feed from
+ * @param stream - the state of the read
+ */
+static void __feedRing(JsonSaxRing * ring, JsonSaxStream * stream);
+
+
+/**
+ * Reads the next characters of a file, as a source
+ *
+ * @param context - the file to read
+ * @param window - where to write the characters
+ * @param capacity - the most characters the window can take
+ *
+ * @return - the number of characters read, 0 at the end of the file, -1 on failure
+ */
+static int __readFile(void * context, char * window, unsigned int capacity);
+
+
+/**
+ * Reads a range of a file through a window mapped in memory, which slides over the range
+ *
+ * @param descriptor - the file to read
+ * @param start - the offset of the json-string in the file
+ * @param end - the offset following the json-string in the file
+ * @param windowSize - the number of characters mapped at once, rounded up to whole pages
+ * @param handler - the callbacks to call
+ * @param context - the user context passed to every callback
+ * @param error - where to store why the json-string is rejected, NULL to ignore it
+ *
+ * @return - 0 once the whole json-string is read, 1 if a callback stopped the parse, -1 if the json-string is rejected or can't be mapped
+ */
+static int __parseMapped(int descriptor, off_t start, off_t end, size_t windowSize, JsonSaxHandler const * handler, void * context, JsonError * error);
+
+
+/**
+ * Validates a token and calls its callback
+ *
+ * @param grammar - the grammar validating the tokens
+ * @param handler - the callbacks to call
+ * @param context - the user context passed to the callback
+ * @param lexeme - the token
+ * @param offset - the offset of the token in the json-string
+ *
+ * @return - 0 to go on, 1 if the callback stopped the parse, -1 if the token is rejected
+ */
+static int __accept(JsonGrammar * grammar, JsonSaxHandler const * handler, void * context, JsonLexeme const * lexeme, size_t offset);
+
+
+/**
+ * Records why the json-string is rejected, unless it already is
+ *
+ * @param grammar - the grammar holding the error
+ * @param code - the reason of the rejection
+ * @param offset - the offset of the rejected character in the json-string
+ *
+ * @return - -1
+ */
+static int __reject(JsonGrammar * grammar, JsonErrorCode code, size_t offset);
+
+
+/**
+ * Reads the complete tokens of a chunk
+ *
+ * @param stream - the state of the read
+ * @param string - the chunk to read
+ * @param length - the length of the chunk
+ * @param base - the offset of the chunk in the json-string
+ * @param offset - the offset to read from, moved to the end of the chunk or to the start of a cut token
+ * @param isLast - whether the chunk ends the json-string
+ *
+ * @return - 0 to go on, 1 if a callback stopped the parse, -1 if the json-string is rejected
+ */
+static int __feedString(JsonSaxStream * stream, char const * const string, size_t length, size_t base, size_t * offset, int isLast);
+
+
+/**
+ * Completes the token carried over with the start of the next chunk
+ * The chunk is appended piece by piece, so that only the characters of the token are copied
+ *
+ * @param stream - the state of the read
+ * @param chunk - the next chunk
+ * @param length - the length of the chunk
+ * @param offset - where to store the offset following the token in the chunk
+ *
+ * @return - 0 to go on, 1 if the callback stopped the parse, -1 if the json-string is rejected
+ */
+static int __feedCarry(JsonSaxStream * stream, char const * const chunk, size_t length, size_t * offset);
+
+
+/**
+ * Appends characters to the carried token
+ *
+ * @param stream - the state of the read
+ * @param characters - the characters to append
+ * @param count - the number of characters
+ *
+ * @return - 0 on success, -1 on allocation failure
+ */
+static int __appendCarry(JsonSaxStream * stream, char const * const characters, size_t count);
+
+
+/**
+ * Calls the callback matching an accepted token
+ *
+ * @param handler - the callbacks to call
+ * @param context - the user context passed to the callback
+ * @param lexeme - the accepted token
+ * @param isKey - whether the token is the key of an object member
+ * @param number - the value of the token if it's a number
+ *
+ * @return - the value returned by the callback, 0 if there is none
+ */
+static int __emit(JsonSaxHandler const * handler, void * context, JsonLexeme const * lexeme, int isKey, JsonValue const * number);
+
+
+/**
+ * Calls the callback matching an operator, only brackets have one
+ *
+ * @param handler - the callbacks to call
+ * @param context - the user context passed to the callback
+ * @param operator - the operator
+ *
+ * @return - the value returned by the callback, 0 if there is none
+ */
+static int __emitOperator(JsonSaxHandler const * handler, void * context, JsonOperatorValue operator);
+
+
+
+
+static int parse(char const * const string, size_t length, JsonSaxHandler const * handler, void * context, JsonError * error)
+{
+    JsonGrammar grammar;
+    JsonLexeme lexeme;
+    size_t offset = 0;
+    int status;
+
+    _JsonGrammar->begin(& grammar);
+
+    while ((status = _JsonLexer->next(string, length, & offset, & lexeme)) == 1) {
+        if ((status = __accept(& grammar, handler, context, & lexeme, lexeme.start - string)) != 0) {
+            break;
+        }
+    }
+
+    if (status == 1) {
+        return 1;
+    }
+
+    if (status == -1) {
+        __reject(& grammar, JSON_ERROR_INVALID_TOKEN, offset);
+    }
+    _JsonGrammar->end(& grammar, offset);
+
+    if (error != NULL) {
+        * error = grammar.error;
+    }
+
+    return (grammar.error.code == JSON_ERROR_NONE) ? 0 : -1;
+}
+
+
+static void begin(JsonSaxStream * stream, JsonSaxHandler const * handler, void * context)
+{
+    stream->handler = handler;
+    stream->context = context;
+    _JsonGrammar->begin(& stream->grammar);
+    stream->carry = NULL;
+    stream->carryLength = 0;
+    stream->carryCapacity = 0;
+    stream->consumed = 0;
+    stream->status = 0;
+}
+
+
+static int feed(JsonSaxStream * stream, char const * const chunk, size_t length)
+{
+    size_t offset = 0;
+
+    if (stream->status != 0) {
+        return stream->status;
+    }
+
+    if (stream->carryLength > 0) {
+        stream->status = __feedCarry(stream, chunk, length, & offset);
+        if ((stream->status != 0) || (stream->carryLength > 0)) {
+            stream->consumed += length;
+            return stream->status;
+        }
+    }
+
+    stream->status = __feedString(stream, chunk, length, stream->consumed, & offset, 0);
+    if ((stream->status == 0) && (offset < length) && (__appendCarry(stream, chunk + offset, length - offset) != 0)) {
+        stream->status = __reject(& stream->grammar, JSON_ERROR_ALLOCATION, stream->consumed + offset);
+    }
+    stream->consumed += length;
+
+    return stream->status;
+}
+
+
+static int end(JsonSaxStream * stream, JsonError * error)
+{
+    size_t offset = 0;
+
+    if ((stream->status == 0) && (stream->carryLength > 0)) {
+        stream->status = __feedString(stream, stream->carry, stream->carryLength, stream->consumed - stream->carryLength, & offset, 1);
+    }
+
+    if (stream->status == 0) {
+        _JsonGrammar->end(& stream->grammar, stream->consumed);
+        stream->status = (stream->grammar.error.code == JSON_ERROR_NONE) ? 0 : -1;
+    }
+
+    if ((error != NULL) && (stream->status != 1)) {
+        * error = stream->grammar.error;
+    }
+
+    Class->delete((void **) & stream->carry);
+    stream->carryLength = 0;
+    stream->carryCapacity = 0;
+
+    return stream->status;
+}
+
+
+static int parseSource(JsonSaxSource const * source, unsigned int windowSize, JsonSaxHandler const * handler, void * context, JsonError * error)
+{
+    JsonSaxStream stream;
+    char * window;
+    int length = 0;
+    int status;
+
+    _JsonSax->begin(& stream, handler, context);
+
+    /* a single window is enough: the tokens it cuts are carried over by the stream */
+    window = Class->new("JsonString", windowSize);
+    if (window == NULL) {
+        stream.status = __reject(& stream.grammar, JSON_ERROR_ALLOCATION, 0);
+    }
+
+    while ((stream.status == 0) && ((length = source->read(source->context, window, windowSize)) > 0)) {
+        _JsonSax->feed(& stream, window, length);
+    }
+
+    if ((stream.status == 0) && (length < 0)) {
+        stream.status = __reject(& stream.grammar, JSON_ERROR_READ, stream.consumed);
+    }
+
+    status = _JsonSax->end(& stream, error);
+    Class->delete((void **) & window);
+
+    return status;
+}
+
+
+static int parseSourceAsync(JsonSaxSource const * source, unsigned int buffersCount, unsigned int bufferSize, JsonSaxHandler const * handler, void * context, JsonError * error)
+{
+    JsonSaxRing ring;
+    JsonSaxStream stream;
+    pthread_t reader;
+
+    ring.source = source;
+    ring.buffersCount = (buffersCount > 2) ? buffersCount : 2;
+    ring.bufferSize = bufferSize;
+    ring.filledCount = 0;
+    ring.fedCount = 0;
+    ring.isOver = 0;
+
+    ring.buffers = Class->new("JsonString", (size_t) ring.buffersCount * bufferSize);
+    ring.lengths = Class->new("int[]", ring.buffersCount * sizeof(int));
+    if ((ring.buffers == NULL) || (ring.lengths == NULL)) {
+        Class->delete((void **) & ring.buffers);
+        Class->delete((void **) & ring.lengths);
+        _JsonSax->begin(& stream, handler, context);
+        stream.status = __reject(& stream.grammar, JSON_ERROR_ALLOCATION, 0);
+        return _JsonSax->end(& stream, error);
+    }
+
+    pthread_mutex_init(& ring.mutex, NULL);
+    pthread_cond_init(& ring.filled, NULL);
+    pthread_cond_init(& ring.fed, NULL);
+
+    /* without a reader thread, the source is read between chunks on this one */
+    if (pthread_create(& reader, NULL, __fillRing, & ring) != 0) {
+        Class->delete((void **) & ring.buffers);
+        Class->delete((void **) & ring.lengths);
+        pthread_mutex_destroy(& ring.mutex);
+        pthread_cond_destroy(& ring.filled);
+        pthread_cond_destroy(& ring.fed);
+        return _JsonSax->parseSource(source, bufferSize, handler, context, error);
+    }
+
+    _JsonSax->begin(& stream, handler, context);
+    __feedRing(& ring, & stream);
+
+    pthread_mutex_lock(& ring.mutex);
+    ring.isOver = 1;
+    pthread_cond_signal(& ring.fed);
+    pthread_mutex_unlock(& ring.mutex);
+    pthread_join(reader, NULL);
+
+    pthread_mutex_destroy(& ring.mutex);
+    pthread_cond_destroy(& ring.filled);
+    pthread_cond_destroy(& ring.fed);
+    Class->delete((void **) & ring.buffers);
+    Class->delete((void **) & ring.lengths);
+
+    return _JsonSax->end(& stream, error);
+}
+
+
+static int parseFile(FILE * file, JsonSaxHandler const * handler, void * context, JsonError * error)
+{
+    JsonSaxSource source;
+    struct stat fileStatus;
+    off_t start;
+    int status;
+
+    /* regular files are mapped rather than copied through stdio, pipes and terminals are read */
+    start = ftello(file);
+    if ((start != -1) && (fstat(fileno(file), & fileStatus) == 0) && S_ISREG(fileStatus.st_mode)) {
+        status = __parseMapped(fileno(file), start, fileStatus.st_size, JSON_SAX_MAP_WINDOW_SIZE, handler, context, error);
+        fseeko(file, 0, SEEK_END);
+        return status;
+    }
+
+    source.read = __readFile;
+    source.context = file;
+
+    return _JsonSax->parseSourceAsync(& source, JSON_SAX_RING_SIZE, JSON_SAX_CHUNK_SIZE, handler, context, error);
+}
+
+
+static int parseMappedFile(char const * const path, size_t windowSize, JsonSaxHandler const * handler, void * context, JsonError * error)
+{
+    struct stat fileStatus;
+    int descriptor;
+    int status = -1;
+
+    descriptor = open(path, O_RDONLY);
+    if ((descriptor != -1) && (fstat(descriptor, & fileStatus) == 0)) {
+        status = __parseMapped(descriptor, 0, fileStatus.st_size, windowSize, handler, context, error);
+    } else if (error != NULL) {
+        error->code = JSON_ERROR_READ;
+        error->offset = 0;
+    }
+
+    if (descriptor != -1) {
+        close(descriptor);
+    }
+
+    return status;
+}
+
+
+
+
+static void * __fillRing(void * ring)
+{
+    JsonSaxRing * this = ring;
+    char * buffer;
+    int length;
+
+    do {
+        /* backpressure: the reader waits for the parser once every buffer is full */
+        pthread_mutex_lock(& this->mutex);
+        while (! this->isOver && (this->filledCount - this->fedCount == this->buffersCount)) {
+            pthread_cond_wait(& this->fed, & this->mutex);
+        }
+        if (this->isOver) {
+            pthread_mutex_unlock(& this->mutex);
+            break;
+        }
+        buffer = this->buffers + (size_t) (this->filledCount % this->buffersCount) * this->bufferSize;
+        pthread_mutex_unlock(& this->mutex);
+
+        length = this->source->read(this->source->context, buffer, this->bufferSize);
+
+        pthread_mutex_lock(& this->mutex);
+        this->lengths[this->filledCount % this->buffersCount] = length;
+        this->filledCount++;
+        pthread_cond_signal(& this->filled);
+        pthread_mutex_unlock(& this->mutex);
+    } while (length > 0);
+
+    return NULL;
+}
+
+
+static void __feedRing(JsonSaxRing * ring, JsonSaxStream * stream)
+{
+    char const * buffer;
+    int length;
+
+    while (stream->status == 0) {
+        pthread_mutex_lock(& ring->mutex);
+        while (ring->filledCount == ring->fedCount) {
+            pthread_cond_wait(& ring->filled, & ring->mutex);
+        }
+        buffer = ring->buffers + (size_t) (ring->fedCount % ring->buffersCount) * ring->bufferSize;
+        length = ring->lengths[ring->fedCount % ring->buffersCount];
+        pthread_mutex_unlock(& ring->mutex);
+
+        if (length < 0) {
+            stream->status = __reject(& stream->grammar, JSON_ERROR_READ, stream->consumed);
+        }
+        if (length <= 0) {
+            break;
+        }
+
+        /* the next buffers are filled meanwhile */
+        _JsonSax->feed(stream, buffer, length);
+
+        pthread_mutex_lock(& ring->mutex);
+        ring->fedCount++;
+        pthread_cond_signal(& ring->fed);
+        pthread_mutex_unlock(& ring->mutex);
+    }
+}
+
+
+static int __readFile(void * context, char * window, unsigned int capacity)
+{
+    unsigned int length = fread(window, 1, capacity, (FILE *) context);
+
+    return ((length == 0) && ferror((FILE *) context)) ? -1 : (int) length;
+}
+
+
+static int __parseMapped(int descriptor, off_t start, off_t end, size_t windowSize, JsonSaxHandler const * handler, void * context, JsonError * error)
+{
+    JsonSaxStream stream;
+    size_t pageSize = sysconf(_SC_PAGESIZE);
+    off_t offset = start - start % pageSize;
+    size_t skipped = start - offset;
+    size_t length;
+    char * window;
+
+    windowSize = (windowSize > 0) ? (windowSize + pageSize - 1) / pageSize * pageSize : pageSize;
+
+    _JsonSax->begin(& stream, handler, context);
+
+    /* only the mapped window and the carried token are resident, the window being unmapped once fed */
+    while ((stream.status == 0) && (offset < end)) {
+        length = ((size_t) (end - offset) < windowSize) ? (size_t) (end - offset) : windowSize;
+        window = mmap(NULL, length, PROT_READ, MAP_PRIVATE, descriptor, offset);
+        if (window == MAP_FAILED) {
+            stream.status = __reject(& stream.grammar, JSON_ERROR_READ, stream.consumed);
+            break;
+        }
+        posix_madvise(window, length, POSIX_MADV_SEQUENTIAL);
+
+        _JsonSax->feed(& stream, window + skipped, length - skipped);
+        munmap(window, length);
+
+        offset += length;
+        skipped = 0;
+    }
+
+    return _JsonSax->end(& stream, error);
+}
+
+
+static int __accept(JsonGrammar * grammar, JsonSaxHandler const * handler, void * context, JsonLexeme const * lexeme, size_t offset)
+{
+    JsonValue number;
+    unsigned int openingIndex;
+    int isKey = (grammar->state == JSON_GRAMMAR_KEY) || (grammar->state == JSON_GRAMMAR_FIRST_KEY);
+
+    if (_JsonGrammar->feed(grammar, lexeme->type, lexeme->start[0], offset, & openingIndex) == -1) {
+        return -1;
+    }
+
+    /* numbers too long for the stack are converted from a copy on the heap, which may run out */
+    if ((lexeme->type == JSON_TOKEN_INTEGER) && (_JsonNumbers->convertIntegers(lexeme, 1, & number.asInteger) != 0)) {
+        return __reject(grammar, JSON_ERROR_ALLOCATION, offset);
+    }
+    if ((lexeme->type == JSON_TOKEN_FLOAT) && (_JsonNumbers->convertFloats(lexeme, 1, & number.asFloat) != 0)) {
+        return __reject(grammar, JSON_ERROR_ALLOCATION, offset);
+    }
+
+    return (__emit(handler, context, lexeme, isKey, & number) != 0) ? 1 : 0;
+}
+
+
+static int __reject(JsonGrammar * grammar, JsonErrorCode code, size_t offset)
+{
+    if (grammar->error.code == JSON_ERROR_NONE) {
+        grammar->error.code = code;
+        grammar->error.offset = offset;
+    }
+
+    return -1;
+}
+
+
+static int __feedString(JsonSaxStream * stream, char const * const string, size_t length, size_t base, size_t * offset, int isLast)
+{
+    JsonLexeme lexeme;
+    int status;
+
+    while ((status = _JsonLexer->nextInChunk(string, length, offset, & lexeme, isLast)) == 1) {
+        if ((status = __accept(& stream->grammar, stream->handler, stream->context, & lexeme, base + (lexeme.start - string))) != 0) {
+            return status;
+        }
+    }
+
+    if (status == -1) {
+        return __reject(& stream->grammar, JSON_ERROR_INVALID_TOKEN, base + * offset);
+    }
+
+    return 0;
+}
+
+
+static int __feedCarry(JsonSaxStream * stream, char const * const chunk, size_t length, size_t * offset)
+{
+    JsonLexeme lexeme;
+    size_t carried = stream->carryLength;
+    size_t base = stream->consumed - carried;
+    size_t appended = 0;
+    size_t step = JSON_SAX_CARRY_STEP;
+    size_t piece;
+    size_t carryOffset;
+    int status;
+
+    for (;;) {
+        carryOffset = 0;
+        status = _JsonLexer->nextInChunk(stream->carry, stream->carryLength, & carryOffset, & lexeme, 0);
+
+        if (status == 0) {
+            if (appended == length) {
+                return 0;
+            }
+            piece = (length - appended < step) ? length - appended : step;
+            if (__appendCarry(stream, chunk + appended, piece) != 0) {
+                return __reject(& stream->grammar, JSON_ERROR_ALLOCATION, stream->consumed + appended);
+            }
+            appended += piece;
+            step *= 2;
+            continue;
+        }
+
+        if (status == -1) {
+            return __reject(& stream->grammar, JSON_ERROR_INVALID_TOKEN, base + carryOffset);
+        }
+
+        status = __accept(& stream->grammar, stream->handler, stream->context, & lexeme, base + (lexeme.start - stream->carry));
+        if ((status != 0) || (carryOffset >= carried)) {
+            break;
+        }
+
+        /* the token ended within the carried characters, like "1" in "1-2", the next one starts from the rest of them */
+        memmove(stream->carry, stream->carry + carryOffset, stream->carryLength - carryOffset);
+        stream->carryLength -= carryOffset;
+        carried -= carryOffset;
+        base += carryOffset;
+    }
+
+    stream->carryLength = 0;
+    * offset = carryOffset - carried;
+
+    return status;
+}
+
+
+static int __appendCarry(JsonSaxStream * stream, char const * const characters, size_t count)
+{
+    size_t capacity = (stream->carryCapacity > 0) ? stream->carryCapacity : JSON_SAX_CARRY_STEP;
+
+    while (capacity < stream->carryLength + count) {
+        capacity *= 2;
+    }
+
+    if (stream->carry == NULL) {
+        stream->carry = Class->new("JsonString", capacity);
+        if (stream->carry == NULL) {
+            return -1;
+        }
+        stream->carryCapacity = capacity;
+    } else if (capacity > stream->carryCapacity) {
+        if (Class->resize((void **) & stream->carry, stream->carryCapacity, capacity) != 0) {
+            return -1;
+        }
+        stream->carryCapacity = capacity;
+    }
+
+    memcpy(stream->carry + stream->carryLength, characters, count);
+    stream->carryLength += count;
+
+    return 0;
+}
+
+
+
+
+static int __emit(JsonSaxHandler const * handler, void * context, JsonLexeme const * lexeme, int isKey, JsonValue const * number)
+{
+    switch (lexeme->type) {
+        case JSON_TOKEN_OPERATOR:
+            return __emitOperator(handler, context, lexeme->start[0]);
+        case JSON_TOKEN_STRING:
+            if (isKey && (handler->keys != NULL) && (handler->onKeyId != NULL)) {
+                return handler->onKeyId(context, _JsonKeys->find(handler->keys, lexeme->start + 1, lexeme->length - 2));
+            }
+            if (isKey) {
+                return (handler->onKey != NULL) ? handler->onKey(context, lexeme->start + 1, lexeme->length - 2) : 0;
+            }
+            return (handler->onString != NULL) ? handler->onString(context, lexeme->start + 1, lexeme->length - 2) : 0;
+        case JSON_TOKEN_INTEGER:
+            return (handler->onInteger != NULL) ? handler->onInteger(context, number->asInteger) : 0;
+        case JSON_TOKEN_FLOAT:
+            return (handler->onFloat != NULL) ? handler->onFloat(context, number->asFloat) : 0;
+        case JSON_TOKEN_BOOLEAN:
+            return (handler->onBoolean != NULL) ? handler->onBoolean(context, lexeme->start[0] == 't') : 0;
+        case JSON_TOKEN_NULL:
+            return (handler->onNull != NULL) ? handler->onNull(context) : 0;
+    }
+
+    return 0;
+}
+
+
+static int __emitOperator(JsonSaxHandler const * handler, void * context, JsonOperatorValue operator)
+{
+    int (* callback)(void * context) = NULL;
+
+    switch (operator) {
+        case JSON_OPERATOR_OBJECT_START:
+            callback = handler->onObjectStart;
+            break;
+        case JSON_OPERATOR_OBJECT_END:
+            callback = handler->onObjectEnd;
+            break;
+        case JSON_OPERATOR_ARRAY_START:
+            callback = handler->onArrayStart;
+            break;
+        case JSON_OPERATOR_ARRAY_END:
+            callback = handler->onArrayEnd;
+            break;
+        default:
+            break;
+    }
+
+    return (callback != NULL) ? callback(context) : 0;
+}
+
+
+
+
+/**
+ * Init JsonSax methods table
+ */
+static _JsonSaxMethods methods = {
+    parse,
+    begin,
+    feed,
+    end,
+    parseSource,
+    parseSourceAsync,
+    parseFile,
+    parseMappedFile
+};
+_JsonSaxMethods const * const _JsonSax = & methods;
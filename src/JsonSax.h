@@ -0,0 +1,280 @@
+#ifndef JSON_SAX_HEADER
+#define JSON_SAX_HEADER
+
+#include <stdio.h>
+
+#include "JsonToken.h"
+#include "JsonGrammar.h"
+#include "JsonKeys.h"
+
+
+
+
+/**
+ * Callbacks called for each event of a json-string, in order
+ * Any callback may be NULL to ignore its events, and returns 0 to go on or anything else to stop the parse
+ * Strings are borrowed from the json-string, without quotes and with their escapes kept
+ */
+typedef struct
+{
+    /**
+     * Called on a '{'
+     */
+    int (* onObjectStart)(void * context);
+
+    /**
+     * Called on a '}'
+     */
+    int (* onObjectEnd)(void * context);
+
+    /**
+     * Called on a '['
+     */
+    int (* onArrayStart)(void * context);
+
+    /**
+     * Called on a ']'
+     */
+    int (* onArrayEnd)(void * context);
+
+    /**
+     * Called on the key of an object member, before its value
+     */
+    int (* onKey)(void * context, char const * key, size_t length);
+
+    /**
+     * Called on a string value
+     */
+    int (* onString)(void * context, char const * value, size_t length);
+
+    /**
+     * Called on an integer value
+     */
+    int (* onInteger)(void * context, JsonIntegerValue value);
+
+    /**
+     * Called on a float value
+     */
+    int (* onFloat)(void * context, JsonFloatValue value);
+
+    /**
+     * Called on a boolean value
+     */
+    int (* onBoolean)(void * context, JsonBooleanValue value);
+
+    /**
+     * Called on a null value
+     */
+    int (* onNull)(void * context);
+
+    /**
+     * Called instead of onKey when keys are given, with the slot of the key (its generated enum value), -1 for unknown keys
+     */
+    int (* onKeyId)(void * context, int id);
+
+    /**
+     * The known keys onKeyId maps keys from, NULL to call onKey
+     */
+    JsonKeySet const * keys;
+
+} JsonSaxHandler;
+
+
+/**
+ * Input the json-string is decoded from, a compressed stream for example
+ */
+typedef struct
+{
+    /**
+     * Decodes the next characters of the json-string
+     *
+     * @param context - the source context
+     * @param window - where to write the characters
+     * @param capacity - the most characters the window can take
+     *
+     * @return - the number of characters written, 0 at the end of the json-string, -1 on failure
+     */
+    int (* read)(void * context, char * window, unsigned int capacity);
+
+    /**
+     * User data given back to every read call
+     */
+    void * context;
+
+} JsonSaxSource;
+
+
+/**
+ * The state of a json-string read chunk by chunk, to allocate anywhere and start with begin
+ * A token cut by the end of a chunk is carried over and completed by the next one
+ */
+typedef struct
+{
+    /**
+     * The callbacks to call
+     */
+    JsonSaxHandler const * handler;
+
+    /**
+     * The user context passed to every callback
+     */
+    void * context;
+
+    /**
+     * The grammar validating the tokens read so far
+     */
+    JsonGrammar grammar;
+
+    /**
+     * The start of a token cut by the end of the previous chunk
+     */
+    char * carry;
+
+    /**
+     * The number of characters carried over
+     */
+    size_t carryLength;
+
+    /**
+     * The number of characters the carry can hold
+     */
+    size_t carryCapacity;
+
+    /**
+     * The number of characters fed before the current chunk
+     */
+    size_t consumed;
+
+    /**
+     * 0 while the read goes on, 1 once a callback stopped it, -1 once the json-string is rejected
+     */
+    int status;
+
+} JsonSaxStream;
+
+
+
+
+/**
+ * JsonSax methods table
+ * Events are read straight from the json-string, no token nor list is allocated
+ */
+typedef struct
+{
+    /**
+     * Reads a json-string, calling the handler for each of its events
+     * The json-string is validated along the way, events before an error have already been sent
+     *
+     * @param string - the json-string to read
+     * @param length - the length of the json-string
+     * @param handler - the callbacks to call
+     * @param context - the user context passed to every callback
+     * @param error - where to store why the json-string is rejected, NULL to ignore it
+     *
+     * @return - 0 once the whole json-string is read, 1 if a callback stopped the parse, -1 if the json-string is rejected
+     */
+    int (* parse)(char const * const string, size_t length, JsonSaxHandler const * handler, void * context, JsonError * error);
+
+    /**
+     * Starts reading a json-string chunk by chunk
+     *
+     * @param stream - the state to initialize
+     * @param handler - the callbacks to call
+     * @param context - the user context passed to every callback
+     */
+    void (* begin)(JsonSaxStream * stream, JsonSaxHandler const * handler, void * context);
+
+    /**
+     * Reads the next chunk of the json-string, calling the handler for each of its complete events
+     * The chunk is only borrowed during the call, it can be reused afterwards
+     *
+     * @param stream - the state of the read
+     * @param chunk - the next characters of the json-string
+     * @param length - the number of characters of the chunk
+     *
+     * @return - 0 to go on, 1 if a callback stopped the parse, -1 if the json-string is rejected
+     */
+    int (* feed)(JsonSaxStream * stream, char const * const chunk, size_t length);
+
+    /**
+     * Ends the read once every chunk is fed, and releases the state
+     *
+     * @param stream - the state of the read
+     * @param error - where to store why the json-string is rejected, NULL to ignore it
+     *
+     * @return - 0 once the whole json-string is read, 1 if a callback stopped the parse, -1 if the json-string is rejected
+     */
+    int (* end)(JsonSaxStream * stream, JsonError * error);
+
+    /**
+     * Reads a json-string decoded from a source, through a window which is reused for each chunk
+     * Memory only depends on the window and on the longest token, not on the size of the json-string
+     *
+     * @param source - the source to decode the json-string from
+     * @param windowSize - the number of characters decoded at once
+     * @param handler - the callbacks to call
+     * @param context - the user context passed to every callback
+     * @param error - where to store why the json-string is rejected, NULL to ignore it
+     *
+     * @return - 0 once the whole json-string is read, 1 if a callback stopped the parse, -1 if the json-string is rejected or the source fails
+     */
+    int (* parseSource)(JsonSaxSource const * source, unsigned int windowSize, JsonSaxHandler const * handler, void * context, JsonError * error);
+
+    /**
+     * Reads a json-string decoded from a source on a reader thread, while the calling thread parses the chunks already decoded
+     * The reader fills a bounded ring of buffers, and waits once they are all full until one is parsed
+     * Reading and parsing then overlap, the slower of them setting the pace
+     * The source is only read from the reader thread, and callbacks only called from the calling thread
+     *
+     * @param source - the source to decode the json-string from
+     * @param buffersCount - the number of buffers of the ring, at least 2
+     * @param bufferSize - the number of characters decoded at once into a buffer
+     * @param handler - the callbacks to call
+     * @param context - the user context passed to every callback
+     * @param error - where to store why the json-string is rejected, NULL to ignore it
+     *
+     * @return - 0 once the whole json-string is read, 1 if a callback stopped the parse, -1 if the json-string is rejected or the source fails
+     */
+    int (* parseSourceAsync)(JsonSaxSource const * source, unsigned int buffersCount, unsigned int bufferSize, JsonSaxHandler const * handler, void * context, JsonError * error);
+
+    /**
+     * Reads a json file chunk by chunk, so that memory doesn't depend on the size of the file
+     * Regular files are read through a window mapped in memory (@see parseMappedFile), other files through stdio on a reader thread (@see parseSourceAsync)
+     *
+     * @param file - the file to read, from its current position to its end
+     * @param handler - the callbacks to call
+     * @param context - the user context passed to every callback
+     * @param error - where to store why the file is rejected, NULL to ignore it
+     *
+     * @return - 0 once the whole file is read, 1 if a callback stopped the parse, -1 if the file is rejected or can't be read
+     */
+    int (* parseFile)(FILE * file, JsonSaxHandler const * handler, void * context, JsonError * error);
+
+    /**
+     * Reads a json file through a window mapped in memory, which slides over the file and is unmapped once read
+     * Files larger than memory are read with only the window, the open containers and the current token resident
+     *
+     * @param path - the path of the file to read
+     * @param windowSize - the number of characters mapped at once, rounded up to whole pages
+     * @param handler - the callbacks to call
+     * @param context - the user context passed to every callback
+     * @param error - where to store why the file is rejected, NULL to ignore it
+     *
+     * @return - 0 once the whole file is read, 1 if a callback stopped the parse, -1 if the file is rejected or can't be read
+     */
+    int (* parseMappedFile)(char const * const path, size_t windowSize, JsonSaxHandler const * handler, void * context, JsonError * error);
+
+} _JsonSaxMethods;
+
+
+
+
+/**
+ * JsonSax class methods table
+ */
+extern _JsonSaxMethods const * const _JsonSax;
+
+
+
+
+#endif /* JSON_SAX_HEADER */
@@ -0,0 +1,785 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "Class.h"
+#include "LinkedList.h"
+#include "JsonToken.h"
+#include "Json.h"
+#include "JsonSnapshot.h"
+
+
+
+
+/**
+ * Version of the file layout
+ */
+#define SNAPSHOT_VERSION 2
+
+
+/**
+ * Written as is, to reject files from machines with another byte order
+ */
+#define SNAPSHOT_BYTE_ORDER 0x01020304
+
+
+/**
+ * Beginning of a snapshot file
+ */
+typedef struct
+{
+    /**
+     * "JSNP"
+     */
+    char magic[4];
+
+    /**
+     * SNAPSHOT_VERSION
+     */
+    unsigned int version;
+
+    /**
+     * SNAPSHOT_BYTE_ORDER, as written by the machine
+     */
+    unsigned int byteOrder;
+
+    /**
+     * The size of a record, as written by the machine
+     */
+    unsigned int recordSize;
+
+    /**
+     * The number of records following the header
+     */
+    unsigned int tokensCount;
+
+    /**
+     * The number of entries of the members table following the records
+     */
+    unsigned int membersCount;
+
+    /**
+     * The size of the strings area following the members table
+     */
+    unsigned int stringsSize;
+
+    /**
+     * Unused, keeps the records following the header aligned
+     */
+    unsigned int padding;
+
+} SnapshotHeader;
+
+
+/**
+ * A token, as stored in a snapshot file
+ */
+typedef struct
+{
+    /**
+     * The type of the token
+     */
+    unsigned int type;
+
+    /**
+     * For opening operators, the index of the matching closing one, 0 otherwise
+     */
+    unsigned int matchIndex;
+
+    /**
+     * For opening curly braces, the index of the first member of the object in the members table, 0 otherwise
+     */
+    unsigned int membersIndex;
+
+    /**
+     * For opening curly braces, the number of members of the object, 0 otherwise
+     */
+    unsigned int membersCount;
+
+    /**
+     * The offset of the raw string in the strings area
+     */
+    unsigned int rawOffset;
+
+    /**
+     * The length of the raw string
+     */
+    unsigned int rawLength;
+
+    /**
+     * The value of the token, converted once when saving
+     */
+    union {
+        JsonIntegerValue asInteger;
+        JsonFloatValue asFloat;
+        JsonBooleanValue asBoolean;
+        JsonOperatorValue asOperator;
+    } value;
+
+} SnapshotRecord;
+
+
+/**
+ * A member of an object, as stored in the members table
+ * The members of each object are sorted by key, keys as written, then by index
+ */
+typedef struct
+{
+    /**
+     * The index of the key token, its value being two tokens further
+     */
+    unsigned int keyIndex;
+
+} SnapshotMember;
+
+
+/**
+ * A key being sorted while saving
+ */
+typedef struct
+{
+    /**
+     * The key, without quotes
+     */
+    char const * key;
+
+    /**
+     * The length of the key
+     */
+    unsigned int length;
+
+    /**
+     * The index of the key token
+     */
+    unsigned int keyIndex;
+
+} SnapshotKey;
+
+
+struct JsonSnapshot
+{
+    /**
+     * The mapped file
+     */
+    void * mapping;
+
+    /**
+     * The size of the mapped file
+     */
+    unsigned long mappingSize;
+
+    /**
+     * The records, in the mapped file
+     */
+    SnapshotRecord const * records;
+
+    /**
+     * The members table, in the mapped file
+     */
+    SnapshotMember const * members;
+
+    /**
+     * The strings area, in the mapped file
+     */
+    char const * strings;
+
+    /**
+     * The number of records
+     */
+    unsigned int tokensCount;
+
+    /**
+     * The number of entries of the members table
+     */
+    unsigned int membersCount;
+
+    /**
+     * The size of the strings area
+     */
+    unsigned int stringsSize;
+};
+
+
+
+
+/**
+ * Fills the records from the tokens, matching opening and closing operators
+ * 
+ * @param tokens - the tokens to convert
+ * @param records - the records to fill, one per token
+ * @param tokensCount - the number of tokens
+ * 
+ * @return - the size of the strings area, or 0 on failure
+ */
+static unsigned int __fillRecords(LinkedList const * tokens, SnapshotRecord * records, unsigned int tokensCount);
+
+
+/**
+ * Fills the members table, sorting the members of each object by key
+ * 
+ * @param json - the json the records were filled from
+ * @param records - the records, opening curly braces getting the position of their members
+ * @param tokensCount - the number of records
+ * @param members - the members table to fill, with room for a member per token
+ * 
+ * @return - the number of members, or -1 on failure
+ */
+static int __fillMembers(Json const * const json, SnapshotRecord * records, unsigned int tokensCount, SnapshotMember * members);
+
+
+/**
+ * Compares two keys being sorted, for qsort
+ * 
+ * @param first - the first SnapshotKey
+ * @param second - the second SnapshotKey
+ * 
+ * @return - negative, 0 or positive as the first key sorts before, the same as, or after the second one
+ */
+static int __compareKeys(void const * first, void const * second);
+
+
+/**
+ * Compares a key with the key of a member of the members table
+ * 
+ * @param this - the snapshot to read
+ * @param key - the key, without quotes
+ * @param keyLength - the length of the key
+ * @param member - the member to compare with, which must be in range
+ * @param order - where to store how the key sorts against the member's key
+ * 
+ * @return - 0 on success, -1 if the member doesn't designate a key within the file
+ */
+static int __compareMember(JsonSnapshot const * const this, char const * const key, unsigned int keyLength, SnapshotMember const * member, int * order);
+
+
+/**
+ * Returns a record, checking that it lies within the file
+ * 
+ * @param this - the snapshot to read
+ * @param index - the index of the record
+ * 
+ * @return - the record, NULL if the index is out of range
+ */
+static SnapshotRecord const * __getRecord(JsonSnapshot const * const this, unsigned int index);
+
+
+/**
+ * Returns the raw string of a record, checking that it lies within the strings area and is terminated there
+ * 
+ * @param this - the snapshot to read
+ * @param record - the record, NULL for none
+ * 
+ * @return - the raw string, NULL if it's out of range
+ */
+static char const * __getRawString(JsonSnapshot const * const this, SnapshotRecord const * record);
+
+
+/**
+ * Checks if a mapped file is a valid snapshot
+ * 
+ * @param this - the snapshot with the mapped file
+ * 
+ * @return - 0 if valid, -1 otherwise
+ */
+static int __checkMapping(JsonSnapshot * const this);
+
+
+/**
+ * Checks if a token is the given operator
+ * 
+ * @param this - the snapshot to read
+ * @param index - the index of the token
+ * @param operator - the expected operator
+ * 
+ * @return - 1 if the token is the operator, 0 otherwise
+ */
+static int __isOperator(JsonSnapshot const * const this, unsigned int index, JsonOperator operator);
+
+
+
+
+static int save(Json const * const json, char const * const path)
+{
+    SnapshotHeader header;
+    SnapshotRecord * records;
+    SnapshotMember * members;
+    LinkedList * tokens = _Json->getTokens(json);
+    char const * rawString;
+    FILE * file;
+    int membersCount;
+    int status = 0;
+
+    memset(& header, 0, sizeof(header));
+    memcpy(header.magic, "JSNP", 4);
+    header.version = SNAPSHOT_VERSION;
+    header.byteOrder = SNAPSHOT_BYTE_ORDER;
+    header.recordSize = sizeof(SnapshotRecord);
+    header.tokensCount = _Json->getTokensCount(json);
+
+    records = Class->new("SnapshotRecord[]", sizeof(SnapshotRecord) * (header.tokensCount + 1));
+    if (records == NULL) {
+        return -1;
+    }
+
+    members = Class->new("SnapshotMember[]", sizeof(SnapshotMember) * (header.tokensCount + 1));
+    if (members == NULL) {
+        Class->delete((void **) & records);
+        return -1;
+    }
+
+    header.stringsSize = __fillRecords(tokens, records, header.tokensCount);
+    membersCount = __fillMembers(json, records, header.tokensCount, members);
+    if (((header.tokensCount > 0) && (header.stringsSize == 0)) || (membersCount == -1)) {
+        Class->delete((void **) & members);
+        Class->delete((void **) & records);
+        return -1;
+    }
+    header.membersCount = membersCount;
+
+    file = fopen(path, "wb");
+    if (file == NULL) {
+        Class->delete((void **) & members);
+        Class->delete((void **) & records);
+        return -1;
+    }
+
+    if (fwrite(& header, sizeof(header), 1, file) != 1) {
+        status = -1;
+    } else if (fwrite(records, sizeof(SnapshotRecord), header.tokensCount, file) != header.tokensCount) {
+        status = -1;
+    } else if (fwrite(members, sizeof(SnapshotMember), header.membersCount, file) != header.membersCount) {
+        status = -1;
+    }
+
+    for (; (status == 0) && (tokens != NULL); tokens = _LinkedList->nextElement(tokens)) {
+        rawString = _JsonToken->getRawString(_LinkedList->getContent(tokens));
+        if (fwrite(rawString, strlen(rawString) + 1, 1, file) != 1) {
+            status = -1;
+        }
+    }
+
+    if (fclose(file) != 0) {
+        status = -1;
+    }
+    Class->delete((void **) & members);
+    Class->delete((void **) & records);
+
+    return status;
+}
+
+
+static JsonSnapshot * load(char const * const path)
+{
+    JsonSnapshot * this;
+    struct stat fileStatus;
+    int file;
+
+    file = open(path, O_RDONLY);
+    if (file == -1) {
+        return NULL;
+    }
+
+    if ((fstat(file, & fileStatus) != 0) || ((unsigned long) fileStatus.st_size < sizeof(SnapshotHeader))) {
+        close(file);
+        return NULL;
+    }
+
+    this = Class->new("JsonSnapshot", sizeof(* this));
+
+    if (this != NULL) {
+        this->mappingSize = fileStatus.st_size;
+        this->mapping = mmap(NULL, this->mappingSize, PROT_READ, MAP_PRIVATE, file, 0);
+        if (this->mapping == MAP_FAILED) {
+            this->mapping = NULL;
+            _JsonSnapshot->delete(& this);
+        } else if (__checkMapping(this) != 0) {
+            _JsonSnapshot->delete(& this);
+        }
+    }
+
+    close(file);
+
+    return this;
+}
+
+
+static void delete(JsonSnapshot ** this)
+{
+    if ((this == NULL) || (* this == NULL)) {
+        return;
+    }
+
+    if ((* this)->mapping != NULL) {
+        munmap((* this)->mapping, (* this)->mappingSize);
+    }
+
+    Class->delete((void **) this);
+}
+
+
+static unsigned int size(JsonSnapshot const * const this)
+{
+    return this->tokensCount;
+}
+
+
+static JsonTokenType getType(JsonSnapshot const * const this, unsigned int index)
+{
+    SnapshotRecord const * record = __getRecord(this, index);
+
+    return (record != NULL) ? (JsonTokenType) record->type : (JsonTokenType) -1;
+}
+
+
+static JsonIntegerValue asInteger(JsonSnapshot const * const this, unsigned int index)
+{
+    SnapshotRecord const * record = __getRecord(this, index);
+
+    return (record != NULL) ? record->value.asInteger : 0;
+}
+
+
+static JsonFloatValue asFloat(JsonSnapshot const * const this, unsigned int index)
+{
+    SnapshotRecord const * record = __getRecord(this, index);
+
+    return (record != NULL) ? record->value.asFloat : 0;
+}
+
+
+static JsonBooleanValue asBoolean(JsonSnapshot const * const this, unsigned int index)
+{
+    SnapshotRecord const * record = __getRecord(this, index);
+
+    return (record != NULL) ? record->value.asBoolean : 0;
+}
+
+
+static JsonOperatorValue asOperator(JsonSnapshot const * const this, unsigned int index)
+{
+    SnapshotRecord const * record = __getRecord(this, index);
+
+    return (record != NULL) ? record->value.asOperator : '\0';
+}
+
+
+static char const * asString(JsonSnapshot const * const this, unsigned int index)
+{
+    return __getRawString(this, __getRecord(this, index));
+}
+
+
+static char const * getRawString(JsonSnapshot const * const this, unsigned int index)
+{
+    return __getRawString(this, __getRecord(this, index));
+}
+
+
+static unsigned int skip(JsonSnapshot const * const this, unsigned int index)
+{
+    SnapshotRecord const * record = __getRecord(this, index);
+
+    if (record == NULL) {
+        return this->tokensCount;
+    }
+
+    /* a match out of the container's range would loop or leave the file, it ends the tokens instead */
+    if (record->matchIndex != 0) {
+        return ((record->matchIndex > index) && (record->matchIndex < this->tokensCount)) ? record->matchIndex + 1 : this->tokensCount;
+    }
+
+    return index + 1;
+}
+
+
+static int findMember(JsonSnapshot const * const this, unsigned int objectIndex, char const * const key, unsigned int * valueIndex)
+{
+    SnapshotRecord const * object = __getRecord(this, objectIndex);
+    SnapshotMember const * members;
+    unsigned int keyLength = strlen(key);
+    unsigned int low = 0;
+    unsigned int high;
+    unsigned int middle;
+    int order;
+
+    if (! __isOperator(this, objectIndex, JSON_OPERATOR_OBJECT_START)) {
+        return -1;
+    }
+
+    if ((object->membersIndex > this->membersCount) || (object->membersCount > this->membersCount - object->membersIndex)) {
+        return -1;
+    }
+    members = this->members + object->membersIndex;
+    high = object->membersCount;
+
+    /* the first member whose key doesn't sort before the key, so that the first of duplicate keys is found */
+    while (low < high) {
+        middle = low + (high - low) / 2;
+        if (__compareMember(this, key, keyLength, & members[middle], & order) != 0) {
+            return -1;
+        }
+        if (order > 0) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    if ((low == object->membersCount) || (__compareMember(this, key, keyLength, & members[low], & order) != 0) || (order != 0)) {
+        return -1;
+    }
+
+    * valueIndex = members[low].keyIndex + 2;
+
+    return 0;
+}
+
+
+
+
+static unsigned int __fillRecords(LinkedList const * tokens, SnapshotRecord * records, unsigned int tokensCount)
+{
+    unsigned int * openIndexes;
+    unsigned int openCount = 0;
+    unsigned int index;
+    unsigned int stringsSize = 0;
+    JsonToken * token;
+
+    openIndexes = Class->new("unsigned int[]", sizeof(unsigned int) * (tokensCount + 1));
+    if (openIndexes == NULL) {
+        return 0;
+    }
+
+    for (index = 0; tokens != NULL; index++, tokens = _LinkedList->nextElement(tokens)) {
+        token = _LinkedList->getContent(tokens);
+
+        records[index].type = _JsonToken->getType(token);
+        /* the file layout holds 32-bit offsets, strings beyond can't be saved */
+        if (strlen(_JsonToken->getRawString(token)) >= UINT_MAX - stringsSize) {
+            Class->delete((void **) & openIndexes);
+            return 0;
+        }
+        records[index].rawOffset = stringsSize;
+        records[index].rawLength = strlen(_JsonToken->getRawString(token));
+        stringsSize += records[index].rawLength + 1;
+
+        switch (records[index].type) {
+            case JSON_TOKEN_INTEGER:
+                records[index].value.asInteger = _JsonToken->asInteger(token);
+                break;
+            case JSON_TOKEN_FLOAT:
+                records[index].value.asFloat = _JsonToken->asFloat(token);
+                break;
+            case JSON_TOKEN_BOOLEAN:
+                records[index].value.asBoolean = _JsonToken->asBoolean(token);
+                break;
+            case JSON_TOKEN_OPERATOR:
+                records[index].value.asOperator = _JsonToken->asOperator(token);
+                if ((records[index].value.asOperator == JSON_OPERATOR_OBJECT_START) || (records[index].value.asOperator == JSON_OPERATOR_ARRAY_START)) {
+                    openIndexes[openCount] = index;
+                    openCount++;
+                } else if ((openCount > 0) && ((records[index].value.asOperator == JSON_OPERATOR_OBJECT_END) || (records[index].value.asOperator == JSON_OPERATOR_ARRAY_END))) {
+                    openCount--;
+                    records[openIndexes[openCount]].matchIndex = index;
+                }
+                break;
+            default:
+                break;
+        }
+    }
+
+    Class->delete((void **) & openIndexes);
+
+    return stringsSize;
+}
+
+
+static int __fillMembers(Json const * const json, SnapshotRecord * records, unsigned int tokensCount, SnapshotMember * members)
+{
+    SnapshotKey * keys;
+    unsigned int membersCount = 0;
+    unsigned int keysCount;
+    unsigned int objectIndex;
+    unsigned int index;
+    char const * rawString;
+
+    keys = Class->new("SnapshotKey[]", sizeof(SnapshotKey) * (tokensCount + 1));
+    if (keys == NULL) {
+        return -1;
+    }
+
+    for (objectIndex = 0; objectIndex < tokensCount; objectIndex++) {
+        if ((records[objectIndex].type != JSON_TOKEN_OPERATOR) || (records[objectIndex].value.asOperator != JSON_OPERATOR_OBJECT_START)) {
+            continue;
+        }
+
+        /* members are laid out as: key, colon, value, then a comma or the closing curly brace */
+        keysCount = 0;
+        index = objectIndex + 1;
+        while ((index + 2 < tokensCount) && (records[index].type == JSON_TOKEN_STRING)) {
+            rawString = _JsonToken->getRawString(_Json->getToken(json, index));
+            keys[keysCount].key = rawString + 1;
+            keys[keysCount].length = records[index].rawLength - 2;
+            keys[keysCount].keyIndex = index;
+            keysCount++;
+
+            index = index + 2;
+            index = (records[index].matchIndex != 0) ? records[index].matchIndex + 1 : index + 1;
+            if ((index >= tokensCount) || (records[index].type != JSON_TOKEN_OPERATOR) || (records[index].value.asOperator != JSON_OPERATOR_COMMA)) {
+                break;
+            }
+            index++;
+        }
+
+        qsort(keys, keysCount, sizeof(SnapshotKey), __compareKeys);
+
+        records[objectIndex].membersIndex = membersCount;
+        records[objectIndex].membersCount = keysCount;
+        for (index = 0; index < keysCount; index++) {
+            members[membersCount].keyIndex = keys[index].keyIndex;
+            membersCount++;
+        }
+    }
+
+    Class->delete((void **) & keys);
+
+    return membersCount;
+}
+
+
+static int __compareKeys(void const * first, void const * second)
+{
+    SnapshotKey const * firstKey = first;
+    SnapshotKey const * secondKey = second;
+    unsigned int length = (firstKey->length < secondKey->length) ? firstKey->length : secondKey->length;
+    int order = memcmp(firstKey->key, secondKey->key, length);
+
+    if (order != 0) {
+        return order;
+    }
+
+    if (firstKey->length != secondKey->length) {
+        return (firstKey->length < secondKey->length) ? -1 : 1;
+    }
+
+    /* duplicate keys keep their order, the first one being found */
+    return (firstKey->keyIndex < secondKey->keyIndex) ? -1 : 1;
+}
+
+
+static int __compareMember(JsonSnapshot const * const this, char const * const key, unsigned int keyLength, SnapshotMember const * member, int * order)
+{
+    SnapshotRecord const * record = __getRecord(this, member->keyIndex);
+    char const * memberKey = __getRawString(this, record);
+    unsigned int memberLength;
+    unsigned int length;
+
+    if ((memberKey == NULL) || (record->type != JSON_TOKEN_STRING) || (record->rawLength < 2) || (member->keyIndex + 2 >= this->tokensCount)) {
+        return -1;
+    }
+
+    memberKey++;
+    memberLength = record->rawLength - 2;
+    length = (keyLength < memberLength) ? keyLength : memberLength;
+    * order = memcmp(key, memberKey, length);
+
+    if (* order == 0) {
+        * order = (keyLength < memberLength) ? -1 : (keyLength > memberLength);
+    }
+
+    return 0;
+}
+
+
+static SnapshotRecord const * __getRecord(JsonSnapshot const * const this, unsigned int index)
+{
+    if (index >= this->tokensCount) {
+        return NULL;
+    }
+
+    return & this->records[index];
+}
+
+
+static char const * __getRawString(JsonSnapshot const * const this, SnapshotRecord const * record)
+{
+    if ((record == NULL) || (record->rawOffset >= this->stringsSize) || (record->rawLength >= this->stringsSize - record->rawOffset)) {
+        return NULL;
+    }
+
+    if (this->strings[record->rawOffset + record->rawLength] != '\0') {
+        return NULL;
+    }
+
+    return this->strings + record->rawOffset;
+}
+
+
+static int __checkMapping(JsonSnapshot * const this)
+{
+    SnapshotHeader const * header = this->mapping;
+    unsigned long expectedSize;
+
+    if ((memcmp(header->magic, "JSNP", 4) != 0) || (header->version != SNAPSHOT_VERSION)) {
+        return -1;
+    }
+
+    if ((header->byteOrder != SNAPSHOT_BYTE_ORDER) || (header->recordSize != sizeof(SnapshotRecord))) {
+        return -1;
+    }
+
+    /* the sizes are checked against the file, the records themselves are checked as they're read */
+    expectedSize = sizeof(SnapshotHeader) + (unsigned long) header->tokensCount * sizeof(SnapshotRecord) + (unsigned long) header->membersCount * sizeof(SnapshotMember) + header->stringsSize;
+    if (expectedSize != this->mappingSize) {
+        return -1;
+    }
+
+    this->tokensCount = header->tokensCount;
+    this->membersCount = header->membersCount;
+    this->stringsSize = header->stringsSize;
+    this->records = (SnapshotRecord const *) (header + 1);
+    this->members = (SnapshotMember const *) (this->records + this->tokensCount);
+    this->strings = (char const *) (this->members + this->membersCount);
+
+    return 0;
+}
+
+
+static int __isOperator(JsonSnapshot const * const this, unsigned int index, JsonOperator operator)
+{
+    if (index >= this->tokensCount) {
+        return 0;
+    }
+
+    return (this->records[index].type == JSON_TOKEN_OPERATOR) && (this->records[index].value.asOperator == (char) operator);
+}
+
+
+
+
+/**
+ * Init JsonSnapshot methods table
+ */
+static _JsonSnapshotMethods methods = {
+    save,
+    load,
+    delete,
+    size,
+    getType,
+    asInteger,
+    asFloat,
+    asBoolean,
+    asOperator,
+    asString,
+    getRawString,
+    skip,
+    findMember
+};
+_JsonSnapshotMethods const * const _JsonSnapshot = & methods;
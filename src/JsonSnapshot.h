@@ -0,0 +1,170 @@
+#ifndef JSON_SNAPSHOT_HEADER
+#define JSON_SNAPSHOT_HEADER
+
+#include "JsonToken.h"
+#include "Json.h"
+
+
+
+
+/**
+ * A parsed json saved in a binary file, read in place without parsing
+ * The file stores the tokens as fixed-size records with pre-converted values and
+ * offsets into a strings area, so it doesn't depend on the address it's mapped at
+ * The members of each object are listed sorted by key in a members table, for lookups by key
+ * It uses the byte order and type sizes of the machine which wrote it, other ones reject it
+ * Records are checked as they're read, so that a corrupted file can't lead reads out of the mapping
+ */
+typedef struct JsonSnapshot JsonSnapshot;
+
+
+
+
+/**
+ * JsonSnapshot methods table
+ * Tokens are designated by their index, in the order of the json tokens list
+ */
+typedef struct
+{
+    /**
+     * Writes the tokens of a json into a snapshot file
+     * 
+     * @param json - the json to save
+     * @param path - the path of the file to write
+     * 
+     * @return - 0 on success, -1 on failure
+     */
+    int (* save)(Json const * const json, char const * const path);
+
+    /**
+     * Constructor, maps a snapshot file in memory, in constant time
+     * 
+     * @param path - the path of the file to read
+     * 
+     * @return - a JsonSnapshot instance if the file is a valid snapshot and mapping succeeds, NULL otherwise
+     */
+    JsonSnapshot * (* load)(char const * const path);
+
+    /**
+     * Destructor, unmaps the file and sets the pointer to NULL
+     * 
+     * @param this - pointer to the instance to delete
+     */
+    void (* delete)(JsonSnapshot ** this);
+
+    /**
+     * Returns the number of tokens
+     * 
+     * @param this - the snapshot to get the number of tokens of
+     * 
+     * @return - the number of tokens
+     */
+    unsigned int (* size)(JsonSnapshot const * const this);
+
+    /**
+     * Returns the type of a token
+     * 
+     * @param this - the snapshot to read
+     * @param index - the index of the token
+     * 
+     * @return - the type of the token, -1 if the index is out of range
+     */
+    JsonTokenType (* getType)(JsonSnapshot const * const this, unsigned int index);
+
+    /**
+     * Evaluates a token as an integer
+     * 
+     * @param this - the snapshot to read
+     * @param index - the index of the token
+     * 
+     * @return - the integer value stored in the token, 0 if the index is out of range
+     */
+    JsonIntegerValue (* asInteger)(JsonSnapshot const * const this, unsigned int index);
+
+    /**
+     * Evaluates a token as a float
+     * 
+     * @param this - the snapshot to read
+     * @param index - the index of the token
+     * 
+     * @return - the float value stored in the token, 0 if the index is out of range
+     */
+    JsonFloatValue (* asFloat)(JsonSnapshot const * const this, unsigned int index);
+
+    /**
+     * Evaluates a token as a boolean
+     * 
+     * @param this - the snapshot to read
+     * @param index - the index of the token
+     * 
+     * @return - the boolean value stored in the token, 0 if the index is out of range
+     */
+    JsonBooleanValue (* asBoolean)(JsonSnapshot const * const this, unsigned int index);
+
+    /**
+     * Evaluates a token as an operator
+     * 
+     * @param this - the snapshot to read
+     * @param index - the index of the token
+     * 
+     * @return - the operator stored in the token, '\0' if the index is out of range
+     */
+    JsonOperatorValue (* asOperator)(JsonSnapshot const * const this, unsigned int index);
+
+    /**
+     * Evaluates a token as a string
+     * 
+     * @param this - the snapshot to read
+     * @param index - the index of the token
+     * 
+     * @return - the read-only string value stored in the token, NULL if the index or the string is out of range
+     */
+    char const * (* asString)(JsonSnapshot const * const this, unsigned int index);
+
+    /**
+     * Returns the raw string a token represents
+     * 
+     * @param this - the snapshot to read
+     * @param index - the index of the token
+     * 
+     * @return - the read-only raw string the token represents, NULL if the index or the string is out of range
+     */
+    char const * (* getRawString)(JsonSnapshot const * const this, unsigned int index);
+
+    /**
+     * Returns the index of the token following a value, in constant time
+     * 
+     * @param this - the snapshot to read
+     * @param index - the index of the first token of the value
+     * 
+     * @return - the index following the last token of the value, the number of tokens if the value is out of range
+     */
+    unsigned int (* skip)(JsonSnapshot const * const this, unsigned int index);
+
+    /**
+     * Finds the value of an object member, in logarithmic time through the members table
+     * Keys are matched as written, json escapes aren't decoded, the first of duplicate keys is found
+     * 
+     * @param this - the snapshot to read
+     * @param objectIndex - the index of the opening curly brace of the object
+     * @param key - the key of the member, without quotes
+     * @param valueIndex - where to store the index of the value
+     * 
+     * @return - 0 if the member was found, -1 otherwise
+     */
+    int (* findMember)(JsonSnapshot const * const this, unsigned int objectIndex, char const * const key, unsigned int * valueIndex);
+
+} _JsonSnapshotMethods;
+
+
+
+
+/**
+ * JsonSnapshot class methods table
+ */
+extern _JsonSnapshotMethods const * const _JsonSnapshot;
+
+
+
+
+#endif /* JSON_SNAPSHOT_HEADER */
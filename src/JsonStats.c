@@ -0,0 +1,195 @@
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "JsonToken.h"
+#include "JsonStats.h"
+
+
+
+
+/**
+ * Stats aggregated over every recorded parse
+ */
+static JsonStats globalStats;
+
+
+/**
+ * Stats of the parse being recorded, NULL if none
+ */
+static JsonStats * currentStats = NULL;
+
+
+/**
+ * Start time of each running stage, in nanoseconds
+ */
+static unsigned long stageStarts[JSON_STAGES_COUNT];
+
+
+/**
+ * Nesting depth of the parse being recorded
+ */
+static unsigned long currentDepth = 0;
+
+
+
+
+/**
+ * Reads the monotonic clock
+ *
+ * @return - the current time, in nanoseconds
+ */
+static unsigned long __now(void);
+
+
+/**
+ * Returns the stats recordings should go to
+ *
+ * @return - the stats of the current parse if any, the process-wide ones otherwise
+ */
+static JsonStats * __target(void);
+
+
+
+
+static void begin(JsonStats * stats)
+{
+    memset(stats, 0, sizeof(* stats));
+    currentStats = stats;
+    currentDepth = 0;
+}
+
+
+static void end(void)
+{
+    unsigned int index;
+
+    if (currentStats == NULL) {
+        return;
+    }
+
+    globalStats.parses++;
+    for (index = 0; index < JSON_STAGES_COUNT; index++) {
+        globalStats.stageNanoseconds[index] += currentStats->stageNanoseconds[index];
+    }
+    globalStats.allocations += currentStats->allocations;
+    globalStats.allocatedBytes += currentStats->allocatedBytes;
+    for (index = 0; index < JSON_STATS_TOKEN_TYPES; index++) {
+        globalStats.tokensByType[index] += currentStats->tokensByType[index];
+    }
+    if (currentStats->maximumDepth > globalStats.maximumDepth) {
+        globalStats.maximumDepth = currentStats->maximumDepth;
+    }
+
+    currentStats->parses = 1;
+    currentStats = NULL;
+}
+
+
+static void startStage(JsonStage stage)
+{
+    stageStarts[stage] = __now();
+}
+
+
+static void stopStage(JsonStage stage)
+{
+    __target()->stageNanoseconds[stage] += __now() - stageStarts[stage];
+}
+
+
+static void countAllocation(unsigned long bytes)
+{
+    JsonStats * stats = __target();
+
+    stats->allocations++;
+    stats->allocatedBytes += bytes;
+}
+
+
+static void countToken(JsonToken const * const token)
+{
+    JsonStats * stats = __target();
+    JsonTokenType type = _JsonToken->getType(token);
+
+    stats->tokensByType[type]++;
+
+    if (type != JSON_TOKEN_OPERATOR) {
+        return;
+    }
+
+    switch (_JsonToken->asOperator(token)) {
+        case JSON_OPERATOR_OBJECT_START:
+        case JSON_OPERATOR_ARRAY_START:
+            currentDepth++;
+            if (currentDepth > stats->maximumDepth) {
+                stats->maximumDepth = currentDepth;
+            }
+            break;
+        case JSON_OPERATOR_OBJECT_END:
+        case JSON_OPERATOR_ARRAY_END:
+            if (currentDepth > 0) {
+                currentDepth--;
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+
+static JsonStats const * getGlobal(void)
+{
+    return & globalStats;
+}
+
+
+static void resetGlobal(void)
+{
+    memset(& globalStats, 0, sizeof(globalStats));
+}
+
+
+
+
+static unsigned long __now(void)
+{
+    struct timespec time;
+
+    if (clock_gettime(CLOCK_MONOTONIC, & time) != 0) {
+        return 0;
+    }
+
+    return (unsigned long) time.tv_sec * 1000000000UL + (unsigned long) time.tv_nsec;
+}
+
+
+static JsonStats * __target(void)
+{
+    if (currentStats != NULL) {
+        return currentStats;
+    }
+
+    return & globalStats;
+}
+
+
+
+
+/**
+ * Init JsonStats methods table
+ */
+static _JsonStatsMethods methods = {
+    begin,
+    end,
+    startStage,
+    stopStage,
+    countAllocation,
+    countToken,
+    getGlobal,
+    resetGlobal
+};
+_JsonStatsMethods const * const _JsonStats = & methods;
@@ -0,0 +1,160 @@
+#ifndef JSON_STATS_HEADER
+#define JSON_STATS_HEADER
+
+#include "JsonToken.h"
+
+
+
+
+/**
+ * Number of distinct token types counted by the stats
+ */
+#define JSON_STATS_TOKEN_TYPES (JSON_TOKEN_NULL + 1)
+
+
+/**
+ * Parsing stages which are timed
+ */
+typedef enum
+{
+    JSON_STAGE_EXTRACT,
+    JSON_STAGE_TOKEN,
+    JSON_STAGE_APPEND,
+    JSON_STAGES_COUNT
+} JsonStage;
+
+
+/**
+ * Counters gathered while parsing, either for a single json or process-wide
+ */
+typedef struct
+{
+    /**
+     * Number of parses folded into these stats
+     */
+    unsigned long parses;
+
+    /**
+     * Time spent in each stage, in nanoseconds
+     */
+    unsigned long stageNanoseconds[JSON_STAGES_COUNT];
+
+    /**
+     * Number of memory blocks allocated
+     */
+    unsigned long allocations;
+
+    /**
+     * Total size of the allocated memory blocks, in bytes
+     */
+    unsigned long allocatedBytes;
+
+    /**
+     * Number of tokens created, indexed by JsonTokenType
+     */
+    unsigned long tokensByType[JSON_STATS_TOKEN_TYPES];
+
+    /**
+     * Deepest nesting of objects and arrays encountered
+     */
+    unsigned long maximumDepth;
+
+} JsonStats;
+
+
+
+
+/**
+ * JsonStats methods table
+ * Recording is single-threaded: only one parse may be recorded at a time
+ */
+typedef struct
+{
+    /**
+     * Clears the stats and makes them the target of further recordings
+     *
+     * @param stats - the stats to record into
+     */
+    void (* begin)(JsonStats * stats);
+
+    /**
+     * Stops recording into the current stats, and adds them to the process-wide ones
+     */
+    void (* end)(void);
+
+    /**
+     * Starts the timer of a stage
+     *
+     * @param stage - the stage being entered
+     */
+    void (* startStage)(JsonStage stage);
+
+    /**
+     * Stops the timer of a stage, and adds the elapsed time to the stats
+     *
+     * @param stage - the stage being left
+     */
+    void (* stopStage)(JsonStage stage);
+
+    /**
+     * Counts an allocated memory block
+     *
+     * @param bytes - the size of the allocated block
+     */
+    void (* countAllocation)(unsigned long bytes);
+
+    /**
+     * Counts a created token, and tracks the nesting depth from operators
+     *
+     * @param token - the created token
+     */
+    void (* countToken)(JsonToken const * const token);
+
+    /**
+     * Returns the stats aggregated over every recorded parse
+     *
+     * @return - the process-wide stats
+     */
+    JsonStats const * (* getGlobal)(void);
+
+    /**
+     * Clears the process-wide stats
+     */
+    void (* resetGlobal)(void);
+
+} _JsonStatsMethods;
+
+
+
+
+/**
+ * JsonStats class methods table
+ */
+extern _JsonStatsMethods const * const _JsonStats;
+
+
+
+
+/**
+ * Recording hooks used on the hot paths, only compiled with JSON_INSTRUMENTATION
+ */
+#ifdef JSON_INSTRUMENTATION
+    #define JSON_STATS_BEGIN(stats) _JsonStats->begin(stats)
+    #define JSON_STATS_END() _JsonStats->end()
+    #define JSON_STATS_START(stage) _JsonStats->startStage(stage)
+    #define JSON_STATS_STOP(stage) _JsonStats->stopStage(stage)
+    #define JSON_STATS_ALLOCATION(bytes) _JsonStats->countAllocation(bytes)
+    #define JSON_STATS_TOKEN(token) _JsonStats->countToken(token)
+#else
+    #define JSON_STATS_BEGIN(stats) ((void) 0)
+    #define JSON_STATS_END() ((void) 0)
+    #define JSON_STATS_START(stage) ((void) 0)
+    #define JSON_STATS_STOP(stage) ((void) 0)
+    #define JSON_STATS_ALLOCATION(bytes) ((void) 0)
+    #define JSON_STATS_TOKEN(token) ((void) 0)
+#endif
+
+
+
+
+#endif /* JSON_STATS_HEADER */
@@ -4,104 +4,154 @@
 #include <string.h>
 
 #include "Class.h"
+#include "Pool.h"
 #include "JsonToken.h"
 
 
 
 
 /**
- * A json value
+ * Size of a cache line, the boundary pooled tokens start on
  */
-typedef union
-{
-    JsonIntegerValue asInteger;
-    JsonFloatValue asFloat;
-    JsonBooleanValue asBoolean;
-    JsonStringValue asString;
-    JsonOperatorValue asOperator; 
-} JsonValue;
+#define JSON_TOKEN_CACHE_LINE_SIZE 64
 
 
-struct JsonToken
-{
-    /**
-     * The type of the token
-     */
-    JsonTokenType type;
+/**
+ * Whether numbers are converted on first access rather than on creation
+ */
+static int lazyNumbers = 0;
 
-    /**
-     * The value stored in the token
-     */
-    JsonValue value;
 
-    /**
-     * The raw string that was used to create the token
-     */
-    char * rawString;
-};
 
 
+/**
+ * Classes of characters the token-strings are made of
+ */
+typedef enum
+{
+    CHAR_OTHER,
+    CHAR_DIGIT,
+    CHAR_MINUS,
+    CHAR_PLUS,
+    CHAR_DOT,
+    CHAR_EXPONENT,
+    CHAR_QUOTE,
+    CHAR_BACKSLASH,
+    CHAR_OPERATOR,
+    CHAR_CLASSES_COUNT
+} CharClass;
 
 
 /**
- * Checks if the given token-string is a valid json operator
- * 
- * @param string - the token-string to check
- * 
- * @return - 1 if the token-string is a valid json operator, 0 otherwise
+ * States of the token-string classifier
  */
-static int __isOperatorToken(char const * const string);
+typedef enum
+{
+    STATE_START,
+    STATE_OPERATOR,
+    STATE_SIGN,
+    STATE_INTEGER,
+    STATE_DOT,
+    STATE_FRACTION,
+    STATE_EXPONENT,
+    STATE_EXPONENT_SIGN,
+    STATE_EXPONENT_DIGITS,
+    STATE_STRING,
+    STATE_ESCAPE,
+    STATE_STRING_END,
+    STATE_ERROR,
+    STATES_COUNT
+} ClassifierState;
 
 
 /**
- * Checks if the given token-string is a valid json litteral boolean
- * 
- * @param string - the token-string to check
- * 
- * @return - 1 if the token-string is a valid json litteral boolean, 0 otherwise
+ * Class of every character
  */
-static int __isBooleanToken(char const * const string);
+static unsigned char const charClasses[256] = {
+    /* 0x00 */ CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER,
+    /* 0x10 */ CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER,
+    /* 0x20 */ CHAR_OTHER, CHAR_OTHER, CHAR_QUOTE, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_PLUS, CHAR_OPERATOR, CHAR_MINUS, CHAR_DOT, CHAR_OTHER,
+    /* 0x30 */ CHAR_DIGIT, CHAR_DIGIT, CHAR_DIGIT, CHAR_DIGIT, CHAR_DIGIT, CHAR_DIGIT, CHAR_DIGIT, CHAR_DIGIT, CHAR_DIGIT, CHAR_DIGIT, CHAR_OPERATOR, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER,
+    /* 0x40 */ CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_EXPONENT, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER,
+    /* 0x50 */ CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OPERATOR, CHAR_BACKSLASH, CHAR_OPERATOR, CHAR_OTHER, CHAR_OTHER,
+    /* 0x60 */ CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_EXPONENT, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER,
+    /* 0x70 */ CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OPERATOR, CHAR_OTHER, CHAR_OPERATOR, CHAR_OTHER, CHAR_OTHER,
+    /* 0x80 */ CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER,
+    /* 0x90 */ CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER,
+    /* 0xA0 */ CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER,
+    /* 0xB0 */ CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER,
+    /* 0xC0 */ CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER,
+    /* 0xD0 */ CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER,
+    /* 0xE0 */ CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER,
+    /* 0xF0 */ CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER, CHAR_OTHER
+};
 
 
 /**
- * Checks if the given token-string is a valid json litteral integer
- * 
- * @param string - the token-string to check
- * 
- * @return - 1 if the token-string is a valid json litteral integer, 0 otherwise
+ * Next classifier state, from the current state and the class of the next character
  */
-static int __isIntegerToken(char const * const string);
+static unsigned char const transitions[STATES_COUNT][CHAR_CLASSES_COUNT] = {
+    /*                          OTHER        DIGIT                  MINUS                PLUS                 DOT           EXPONENT        QUOTE             BACKSLASH     OPERATOR */
+    /* START */               { STATE_ERROR, STATE_INTEGER,         STATE_SIGN,          STATE_ERROR,         STATE_ERROR,  STATE_ERROR,    STATE_STRING,     STATE_ERROR,  STATE_OPERATOR },
+    /* OPERATOR */            { STATE_ERROR, STATE_ERROR,           STATE_ERROR,         STATE_ERROR,         STATE_ERROR,  STATE_ERROR,    STATE_ERROR,      STATE_ERROR,  STATE_ERROR },
+    /* SIGN */                { STATE_ERROR, STATE_INTEGER,         STATE_ERROR,         STATE_ERROR,         STATE_ERROR,  STATE_ERROR,    STATE_ERROR,      STATE_ERROR,  STATE_ERROR },
+    /* INTEGER */             { STATE_ERROR, STATE_INTEGER,         STATE_ERROR,         STATE_ERROR,         STATE_DOT,    STATE_EXPONENT, STATE_ERROR,      STATE_ERROR,  STATE_ERROR },
+    /* DOT */                 { STATE_ERROR, STATE_FRACTION,        STATE_ERROR,         STATE_ERROR,         STATE_ERROR,  STATE_ERROR,    STATE_ERROR,      STATE_ERROR,  STATE_ERROR },
+    /* FRACTION */            { STATE_ERROR, STATE_FRACTION,        STATE_ERROR,         STATE_ERROR,         STATE_ERROR,  STATE_EXPONENT, STATE_ERROR,      STATE_ERROR,  STATE_ERROR },
+    /* EXPONENT */            { STATE_ERROR, STATE_EXPONENT_DIGITS, STATE_EXPONENT_SIGN, STATE_EXPONENT_SIGN, STATE_ERROR,  STATE_ERROR,    STATE_ERROR,      STATE_ERROR,  STATE_ERROR },
+    /* EXPONENT_SIGN */       { STATE_ERROR, STATE_EXPONENT_DIGITS, STATE_ERROR,         STATE_ERROR,         STATE_ERROR,  STATE_ERROR,    STATE_ERROR,      STATE_ERROR,  STATE_ERROR },
+    /* EXPONENT_DIGITS */     { STATE_ERROR, STATE_EXPONENT_DIGITS, STATE_ERROR,         STATE_ERROR,         STATE_ERROR,  STATE_ERROR,    STATE_ERROR,      STATE_ERROR,  STATE_ERROR },
+    /* STRING */              { STATE_STRING, STATE_STRING,         STATE_STRING,        STATE_STRING,        STATE_STRING, STATE_STRING,   STATE_STRING_END, STATE_ESCAPE, STATE_STRING },
+    /* ESCAPE */              { STATE_STRING, STATE_STRING,         STATE_STRING,        STATE_STRING,        STATE_STRING, STATE_STRING,   STATE_STRING,     STATE_STRING, STATE_STRING },
+    /* STRING_END */          { STATE_ERROR, STATE_ERROR,           STATE_ERROR,         STATE_ERROR,         STATE_ERROR,  STATE_ERROR,    STATE_ERROR,      STATE_ERROR,  STATE_ERROR },
+    /* ERROR */               { STATE_ERROR, STATE_ERROR,           STATE_ERROR,         STATE_ERROR,         STATE_ERROR,  STATE_ERROR,    STATE_ERROR,      STATE_ERROR,  STATE_ERROR }
+};
 
 
 /**
- * Checks if the given token-string is a valid json litteral float
- * 
- * @param string - the token-string to check
- * 
- * @return - 1 if the token-string is a valid json litteral float, 0 otherwise
+ * Type of the token-string, from the state the classifier ends in (-1 if the state isn't accepting)
  */
-static int __isFloatToken(char const * const string);
+static int const acceptedTypes[STATES_COUNT] = {
+    -1,
+    JSON_TOKEN_OPERATOR,
+    -1,
+    JSON_TOKEN_INTEGER,
+    -1,
+    JSON_TOKEN_FLOAT,
+    -1,
+    -1,
+    JSON_TOKEN_FLOAT,
+    -1,
+    -1,
+    JSON_TOKEN_STRING,
+    -1
+};
+
+
 
 
 /**
- * Checks if the given token-string is a valid json string
+ * Checks if the string starts with a json litteral boolean or null
  * 
- * @param string - the token-string to check
+ * @param string - the string to check
+ * @param maxLength - the length of the string
+ * @param length - where to store the length of the litteral
  * 
- * @return - 1 if the token-string is a valid json string, 0 otherwise
+ * @return - JSON_TOKEN_BOOLEAN or JSON_TOKEN_NULL if the string starts with such a litteral, -1 otherwise
  */
-static int __isStringToken(char const * const string);
+static int __startsWithKeyword(char const * const string, size_t maxLength, size_t * length);
 
 
 /**
- * Determines which type correspond to the string
+ * Determines which type correspond to the string, in a single scan
  * If string is not a valid token, returns -1
  * 
  * @param string - the token-string to get type for
+ * @param length - the length of the token-string
  * 
  * @return - corresponding JsonTokenType if valid, -1 otherwise
  */
-static JsonTokenType __getTokenType(char const * const string);
+static JsonTokenType __getTokenType(char const * const string, size_t length);
 
 
 /**
@@ -116,33 +166,72 @@ static JsonTokenType __getTokenType(char const * const string);
 static JsonValue __parseValue(JsonTokenType type, char * const string);
 
 
+/**
+ * Converts the value from the raw string, if not done yet
+ * The value is a cache of the raw string, so the token is logically left untouched
+ * 
+ * @param this - the token to convert the value of
+ */
+static void __convertValue(JsonToken const * const this);
+
+
 
 
 static JsonToken * new(char const * const string)
+{
+    if (string == NULL) {
+        return NULL;
+    }
+
+    return _JsonToken->newWithLength(string, strlen(string));
+}
+
+
+static JsonToken * newWithLength(char const * const string, size_t length)
+{
+    return _JsonToken->newInPool(NULL, string, length, lazyNumbers);
+}
+
+
+static JsonToken * newInPool(Pool * const pool, char const * const string, size_t length, int lazyNumbers)
 {
     JsonToken * this;
+    JsonTokenType type;
 
     if (string == NULL) {
         return NULL;
     }
 
-    this = Class->new("JsonToken", sizeof(* this));
+    type = __getTokenType(string, length);
+    if ((int) type == -1) {
+        return NULL;
+    }
+
+    if (pool != NULL) {
+        this = _Pool->take(pool);
+    } else {
+        this = Class->new("JsonToken", sizeof(* this));
+    }
 
     if (this != NULL) {
-        this->type = __getTokenType(string);
-        if ((int) this->type == -1) {
-            _JsonToken->delete(& this);
-            return NULL;
+        this->type = type;
+
+        if (length < JSON_TOKEN_SHORT_STRING_SIZE) {
+            this->rawString = this->shortString;
+        } else {
+            /* pooled tokens belong to a document, whose allocator also sees their strings */
+            this->rawString = Class->newWithAllocator((pool != NULL) ? _Pool->getAllocator(pool) : Class->getAllocator(), "JsonString", length + 1);
+            if (this->rawString == NULL) {
+                _JsonToken->deleteInPool(pool, & this);
+                return NULL;    
+            }
         }
+        memcpy(this->rawString, string, length);
+        this->rawString[length] = '\0';
 
-        this->rawString = calloc(strlen(string + 1), 1);
-        if (this->rawString == NULL) {
-            _JsonToken->delete(& this);
-            return NULL;    
+        if (! lazyNumbers || ((type != JSON_TOKEN_INTEGER) && (type != JSON_TOKEN_FLOAT))) {
+            __convertValue(this);
         }
-        strncpy(this->rawString, string, strlen(string));
-        
-        this->value = __parseValue(this->type, this->rawString);
     }
 
     return this;
@@ -150,17 +239,27 @@ static JsonToken * new(char const * const string)
 
 
 static void delete(JsonToken ** this)
+{
+    _JsonToken->deleteInPool(NULL, this);
+}
+
+
+static void deleteInPool(Pool * const pool, JsonToken ** this)
 {
     if ((this == NULL) || (* this == NULL)) {
         return;
     }
 
-    if ((* this)->rawString) {
-        free((* this)->rawString);
-        (* this)->rawString = NULL;
+    if ((* this)->rawString != (* this)->shortString) {
+        Class->deleteWithAllocator((pool != NULL) ? _Pool->getAllocator(pool) : Class->getAllocator(), (void **) & (* this)->rawString);
     }
 
-    Class->delete((void **) this);
+    if (pool != NULL) {
+        _Pool->give(pool, * this);
+        * this = NULL;
+    } else {
+        Class->delete((void **) this);
+    }
 }
 
 
@@ -172,12 +271,16 @@ static JsonTokenType getType(JsonToken const * const this)
 
 static JsonIntegerValue asInteger(JsonToken const * const this)
 {
+    __convertValue(this);
+
     return this->value.asInteger;
 }
 
 
 static JsonFloatValue asFloat(JsonToken const * const this)
 {
+    __convertValue(this);
+
     return this->value.asFloat;
 }
 
@@ -206,135 +309,106 @@ static char const * getRawString(JsonToken const * const this)
 }
 
 
-
-
-static int __isOperatorToken(char const * const string)
+static char const * getRawNumber(JsonToken const * const this)
 {
-    if (strlen(string) == 1) {
-        switch (string[0]) {
-            case JSON_OPERATOR_OBJECT_START:
-            case JSON_OPERATOR_OBJECT_END:
-            case JSON_OPERATOR_ARRAY_START:
-            case JSON_OPERATOR_ARRAY_END:
-            case JSON_OPERATOR_COLON:
-            case JSON_OPERATOR_COMMA:
-                return 1;
-            default:
-                return 0;
-        }
+    if ((this->type != JSON_TOKEN_INTEGER) && (this->type != JSON_TOKEN_FLOAT)) {
+        return NULL;
     }
 
-    return 0;
+    return this->rawString;
 }
 
 
-static int __isBooleanToken(char const * const string)
+static void setNumber(JsonToken * const this, JsonValue value)
 {
-    return (strcmp(string, "false") == 0) || (strcmp(string, "true") == 0);
+    if (this->isConverted || ((this->type != JSON_TOKEN_INTEGER) && (this->type != JSON_TOKEN_FLOAT))) {
+        return;
+    }
+
+    this->value = value;
+    this->isConverted = 1;
 }
 
 
-static int __isIntegerToken(char const * const string)
+static int useLazyNumbers(int enabled)
 {
-    unsigned int index;
-    int signsFound = 0;
-
-    for (index = 0; string[index] != '\0'; index++) {
-        if (string[index] == '-') {
-            signsFound++;
-        } else if (string[index] < '0') {
-            return 0;
-        } else if (string[index] > '9') {
-            return 0;
-        }
-    }
+    int previouslyEnabled = lazyNumbers;
 
-    if (signsFound) {
-        return (signsFound == 1) && (string[0] == '-');
-    }
+    lazyNumbers = enabled;
 
-    return 1;
+    return previouslyEnabled;
 }
 
 
-static int __isFloatToken(char const * const string)
+static JsonTokenType scan(char const * const string, size_t maxLength, size_t * length)
 {
-    unsigned int index;
-    int signsFound = 0;
-    int dotsFounds = 0;
-    int dotPosition = 0;
-
-    for (index = 0; string[index] != '\0'; index++) {
-        if (string[index] == '-') {
-            signsFound++;
-        } else if (string[index] == '.') {
-            dotsFounds++;
-            dotPosition = index;
-        } else if (string[index] < '0') {
-            return 0;
-        } else if (string[index] > '9') {
-            return 0;
-        }
+    size_t index;
+    unsigned char state = STATE_START;
+    int type;
+
+    * length = 0;
+
+    type = __startsWithKeyword(string, maxLength, length);
+    if (type != -1) {
+        return type;
     }
 
-    if (dotsFounds != 1) {
-        return 0;
-    } else if (signsFound > 1) {
-        return 0;
-    } else if (signsFound) {
-        return (string[0] == '-') && (dotPosition >= 2);
+    for (index = 0; index < maxLength; index++) {
+        state = transitions[state][charClasses[(unsigned char) string[index]]];
+        if (state == STATE_ERROR) {
+            break;
+        }
+
+        if (acceptedTypes[state] != -1) {
+            type = acceptedTypes[state];
+            * length = index + 1;
+        }
     }
 
-    return dotPosition >= 1;
+    return type;
 }
 
 
-static int __isStringToken(char const * const string)
+static Pool * newPool(Allocator const * allocator)
 {
-    unsigned int index;
-    unsigned int stringLenght = strlen(string);
-
-    if ((string[0] != '"') || (string[stringLenght - 1] != '"')) {
-        return 0;
-    }
+    return _Pool->newWithAlignment(sizeof(JsonToken), JSON_TOKEN_CACHE_LINE_SIZE, allocator);
+}
 
-    for (index = 1; index < stringLenght - 1; index++) {
-        if ((string[index] == '"') && (string[index - 1] != '\\')) {
-            return 0;
-        }
-    }
 
-    return strlen(string) > 1;
-}
 
 
-static JsonTokenType __getTokenType(char const * const string)
+static int __startsWithKeyword(char const * const string, size_t maxLength, size_t * length)
 {
-    if (string == NULL) {
-        return -1;
-    }
-    
-    if (__isOperatorToken(string)) {
-        return JSON_TOKEN_OPERATOR;
+    if ((maxLength >= 4) && (memcmp(string, "true", 4) == 0)) {
+        * length = 4;
+        return JSON_TOKEN_BOOLEAN;
     }
 
-    if (__isBooleanToken(string)) {
+    if ((maxLength >= 5) && (memcmp(string, "false", 5) == 0)) {
+        * length = 5;
         return JSON_TOKEN_BOOLEAN;
     }
 
-    if (__isIntegerToken(string)) {
-        return JSON_TOKEN_INTEGER;
+    if ((maxLength >= 4) && (memcmp(string, "null", 4) == 0)) {
+        * length = 4;
+        return JSON_TOKEN_NULL;
     }
 
-    if (__isFloatToken(string)) {
-        return JSON_TOKEN_FLOAT;
-    }
+    return -1;
+}
+
+
+static JsonTokenType __getTokenType(char const * const string, size_t length)
+{
+    size_t scannedLength;
+    JsonTokenType type;
 
-    if (__isStringToken(string)) {
-        return JSON_TOKEN_STRING;
+    type = scan(string, length, & scannedLength);
+    if (scannedLength != length) {
+        return -1;
     }
 
-    return -1;
+    return type;
 }
 
 
@@ -343,18 +417,15 @@ static JsonValue __parseValue(JsonTokenType type, char * const string)
     JsonValue parsedValue;
 
     switch (type) {
+        /* out of range numbers saturate, where atol and atof are undefined, their exact digits staying in the raw string */
         case JSON_TOKEN_INTEGER:
-            parsedValue.asInteger = atol(string);
+            parsedValue.asInteger = strtol(string, NULL, 10);
             break;
         case JSON_TOKEN_FLOAT:
-            parsedValue.asFloat = atof(string);
+            parsedValue.asFloat = strtod(string, NULL);
             break;
         case JSON_TOKEN_BOOLEAN:
-            if (strcmp("false", string) == 0) {
-                parsedValue.asBoolean = 0;
-            } else {
-                parsedValue.asBoolean = 1;
-            }
+            parsedValue.asBoolean = (string[0] == 't');
             break;
         case JSON_TOKEN_OPERATOR:
             parsedValue.asOperator = string[0];
@@ -362,6 +433,9 @@ static JsonValue __parseValue(JsonTokenType type, char * const string)
         case JSON_TOKEN_STRING:
             parsedValue.asString = string;
             break;
+        case JSON_TOKEN_NULL:
+            parsedValue.asString = NULL;
+            break;
         /* we don't handle default case, type is supposed to be valid */
     }
 
@@ -369,6 +443,19 @@ static JsonValue __parseValue(JsonTokenType type, char * const string)
 }
 
 
+static void __convertValue(JsonToken const * const this)
+{
+    JsonToken * convertedToken = (JsonToken *) this;
+
+    if (this->isConverted) {
+        return;
+    }
+
+    convertedToken->value = __parseValue(this->type, this->rawString);
+    convertedToken->isConverted = 1;
+}
+
+
 
 
 /**
@@ -376,13 +463,21 @@ static JsonValue __parseValue(JsonTokenType type, char * const string)
  */
 static _JsonTokenMethods methods = {
     new,
+    newWithLength,
+    newInPool,
     delete,
+    deleteInPool,
     getType,
     asInteger,
     asFloat,
     asBoolean,
     asOperator,
     asString,
-    getRawString
+    getRawString,
+    getRawNumber,
+    setNumber,
+    useLazyNumbers,
+    scan,
+    newPool
 };
 _JsonTokenMethods const * const _JsonToken = & methods;
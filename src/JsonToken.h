@@ -2,6 +2,8 @@
 #ifndef JSON_TOKEN_HEADER
 #define JSON_TOKEN_HEADER
 
+#include "Pool.h"
+
 
 
 
@@ -58,7 +60,8 @@ typedef enum
     JSON_TOKEN_FLOAT,
     JSON_TOKEN_STRING,
     JSON_TOKEN_OPERATOR,
-    JSON_TOKEN_BOOLEAN
+    JSON_TOKEN_BOOLEAN,
+    JSON_TOKEN_NULL
 } JsonTokenType;
 
 
@@ -68,6 +71,70 @@ typedef enum
 typedef struct JsonToken JsonToken;
 
 
+/**
+ * Size of the buffer holding short raw strings inside the token, so that a token fills a single cache line
+ */
+#define JSON_TOKEN_SHORT_STRING_SIZE 40
+
+
+/**
+ * A json value
+ */
+typedef union
+{
+    JsonIntegerValue asInteger;
+    JsonFloatValue asFloat;
+    JsonBooleanValue asBoolean;
+    JsonStringValue asString;
+    JsonOperatorValue asOperator; 
+} JsonValue;
+
+
+/**
+ * Layout of a token, only exposed for the accessor macros, use the methods table otherwise
+ */
+struct JsonToken
+{
+    /**
+     * The type of the token
+     */
+    JsonTokenType type;
+
+    /**
+     * Whether the value was converted from the raw string yet
+     */
+    char isConverted;
+
+    /**
+     * The value stored in the token
+     */
+    JsonValue value;
+
+    /**
+     * The raw string that was used to create the token, pointing to shortString if it fits there
+     */
+    char * rawString;
+
+    /**
+     * The raw string if it's shorter than the buffer, sparing an allocation for most keys, numbers and operators
+     */
+    char shortString[JSON_TOKEN_SHORT_STRING_SIZE];
+};
+
+
+/**
+ * Accessors expanding to direct loads in tight loops, the same as the methods of the same name
+ * Numbers converted lazily are converted through the methods table, the token being evaluated twice
+ */
+#define JSON_TOKEN_GET_TYPE(token) ((token)->type)
+#define JSON_TOKEN_GET_RAW_STRING(token) ((char const *) (token)->rawString)
+#define JSON_TOKEN_AS_BOOLEAN(token) ((token)->value.asBoolean)
+#define JSON_TOKEN_AS_OPERATOR(token) ((token)->value.asOperator)
+#define JSON_TOKEN_AS_STRING(token) ((token)->value.asString)
+#define JSON_TOKEN_AS_INTEGER(token) ((token)->isConverted ? (token)->value.asInteger : _JsonToken->asInteger(token))
+#define JSON_TOKEN_AS_FLOAT(token) ((token)->isConverted ? (token)->value.asFloat : _JsonToken->asFloat(token))
+
+
 
 
 /**
@@ -84,6 +151,29 @@ typedef struct
      */
     JsonToken * (* new)(char const * const string);
 
+    /**
+     * Constructor from a token-string which isn't NUL-terminated
+     * 
+     * @param string - the start of the string representation of the token
+     * @param length - the length of the string representation of the token
+     * 
+     * @return - a JsonToken instance if the token-string is valid and allocation succeeds, NULL otherwise
+     */
+    JsonToken * (* newWithLength)(char const * const string, size_t length);
+
+    /**
+     * Constructor taking the token from a pool, for documents owning their tokens
+     * Nothing global is read, so that documents may be parsed on several threads
+     * 
+     * @param pool - the pool to take the token from, its allocator also allocating long raw strings, NULL to allocate the token alone
+     * @param string - the start of the string representation of the token
+     * @param length - the length of the string representation of the token
+     * @param lazyNumbers - 1 to convert numbers on first access, 0 to convert them on creation
+     * 
+     * @return - a JsonToken instance if the token-string is valid and allocation succeeds, NULL otherwise
+     */
+    JsonToken * (* newInPool)(Pool * const pool, char const * const string, size_t length, int lazyNumbers);
+
     /**
      * Destructor, sets the pointer to NULL
      * 
@@ -91,6 +181,14 @@ typedef struct
      */
     void (* delete)(JsonToken ** this);
 
+    /**
+     * Destructor of a token taken from a pool, gives it back and sets the pointer to NULL
+     * 
+     * @param pool - the pool the token was taken from, NULL if it was allocated alone
+     * @param this - pointer to the instance to delete
+     */
+    void (* deleteInPool)(Pool * const pool, JsonToken ** this);
+
     /**
      * Returns the type of the token
      * 
@@ -105,7 +203,7 @@ typedef struct
      * 
      * @param this - the instance to evaluate as an integer
      * 
-     * @return - the integer value stored in the token
+     * @return - the integer value stored in the token, LONG_MIN or LONG_MAX if it's out of range (@see getRawNumber)
      */
     JsonIntegerValue (* asInteger)(JsonToken const * const this);
 
@@ -114,7 +212,7 @@ typedef struct
      * 
      * @param this - the instance to evaluate as a float
      * 
-     * @return - the float value stored in the token
+     * @return - the float value stored in the token, HUGE_VAL with its sign if it's out of range
      */
     JsonFloatValue (* asFloat)(JsonToken const * const this);
 
@@ -154,6 +252,53 @@ typedef struct
      */
     char const * (* getRawString)(JsonToken const * const this);
 
+    /**
+     * Returns the exact representation of a number, for values not fitting JsonIntegerValue or JsonFloatValue
+     * 
+     * @param this - the token to get the number representation of
+     * 
+     * @return - the raw string of integer and float tokens, NULL for other tokens
+     */
+    char const * (* getRawNumber)(JsonToken const * const this);
+
+    /**
+     * Stores the value of an integer or float token converted apart, such as in bulk (@see JsonNumbers)
+     * Tokens already converted and other tokens are left untouched
+     * 
+     * @param this - the token to store the value in
+     * @param value - the value of the number, asInteger or asFloat depending on the type of the token
+     */
+    void (* setNumber)(JsonToken * const this, JsonValue value);
+
+    /**
+     * Sets whether further integer and float tokens created with new and newWithLength are converted on first access rather than on creation
+     * 
+     * @param enabled - 1 to convert numbers on first access, 0 to convert them on creation
+     * 
+     * @return - the previous setting
+     */
+    int (* useLazyNumbers)(int enabled);
+
+    /**
+     * Finds the longest valid token-string at the start of a string, in a single scan
+     * 
+     * @param string - the string to scan, doesn't need to be NUL-terminated
+     * @param maxLength - the length of the string
+     * @param length - where to store the length of the token-string found (0 if none)
+     * 
+     * @return - the type of the token-string found, -1 if there's none
+     */
+    JsonTokenType (* scan)(char const * const string, size_t maxLength, size_t * length);
+
+    /**
+     * Creates a pool sized for JsonToken instances, each starting on its own cache line
+     * 
+     * @param allocator - the allocator of the pool, NULL for the standard one
+     * 
+     * @return - a Pool instance if allocation succeeds, NULL otherwise
+     */
+    Pool * (* newPool)(Allocator const * allocator);
+
 } _JsonTokenMethods;
 
 
@@ -3,32 +3,27 @@
 #include <string.h>
 
 #include "Class.h"
+#include "Pool.h"
 #include "LinkedList.h"
 
 
 
 
-struct LinkedList
+static LinkedList * new(void * content)
 {
-    /**
-     * The data stored in this element
-     */
-    void * content;
-
-    /**
-     * The next element in the list
-     */
-    LinkedList * nextElement;
-};
-
-
+    return _LinkedList->newInPool(NULL, content);
+}
 
 
-static LinkedList * new(void * content)
+static LinkedList * newInPool(Pool * const pool, void * content)
 {
     LinkedList * this;
 
-    this = Class->new("LinkedList", sizeof(* this));
+    if (pool != NULL) {
+        this = _Pool->take(pool);
+    } else {
+        this = Class->new("LinkedList", sizeof(* this));
+    }
 
     if (this != NULL) {
         this->content = content;
@@ -40,15 +35,30 @@ static LinkedList * new(void * content)
 
 static void delete(LinkedList ** this)
 {
-    if ((this == NULL) || (* this == NULL)) {
+    _LinkedList->deleteInPool(NULL, this);
+}
+
+
+static void deleteInPool(Pool * const pool, LinkedList ** this)
+{
+    LinkedList * next;
+
+    if (this == NULL) {
         return;
     }
 
-    if ((* this)->nextElement != NULL) {
-        _LinkedList->delete(& (* this)->nextElement);
-    }
+    /* walked rather than recursed, so that long lists don't run out of stack */
+    while (* this != NULL) {
+        next = (* this)->nextElement;
+
+        if (pool != NULL) {
+            _Pool->give(pool, * this);
+        } else {
+            Class->delete((void **) this);
+        }
 
-    Class->delete((void **) this);
+        * this = next;
+    }
 }
 
 
@@ -64,12 +74,13 @@ static int append(LinkedList ** this, LinkedList * const newElement)
         return -1;
     }
 
-    if (* this == NULL) {
-        * this = newElement;
-        return 0;
-    } 
+    while (* this != NULL) {
+        this = & (* this)->nextElement;
+    }
+
+    * this = newElement;
 
-    return _LinkedList->append(& (* this)->nextElement, newElement);
+    return 0;
 }
 
 
@@ -79,13 +90,32 @@ static LinkedList * nextElement(LinkedList const * const this)
 }
 
 
+static LinkedList * detachNext(LinkedList * const this)
+{
+    LinkedList * detached = this->nextElement;
+
+    this->nextElement = NULL;
+
+    return detached;
+}
+
+
 static unsigned int size(LinkedList const * const this)
 {
-    if (this == NULL) {
-        return 0;
+    LinkedList const * element;
+    unsigned int count = 0;
+
+    for (element = this; element != NULL; element = element->nextElement) {
+        count++;
     }
 
-    return 1 + _LinkedList->size(this->nextElement);
+    return count;
+}
+
+
+static Pool * newPool(Allocator const * allocator)
+{
+    return _Pool->newWithAllocator(sizeof(LinkedList), allocator);
 }
 
 
@@ -96,10 +126,14 @@ static unsigned int size(LinkedList const * const this)
  */
 static _LinkedListMethods methods = {
     new,
+    newInPool,
     delete,
+    deleteInPool,
     getContent,
     append,
     nextElement,
-    size
+    detachNext,
+    size,
+    newPool
 };
 _LinkedListMethods const * const _LinkedList = & methods;
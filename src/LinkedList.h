@@ -2,6 +2,8 @@
 #ifndef LINKED_LIST_HEADER
 #define LINKED_LIST_HEADER
 
+#include "Pool.h"
+
 
 
 
@@ -11,6 +13,30 @@
 typedef struct LinkedList LinkedList;
 
 
+/**
+ * Layout of an element, only exposed for the accessor macros, use the methods table otherwise
+ */
+struct LinkedList
+{
+    /**
+     * The data stored in this element
+     */
+    void * content;
+
+    /**
+     * The next element in the list
+     */
+    LinkedList * nextElement;
+};
+
+
+/**
+ * Accessors expanding to direct loads in tight loops, the same as getContent and nextElement
+ */
+#define LINKED_LIST_CONTENT(element) ((element)->content)
+#define LINKED_LIST_NEXT(element) ((element)->nextElement)
+
+
 
 
 /**
@@ -27,6 +53,16 @@ typedef struct
      */
     LinkedList * (* new)(void * data);
 
+    /**
+     * Constructor taking the element from a pool, for documents owning their lists
+     * 
+     * @param pool - the pool to take the element from, NULL to allocate it alone
+     * @param data - the data to store in the element, will be stored internally
+     * 
+     * @return - a LinkedList element/instance if allocation succeeds, NULL otherwise
+     */
+    LinkedList * (* newInPool)(Pool * const pool, void * data);
+
     /**
      * Destructor, sets the pointer to NULL
      * 
@@ -34,6 +70,14 @@ typedef struct
      */
     void (* delete)(LinkedList ** this);
 
+    /**
+     * Destructor of elements taken from a pool, gives them back and sets the pointer to NULL
+     * 
+     * @param pool - the pool the elements were taken from, NULL if they were allocated alone
+     * @param this - pointer to the instance to delete
+     */
+    void (* deleteInPool)(Pool * const pool, LinkedList ** this);
+
     /**
      * Returns the content stored in the element
      * 
@@ -62,6 +106,15 @@ typedef struct
      */
     LinkedList * (* nextElement)(LinkedList const * const this);
 
+    /**
+     * Detaches the elements following this one from the list
+     * 
+     * @param this - the element to end the list at
+     * 
+     * @return - the detached elements, or NULL if there's none
+     */
+    LinkedList * (* detachNext)(LinkedList * const this);
+
     /**
      * Returns the size of the list, from the current element to the end
      * 
@@ -71,6 +124,15 @@ typedef struct
      */
     unsigned int (* size)(LinkedList const * const this);
 
+    /**
+     * Creates a pool sized for LinkedList instances
+     * 
+     * @param allocator - the allocator of the pool, NULL for the standard one
+     * 
+     * @return - a Pool instance if allocation succeeds, NULL otherwise
+     */
+    Pool * (* newPool)(Allocator const * allocator);
+
 } _LinkedListMethods;
 
 
@@ -0,0 +1,243 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Class.h"
+#include "Pool.h"
+
+
+
+
+/**
+ * Number of blocks in the first slab, doubled for each new slab
+ */
+#define POOL_FIRST_SLAB_BLOCKS 16
+
+
+/**
+ * Maximum number of blocks in a slab
+ */
+#define POOL_MAX_SLAB_BLOCKS 4096
+
+
+/**
+ * Header of a slab, its size keeps the blocks following it aligned
+ */
+typedef union PoolSlab
+{
+    union PoolSlab * nextSlab;
+    long alignAsLong;
+    double alignAsDouble;
+} PoolSlab;
+
+
+/**
+ * A block given back to the pool, linked to the other free blocks
+ */
+typedef struct PoolFreeBlock
+{
+    struct PoolFreeBlock * nextFreeBlock;
+} PoolFreeBlock;
+
+
+struct Pool
+{
+    /**
+     * The allocator the pool and its slabs are allocated with
+     */
+    Allocator const * allocator;
+
+    /**
+     * The size of the blocks, rounded up to keep them aligned
+     */
+    unsigned int blockSize;
+
+    /**
+     * The boundary blocks start on
+     */
+    unsigned int alignment;
+
+    /**
+     * The number of blocks the next slab will hold
+     */
+    unsigned int nextSlabBlocks;
+
+    /**
+     * The allocated slabs, most recent first
+     */
+    PoolSlab * slabs;
+
+    /**
+     * The blocks given back, to be taken again first
+     */
+    PoolFreeBlock * freeBlocks;
+
+    /**
+     * The first never-taken block of the most recent slab
+     */
+    char * nextBlock;
+
+    /**
+     * The end of the most recent slab
+     */
+    char * slabEnd;
+};
+
+
+
+
+/**
+ * Allocates a new slab and makes it the one blocks are taken from
+ * 
+ * @param this - the pool to grow
+ * 
+ * @return - 0 on success, -1 on failure
+ */
+static int __addSlab(Pool * const this);
+
+
+
+
+static Pool * new(unsigned int blockSize)
+{
+    return _Pool->newWithAllocator(blockSize, Class->getAllocator());
+}
+
+
+static Pool * newWithAllocator(unsigned int blockSize, Allocator const * allocator)
+{
+    return _Pool->newWithAlignment(blockSize, sizeof(PoolSlab), allocator);
+}
+
+
+static Pool * newWithAlignment(unsigned int blockSize, unsigned int alignment, Allocator const * allocator)
+{
+    Pool * this;
+
+    this = Class->newWithAllocator(allocator, "Pool", sizeof(* this));
+
+    if (this != NULL) {
+        if (blockSize < sizeof(PoolFreeBlock)) {
+            blockSize = sizeof(PoolFreeBlock);
+        }
+        if (alignment < sizeof(PoolSlab)) {
+            alignment = sizeof(PoolSlab);
+        }
+        this->allocator = allocator;
+        this->alignment = alignment;
+        this->blockSize = (blockSize + alignment - 1) / alignment * alignment;
+        this->nextSlabBlocks = POOL_FIRST_SLAB_BLOCKS;
+    }
+
+    return this;
+}
+
+
+static void delete(Pool ** this)
+{
+    PoolSlab * slab;
+
+    if ((this == NULL) || (* this == NULL)) {
+        return;
+    }
+
+    while ((* this)->slabs != NULL) {
+        slab = (* this)->slabs;
+        (* this)->slabs = slab->nextSlab;
+        Class->deleteWithAllocator((* this)->allocator, (void **) & slab);
+    }
+
+    Class->deleteWithAllocator((* this)->allocator, (void **) this);
+}
+
+
+static void * take(Pool * const this)
+{
+    void * block;
+
+    if (this->freeBlocks != NULL) {
+        block = this->freeBlocks;
+        this->freeBlocks = this->freeBlocks->nextFreeBlock;
+        memset(block, 0, this->blockSize);
+        return block;
+    }
+
+    if (this->nextBlock == this->slabEnd) {
+        if (__addSlab(this) != 0) {
+            return NULL;
+        }
+    }
+
+    block = this->nextBlock;
+    this->nextBlock += this->blockSize;
+
+    return block;
+}
+
+
+static void give(Pool * const this, void * block)
+{
+    PoolFreeBlock * freeBlock = block;
+
+    if (block == NULL) {
+        return;
+    }
+
+    freeBlock->nextFreeBlock = this->freeBlocks;
+    this->freeBlocks = freeBlock;
+}
+
+
+static Allocator const * getAllocator(Pool const * const this)
+{
+    return this->allocator;
+}
+
+
+
+
+static int __addSlab(Pool * const this)
+{
+    PoolSlab * slab;
+    size_t misalignment;
+    unsigned int slabSize = sizeof(PoolSlab) + (this->alignment - sizeof(PoolSlab)) + this->blockSize * this->nextSlabBlocks;
+
+    slab = Class->newWithAllocator(this->allocator, "PoolSlab", slabSize);
+    if (slab == NULL) {
+        return -1;
+    }
+
+    slab->nextSlab = this->slabs;
+    this->slabs = slab;
+
+    /* the header is followed by padding up to the first boundary, allocations being at least aligned as the header */
+    this->nextBlock = (char *) (slab + 1);
+    misalignment = (size_t) this->nextBlock % this->alignment;
+    if (misalignment != 0) {
+        this->nextBlock += this->alignment - misalignment;
+    }
+    this->slabEnd = this->nextBlock + this->blockSize * this->nextSlabBlocks;
+
+    if (this->nextSlabBlocks < POOL_MAX_SLAB_BLOCKS) {
+        this->nextSlabBlocks *= 2;
+    }
+
+    return 0;
+}
+
+
+
+
+/**
+ * Init Pool methods table
+ */
+static _PoolMethods methods = {
+    new,
+    newWithAllocator,
+    newWithAlignment,
+    delete,
+    take,
+    give,
+    getAllocator
+};
+_PoolMethods const * const _Pool = & methods;
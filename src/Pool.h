@@ -0,0 +1,99 @@
+#ifndef POOL_HEADER
+#define POOL_HEADER
+
+#include "Class.h"
+
+
+
+
+/**
+ * A pool of fixed-size memory blocks, carved from contiguous slabs
+ */
+typedef struct Pool Pool;
+
+
+
+
+/**
+ * Pool methods table
+ */
+typedef struct
+{
+    /**
+     * Constructor, slabs will be allocated with the current allocator
+     * 
+     * @param blockSize - the size of the blocks the pool hands out
+     * 
+     * @return - a Pool instance if allocation succeeds, NULL otherwise
+     */
+    Pool * (* new)(unsigned int blockSize);
+
+    /**
+     * Constructor, the pool and its slabs will be allocated with the given allocator, whatever the current one
+     * 
+     * @param blockSize - the size of the blocks the pool hands out
+     * @param allocator - the allocator to use, NULL for the standard one
+     * 
+     * @return - a Pool instance if allocation succeeds, NULL otherwise
+     */
+    Pool * (* newWithAllocator)(unsigned int blockSize, Allocator const * allocator);
+
+    /**
+     * Constructor of a pool whose blocks start on a boundary, such as a cache line so that a block fitting one never straddles two
+     * 
+     * @param blockSize - the size of the blocks the pool hands out, rounded up to a multiple of the alignment
+     * @param alignment - the boundary blocks start on, a power of two, at least the one of long and double
+     * @param allocator - the allocator to use, NULL for the standard one
+     * 
+     * @return - a Pool instance if allocation succeeds, NULL otherwise
+     */
+    Pool * (* newWithAlignment)(unsigned int blockSize, unsigned int alignment, Allocator const * allocator);
+
+    /**
+     * Destructor, releases every slab at once and sets the pointer to NULL
+     * Blocks taken from the pool must not be used anymore
+     * 
+     * @param this - pointer to the instance to delete
+     */
+    void (* delete)(Pool ** this);
+
+    /**
+     * Takes a zeroed block from the pool
+     * 
+     * @param this - the pool to take the block from
+     * 
+     * @return - the block, NULL if a new slab was needed and allocation failed
+     */
+    void * (* take)(Pool * const this);
+
+    /**
+     * Gives a block back to the pool, for it to be taken again
+     * 
+     * @param this - the pool the block was taken from
+     * @param block - the block to give back
+     */
+    void (* give)(Pool * const this, void * block);
+
+    /**
+     * Returns the allocator the pool was created with, for data hanging off its blocks to be allocated alike
+     * 
+     * @param this - the pool to get the allocator of
+     * 
+     * @return - the allocator of the pool
+     */
+    Allocator const * (* getAllocator)(Pool const * const this);
+
+} _PoolMethods;
+
+
+
+
+/**
+ * Pool class methods table
+ */
+extern _PoolMethods const * const _Pool;
+
+
+
+
+#endif /* POOL_HEADER */
@@ -33,3 +33,113 @@ Test(Class, destruction_frees_memory) {
         "Destroying the instance should free the memory and set the pointer to NULL"
     );
 }
+
+
+static unsigned int allocatedBytes = 0;
+
+static void * countingAllocate(void * context, size_t size) {
+    (void) context;
+    allocatedBytes += size;
+    return malloc(size);
+}
+
+static void * countingReallocate(void * context, void * block, size_t oldSize, size_t newSize) {
+    (void) context;
+    allocatedBytes += newSize - oldSize;
+    return realloc(block, newSize);
+}
+
+static void countingDeallocate(void * context, void * block) {
+    (void) context;
+    free(block);
+}
+
+static Allocator const countingAllocator = {
+    countingAllocate,
+    countingReallocate,
+    countingDeallocate,
+    NULL
+};
+
+
+Test(Class, allocates_with_given_allocator) {
+    // given a custom allocator
+    Allocator const * previousAllocator = Class->useAllocator(& countingAllocator);
+    allocatedBytes = 0;
+
+    // when creating a new instance
+    void * instance = Class->new("", 42);
+    Class->delete(& instance);
+    Class->useAllocator(previousAllocator);
+
+    // then the custom allocator should have been used
+    cr_assert_eq(
+        allocatedBytes,
+        42,
+        "Creating a new instance should use the current allocator"
+    );
+}
+
+
+Test(Class, resizes_with_given_allocator) {
+    // given an instance allocated with a custom allocator
+    Allocator const * previousAllocator = Class->useAllocator(& countingAllocator);
+    char * instance = Class->new("", 2);
+    allocatedBytes = 0;
+
+    // when growing it
+    int status = Class->resize((void **) & instance, 2, 42);
+
+    // then the added bytes should be zeroed
+    cr_assert_eq(status, 0);
+    cr_assert_eq(
+        instance[41],
+        0,
+        "Resized instances should have their added bytes zeroed"
+    );
+    cr_assert_eq(
+        allocatedBytes,
+        40,
+        "Resizing an instance should use the current allocator"
+    );
+
+    Class->delete((void **) & instance);
+    Class->useAllocator(previousAllocator);
+}
+
+
+Test(Class, allocates_with_explicit_allocator) {
+    // given the standard allocator as the current one
+    allocatedBytes = 0;
+
+    // when creating and resizing an instance with a custom allocator
+    char * instance = Class->newWithAllocator(& countingAllocator, "", 2);
+    int status = Class->resizeWithAllocator(& countingAllocator, (void **) & instance, 2, 42);
+    Class->deleteWithAllocator(& countingAllocator, (void **) & instance);
+
+    // then the custom allocator should have been used, whatever the current one
+    cr_assert_eq(status, 0);
+    cr_assert_null(instance);
+    cr_assert_eq(
+        allocatedBytes,
+        42,
+        "Explicit allocators should be used instead of the current one"
+    );
+}
+
+
+Test(Class, restores_standard_allocator) {
+    // given a custom allocator
+    Allocator const * standardAllocator = Class->getAllocator();
+    Class->useAllocator(& countingAllocator);
+
+    // when unsetting it
+    Class->useAllocator(NULL);
+
+    // then the standard allocator should be used again
+    cr_assert_eq(
+        Class->getAllocator(),
+        standardAllocator,
+        "Unsetting the allocator should restore the standard one"
+    );
+}
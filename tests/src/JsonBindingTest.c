@@ -0,0 +1,208 @@
+#include <limits.h>
+#include <stddef.h>
+#include <string.h>
+#include <criterion/criterion.h>
+
+#include "../../src/JsonToken.h"
+#include "../../src/JsonBinding.h"
+
+
+
+
+typedef struct {
+    JsonIntegerValue id;
+    JsonFloatValue price;
+    JsonBooleanValue available;
+    char name[8];
+    struct {
+        JsonIntegerValue x;
+        JsonIntegerValue y;
+    } position;
+} Message;
+
+static JsonBindingField const positionFields[] = {
+    { "x", offsetof(Message, position.x) - offsetof(Message, position), JSON_BINDING_INTEGER, 0, NULL, 0 },
+    { "y", offsetof(Message, position.y) - offsetof(Message, position), JSON_BINDING_INTEGER, 0, NULL, 0 }
+};
+
+static JsonBindingField const messageFields[] = {
+    { "id", offsetof(Message, id), JSON_BINDING_INTEGER, 0, NULL, 0 },
+    { "price", offsetof(Message, price), JSON_BINDING_FLOAT, 0, NULL, 0 },
+    { "available", offsetof(Message, available), JSON_BINDING_BOOLEAN, 0, NULL, 0 },
+    { "name", offsetof(Message, name), JSON_BINDING_STRING, sizeof(((Message *) NULL)->name), NULL, 0 },
+    { "position", offsetof(Message, position), JSON_BINDING_OBJECT, 0, positionFields, 2 }
+};
+
+
+Test(JsonBinding, instanciation_allocates_memory) {
+    // given
+
+    // when compiling descriptors
+    JsonBinding * instance = _JsonBinding->new(messageFields, 5);
+
+    // then an usable memory block should be returned
+    cr_assert_not_null(
+        instance,
+        "Creating a new instance should return a valid memory block"
+    );
+}
+
+
+Test(JsonBinding, destruction_frees_memory) {
+    // given an instance
+    JsonBinding * instance = _JsonBinding->new(messageFields, 5);
+
+    // when destroying it
+    _JsonBinding->delete(& instance);
+
+    // then the memory block should have been freed and set to NULL
+    cr_assert_null(
+        instance,
+        "Destroying the instance should free the memory and set the pointer to NULL"
+    );
+}
+
+
+Test(JsonBinding, rejects_duplicate_names) {
+    // given descriptors with the same name twice
+    JsonBindingField const fields[] = {
+        { "id", 0, JSON_BINDING_INTEGER, 0, NULL, 0 },
+        { "id", 8, JSON_BINDING_INTEGER, 0, NULL, 0 }
+    };
+
+    // when compiling them
+    JsonBinding * binding = _JsonBinding->new(fields, 2);
+
+    // then no instance should be returned
+    cr_assert_null(
+        binding,
+        "Descriptors with duplicate names can't be matched"
+    );
+}
+
+
+Test(JsonBinding, binds_members_into_struct) {
+    // given a binding and a json object
+    JsonBinding * binding = _JsonBinding->new(messageFields, 5);
+    char * jsonString = "{ \"name\": \"foo\", \"id\": 42, \"position\": { \"y\": -2, \"x\": 1 }, \"price\": 4.5, \"available\": true }";
+    Message message;
+    memset(& message, 0, sizeof(message));
+
+    // when binding the object
+    int status = _JsonBinding->bind(binding, jsonString, strlen(jsonString), & message);
+
+    // then every member should be written
+    cr_assert_eq(status, 0);
+    cr_assert_eq(message.id, 42);
+    cr_assert_eq(message.price, 4.5);
+    cr_assert_eq(message.available, 1);
+    cr_assert_str_eq(message.name, "foo");
+    cr_assert_eq(message.position.x, 1);
+    cr_assert_eq(
+        message.position.y,
+        -2,
+        "Nested objects should be written into nested structs"
+    );
+}
+
+
+Test(JsonBinding, skips_unknown_keys) {
+    // given a json object with unknown members
+    JsonBinding * binding = _JsonBinding->new(messageFields, 5);
+    char * jsonString = "{ \"tags\": [\"a\", { \"id\": 1 }], \"id\": 42, \"extra\": false }";
+    Message message;
+    memset(& message, 0, sizeof(message));
+
+    // when binding the object
+    int status = _JsonBinding->bind(binding, jsonString, strlen(jsonString), & message);
+
+    // then only known members should be written
+    cr_assert_eq(status, 0);
+    cr_assert_eq(
+        message.id,
+        42,
+        "Unknown members should be skipped"
+    );
+}
+
+
+Test(JsonBinding, binds_numbers_of_any_length) {
+    // given a json object with numbers longer than the stack copy used to convert them
+    JsonBinding * binding = _JsonBinding->new(messageFields, 5);
+    char jsonString[256];
+    Message message;
+    memset(& message, 0, sizeof(message));
+    strcpy(jsonString, "{ \"price\": 4.5");
+    memset(jsonString + strlen(jsonString), '0', 70);
+    strcpy(jsonString + 84, ", \"id\": 42");
+    memset(jsonString + strlen(jsonString), '0', 70);
+    strcpy(jsonString + 164, " }");
+
+    // when binding the object
+    int status = _JsonBinding->bind(binding, jsonString, strlen(jsonString), & message);
+
+    // then the numbers should be converted from a copy on the heap
+    cr_assert_eq(status, 0);
+    cr_assert_eq(message.price, 4.5);
+    cr_assert_eq(message.id, LONG_MAX);
+}
+
+
+Test(JsonBinding, rejects_mismatching_types) {
+    // given a json object with a string where an integer is expected
+    JsonBinding * binding = _JsonBinding->new(messageFields, 5);
+    char * jsonString = "{ \"id\": \"42\" }";
+    Message message;
+
+    // when binding the object
+    int status = _JsonBinding->bind(binding, jsonString, strlen(jsonString), & message);
+
+    // then binding should fail
+    cr_assert_eq(
+        status,
+        -1,
+        "Values not matching their field should be rejected"
+    );
+}
+
+
+Test(JsonBinding, rejects_overlong_strings) {
+    // given a json object with a string longer than its buffer
+    JsonBinding * binding = _JsonBinding->new(messageFields, 5);
+    char * jsonString = "{ \"name\": \"too long name\" }";
+    Message message;
+
+    // when binding the object
+    int status = _JsonBinding->bind(binding, jsonString, strlen(jsonString), & message);
+
+    // then binding should fail
+    cr_assert_eq(
+        status,
+        -1,
+        "Strings not fitting their buffer should be rejected"
+    );
+}
+
+
+Test(JsonBinding, rejects_malformed_json) {
+    // given malformed json objects
+    JsonBinding * binding = _JsonBinding->new(messageFields, 5);
+    char * jsonStrings[] = {
+        "{ \"id\" 42 }",
+        "{ \"id\": 42 \"price\": 1.0 }",
+        "{ \"id\": 42",
+        "{ \"id\": 42 } 42"
+    };
+    unsigned int jsonIndex;
+    Message message;
+
+    // when binding them
+    for (jsonIndex = 0; jsonIndex < 4; jsonIndex++) {
+        // then binding should fail
+        cr_assert_eq(
+            _JsonBinding->bind(binding, jsonStrings[jsonIndex], strlen(jsonStrings[jsonIndex]), & message),
+            -1,
+            "Malformed json '%s' should be rejected", jsonStrings[jsonIndex]
+        );
+    }
+}
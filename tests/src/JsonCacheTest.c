@@ -0,0 +1,160 @@
+#include <string.h>
+#include <criterion/criterion.h>
+
+#include "../../src/Json.h"
+#include "../../src/JsonCache.h"
+
+
+
+
+Test(JsonCache, instanciation_allocates_memory) {
+    // given
+
+    // when creating a new instance
+    JsonCache * instance = _JsonCache->new(1 << 20);
+
+    // then an usable memory block should be returned
+    cr_assert_not_null(
+        instance,
+        "Creating a new instance should return a valid memory block"
+    );
+}
+
+
+Test(JsonCache, destruction_frees_memory) {
+    // given an instance with a cached json
+    JsonCache * instance = _JsonCache->new(1 << 20);
+    Json * json = _JsonCache->get(instance, "{ \"foo\": true }");
+
+    // when destroying it
+    _JsonCache->delete(& instance);
+
+    // then the memory block should have been freed and set to NULL
+    cr_assert_null(
+        instance,
+        "Destroying the instance should free the memory and set the pointer to NULL"
+    );
+
+    // and the json should still be usable by its holder
+    cr_assert_str_eq(_Json->toString(json), "{ \"foo\": true }");
+    _Json->delete(& json);
+}
+
+
+Test(JsonCache, shares_identical_jsons) {
+    // given a cache which parsed a json-string
+    JsonCache * cache = _JsonCache->new(1 << 20);
+    char first[] = "{ \"foo\": true }";
+    char second[] = "{ \"foo\": true }";
+    Json * json = _JsonCache->get(cache, first);
+
+    // when requesting an identical json-string
+    Json * cachedJson = _JsonCache->get(cache, second);
+
+    // then the same json should be returned, without parsing
+    cr_assert_eq(
+        cachedJson,
+        json,
+        "Identical json-strings should share the same json"
+    );
+    cr_assert_eq(_JsonCache->getStats(cache)->hits, 1);
+    cr_assert_eq(_JsonCache->getStats(cache)->misses, 1);
+}
+
+
+Test(JsonCache, parses_different_jsons) {
+    // given a cache which parsed a json-string
+    JsonCache * cache = _JsonCache->new(1 << 20);
+    Json * json = _JsonCache->get(cache, "{ \"foo\": true }");
+
+    // when requesting another json-string of the same length
+    Json * otherJson = _JsonCache->get(cache, "{ \"bar\": true }");
+
+    // then another json should be parsed
+    cr_assert_neq(
+        otherJson,
+        json,
+        "Different json-strings shouldn't share a json"
+    );
+    cr_assert_eq(_JsonCache->getStats(cache)->misses, 2);
+}
+
+
+Test(JsonCache, evicts_least_recently_used) {
+    // given a cache which can only hold two of these jsons
+    JsonCache * cache = _JsonCache->new(1 << 20);
+    Json * json = _JsonCache->get(cache, "[ \"sized json\" ]");
+    unsigned long jsonBytes = _JsonCache->getStats(cache)->bytes;
+    _Json->delete(& json);
+    _JsonCache->delete(& cache);
+
+    cache = _JsonCache->new(2 * jsonBytes);
+    json = _JsonCache->get(cache, "[ \"first json\" ]");
+    _Json->delete(& json);
+    json = _JsonCache->get(cache, "[ \"other json\" ]");
+    _Json->delete(& json);
+    json = _JsonCache->get(cache, "[ \"first json\" ]");
+    _Json->delete(& json);
+
+    // when caching a third one
+    json = _JsonCache->get(cache, "[ \"third json\" ]");
+    _Json->delete(& json);
+
+    // then the least recently used one should have been evicted
+    cr_assert_eq(_JsonCache->getStats(cache)->evictions, 1);
+    cr_assert_eq(_JsonCache->getStats(cache)->bytes, 2 * jsonBytes);
+    json = _JsonCache->get(cache, "[ \"first json\" ]");
+    cr_assert_eq(
+        _JsonCache->getStats(cache)->hits,
+        2,
+        "The most recently used json should have been kept"
+    );
+}
+
+
+Test(JsonCache, counts_the_memory_of_cached_jsons) {
+    // given a cache
+    JsonCache * cache = _JsonCache->new(1 << 20);
+    char const * const jsonString = "{ \"foo\": [1, 2, 3], \"bar\": \"a string too long to be stored inside its token\" }";
+
+    // when caching a json
+    Json * json = _JsonCache->get(cache, jsonString);
+
+    // then every byte allocated for it should be counted, well beyond its json-string
+    cr_assert_gt(
+        _JsonCache->getStats(cache)->bytes,
+        strlen(jsonString) + _Json->getTokensCount(json) * sizeof(JsonToken),
+        "The budget should count the tokens, not only the json-string"
+    );
+    _Json->delete(& json);
+    _JsonCache->delete(& cache);
+}
+
+
+Test(JsonCache, hands_out_frozen_jsons) {
+    // given a cache
+    JsonCache * cache = _JsonCache->new(1 << 20);
+
+    // when caching a json
+    Json * json = _JsonCache->get(cache, "[ 1, 2 ]");
+
+    // then it should be frozen, refusing edits
+    cr_assert_eq(_Json->edit(json, 2, 1, "3", NULL), -1);
+    _Json->delete(& json);
+    _JsonCache->delete(& cache);
+}
+
+
+Test(JsonCache, keeps_evicted_jsons_usable) {
+    // given a json evicted from the cache while still held
+    JsonCache * cache = _JsonCache->new(1 << 20);
+    Json * json = _JsonCache->get(cache, "[ \"kept json\", 1, 2, 3 ]");
+    _JsonCache->delete(& cache);
+
+    // when reading it, then deleting it
+    // then it should still be whole, and be freed through its account
+    cr_assert_eq(_Json->getTokensCount(json), 9);
+    cr_assert_str_eq(_Json->toString(json), "[ \"kept json\", 1, 2, 3 ]");
+    _Json->delete(& json);
+    cr_assert_null(json);
+}
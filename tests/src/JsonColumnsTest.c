@@ -0,0 +1,147 @@
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+#include <criterion/criterion.h>
+
+#include "../../src/JsonColumns.h"
+
+
+
+
+static JsonColumnSpec const specs[] = {
+    { "/id", JSON_COLUMN_INTEGER },
+    { "/user/name", JSON_COLUMN_STRING },
+    { "/score", JSON_COLUMN_FLOAT },
+    { "/active", JSON_COLUMN_BOOLEAN },
+    { "/a~1b", JSON_COLUMN_INTEGER }
+};
+
+static int isValid(JsonColumn const * const column, unsigned int row) {
+    return (column->validity[row / 8] >> (row % 8)) & 1;
+}
+
+
+Test(JsonColumns, extracts_typed_columns) {
+    // given newline-delimited records
+    char const * const records =
+        "{\"id\": 1, \"user\": {\"name\": \"ann\"}, \"score\": 2.5, \"active\": true, \"a/b\": 7}\n"
+        "\n"
+        "{\"user\": {\"name\": \"b\\\"o\", \"id\": 9}, \"id\": \"two\", \"score\": 3, \"list\": [{\"id\": 5}]}\r\n"
+        "{\"id\": 3, \"active\": false, \"score\": null, \"user\": \"cid\"}";
+    JsonColumns * columns = _JsonColumns->new(specs, 5);
+    JsonColumn const * ids;
+    JsonColumn const * names;
+    JsonColumn const * scores;
+    JsonColumn const * actives;
+
+    // when appending them
+    int count = _JsonColumns->append(columns, records, strlen(records), NULL);
+
+    // then a row should be added per record, values of another type or place being missing
+    cr_assert_eq(count, 3);
+    cr_assert_eq(_JsonColumns->getRowsCount(columns), 3);
+
+    ids = _JsonColumns->getColumn(columns, 0);
+    cr_assert(isValid(ids, 0) && ! isValid(ids, 1) && isValid(ids, 2));
+    cr_assert_eq(((JsonIntegerValue *) ids->values)[0], 1);
+    cr_assert_eq(((JsonIntegerValue *) ids->values)[1], 0);
+    cr_assert_eq(((JsonIntegerValue *) ids->values)[2], 3);
+
+    names = _JsonColumns->getColumn(columns, 1);
+    cr_assert(isValid(names, 0) && isValid(names, 1) && ! isValid(names, 2));
+    cr_assert_eq(names->offsets[0], 0);
+    cr_assert_eq(names->offsets[1], 3);
+    cr_assert_eq(names->offsets[2], 7);
+    cr_assert_eq(names->offsets[3], 7);
+    cr_assert(memcmp(names->heap, "annb\\\"o", 7) == 0);
+
+    scores = _JsonColumns->getColumn(columns, 2);
+    cr_assert(isValid(scores, 0) && isValid(scores, 1) && ! isValid(scores, 2));
+    cr_assert_float_eq(((JsonFloatValue *) scores->values)[0], 2.5, 1e-9);
+    cr_assert_float_eq(((JsonFloatValue *) scores->values)[1], 3, 1e-9);
+
+    actives = _JsonColumns->getColumn(columns, 3);
+    cr_assert(isValid(actives, 0) && ! isValid(actives, 1) && isValid(actives, 2));
+    cr_assert_eq(((JsonBooleanValue *) actives->values)[0], 1);
+    cr_assert_eq(((JsonBooleanValue *) actives->values)[2], 0);
+
+    cr_assert_eq(((JsonIntegerValue *) _JsonColumns->getColumn(columns, 4)->values)[0], 7);
+    cr_assert_null(_JsonColumns->getColumn(columns, 5));
+
+    _JsonColumns->delete(& columns);
+    cr_assert_null(columns);
+}
+
+
+Test(JsonColumns, grows_and_clears_columns) {
+    // given many records
+    JsonColumns * columns = _JsonColumns->new(specs, 2);
+    char record[64];
+    unsigned int row;
+    JsonColumn const * names;
+
+    // when appending them one by one
+    for (row = 0; row < 1000; row++) {
+        sprintf(record, "{\"id\": %u, \"user\": {\"name\": \"n%u\"}}\n", row, row % 10);
+        cr_assert_eq(_JsonColumns->append(columns, record, strlen(record), NULL), 1);
+    }
+
+    // then every value should be kept
+    names = _JsonColumns->getColumn(columns, 1);
+    cr_assert_eq(_JsonColumns->getRowsCount(columns), 1000);
+    cr_assert_eq(((JsonIntegerValue *) _JsonColumns->getColumn(columns, 0)->values)[999], 999);
+    cr_assert_eq(names->offsets[1000], 2000);
+    cr_assert(memcmp(names->heap + names->offsets[999], "n9", 2) == 0);
+
+    // when clearing them
+    _JsonColumns->clear(columns);
+
+    // then the next record should be the first row
+    cr_assert_eq(_JsonColumns->append(columns, "{\"id\": 5}", 9, NULL), 1);
+    cr_assert_eq(_JsonColumns->getRowsCount(columns), 1);
+    cr_assert_eq(_JsonColumns->getColumn(columns, 1)->offsets[1], 0);
+
+    _JsonColumns->delete(& columns);
+}
+
+
+Test(JsonColumns, converts_numbers_of_any_length) {
+    // given a record with numbers longer than the stack copy used to convert them
+    JsonColumns * columns = _JsonColumns->new(specs, 3);
+    char zeros[71];
+    char record[256];
+    memset(zeros, '0', 70);
+    zeros[70] = '\0';
+    sprintf(record, "{\"score\": 2.5%s, \"id\": 1%s}", zeros, zeros);
+
+    // when appending it
+    int count = _JsonColumns->append(columns, record, strlen(record), NULL);
+
+    // then they should be converted from a copy on the heap
+    cr_assert_eq(count, 1);
+    cr_assert(isValid(_JsonColumns->getColumn(columns, 0), 0));
+    cr_assert_eq(((JsonIntegerValue *) _JsonColumns->getColumn(columns, 0)->values)[0], LONG_MAX);
+    cr_assert(isValid(_JsonColumns->getColumn(columns, 2), 0));
+    cr_assert_float_eq(((JsonFloatValue *) _JsonColumns->getColumn(columns, 2)->values)[0], 2.5, 1e-9);
+
+    _JsonColumns->delete(& columns);
+}
+
+
+Test(JsonColumns, rejects_invalid_records) {
+    // given records, the second of which is invalid
+    char const * const records = "{\"id\": 1}\n{\"id\": 2,}\n{\"id\": 3}";
+    JsonColumns * columns = _JsonColumns->new(specs, 1);
+    JsonError error;
+
+    // when appending them
+    int count = _JsonColumns->append(columns, records, strlen(records), & error);
+
+    // then the records before it should be kept and the error located in the string
+    cr_assert_eq(count, -1);
+    cr_assert_eq(_JsonColumns->getRowsCount(columns), 1);
+    cr_assert_eq(error.code, JSON_ERROR_UNEXPECTED_TOKEN);
+    cr_assert_eq(error.offset, 19);
+
+    _JsonColumns->delete(& columns);
+}
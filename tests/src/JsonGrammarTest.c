@@ -0,0 +1,116 @@
+#include <string.h>
+#include <criterion/criterion.h>
+
+#include "../../src/JsonToken.h"
+#include "../../src/JsonGrammar.h"
+
+
+
+
+Test(JsonGrammar, accepts_valid_jsons) {
+    // given some valid json-strings
+    char * jsonStrings[] = {
+        "{ \"a\": [1, 2.5, { \"b\": true }], \"c\": {} }",
+        "[]",
+        "\"foo\"",
+        " 42 "
+    };
+    unsigned int jsonIndex;
+
+    // when validating them
+    // then they should all be accepted
+    for (jsonIndex = 0; jsonIndex < 4; jsonIndex++) {
+        cr_assert_eq(
+            _JsonGrammar->validate(jsonStrings[jsonIndex], strlen(jsonStrings[jsonIndex]), NULL),
+            0,
+            "Expected json-string '%s' to be valid", jsonStrings[jsonIndex]
+        );
+    }
+}
+
+
+Test(JsonGrammar, rejects_misplaced_tokens) {
+    // given some json-strings with tokens out of place
+    char * jsonStrings[] = {
+        "}{",
+        "[1 2]",
+        "{ \"a\": 1, }",
+        "[1, 2}",
+        "{ 1: 2 }",
+        "[1] 2"
+    };
+    unsigned int expectedOffsets[] = { 0, 3, 10, 5, 2, 4 };
+    unsigned int jsonIndex;
+    JsonError error;
+
+    // when validating them
+    // then they should be rejected at the misplaced token
+    for (jsonIndex = 0; jsonIndex < 6; jsonIndex++) {
+        cr_assert_eq(_JsonGrammar->validate(jsonStrings[jsonIndex], strlen(jsonStrings[jsonIndex]), & error), -1);
+        cr_assert_eq(error.code, JSON_ERROR_UNEXPECTED_TOKEN);
+        cr_assert_eq(
+            error.offset,
+            expectedOffsets[jsonIndex],
+            "Expected json-string '%s' to be rejected at %u, got %lu", jsonStrings[jsonIndex], expectedOffsets[jsonIndex], error.offset
+        );
+    }
+}
+
+
+Test(JsonGrammar, rejects_unclosed_containers) {
+    // given a json-string missing its closing brackets
+    char * jsonString = "{ \"a\": [1";
+    JsonError error;
+
+    // when validating it
+    int status = _JsonGrammar->validate(jsonString, strlen(jsonString), & error);
+
+    // then the end should be reported as unexpected
+    cr_assert_eq(status, -1);
+    cr_assert_eq(error.code, JSON_ERROR_UNEXPECTED_END);
+    cr_assert_eq(
+        error.offset,
+        9,
+        "Unexpected end should be reported at the end of the json-string"
+    );
+}
+
+
+Test(JsonGrammar, rejects_too_deep_nesting) {
+    // given a json-string nested deeper than supported
+    char jsonString[JSON_GRAMMAR_MAX_DEPTH + 2];
+    JsonError error;
+
+    memset(jsonString, '[', JSON_GRAMMAR_MAX_DEPTH + 1);
+    jsonString[JSON_GRAMMAR_MAX_DEPTH + 1] = '\0';
+
+    // when validating it
+    _JsonGrammar->validate(jsonString, JSON_GRAMMAR_MAX_DEPTH + 1, & error);
+
+    // then the nesting should be rejected where it's too deep
+    cr_assert_eq(error.code, JSON_ERROR_TOO_DEEP);
+    cr_assert_eq(error.offset, JSON_GRAMMAR_MAX_DEPTH);
+}
+
+
+Test(JsonGrammar, reports_closed_containers) {
+    // given a grammar fed an array start and a value
+    JsonGrammar grammar;
+    unsigned int openingIndex = 0;
+
+    _JsonGrammar->begin(& grammar);
+    _JsonGrammar->feed(& grammar, JSON_TOKEN_OPERATOR, JSON_OPERATOR_ARRAY_START, 0, & openingIndex);
+    _JsonGrammar->feed(& grammar, JSON_TOKEN_INTEGER, '\0', 1, & openingIndex);
+
+    // when feeding the array end
+    int status = _JsonGrammar->feed(& grammar, JSON_TOKEN_OPERATOR, JSON_OPERATOR_ARRAY_END, 2, & openingIndex);
+
+    // then the index of the array start should be given back
+    cr_assert_eq(status, 1);
+    cr_assert_eq(
+        openingIndex,
+        0,
+        "Closing token should be matched with its opening one"
+    );
+    cr_assert_eq(_JsonGrammar->end(& grammar, 3), 0);
+}
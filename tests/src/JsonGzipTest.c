@@ -0,0 +1,158 @@
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <criterion/criterion.h>
+
+#ifdef JSON_ZLIB
+#include <zlib.h>
+#endif
+
+#include "../../src/JsonToken.h"
+#include "../../src/JsonSax.h"
+#include "../../src/JsonGzip.h"
+
+
+
+
+static int sumInteger(void * context, JsonIntegerValue value) {
+    * (long *) context += value;
+    return 0;
+}
+
+
+#ifdef JSON_ZLIB
+static void writeGzip(char const * path, char const * mode, char const * string) {
+    gzFile file = gzopen(path, mode);
+    gzwrite(file, string, strlen(string));
+    gzclose(file);
+}
+
+
+static void writeGzipArray(char const * path, unsigned int count) {
+    gzFile file = gzopen(path, "wb");
+    unsigned int index;
+
+    gzputc(file, '[');
+    for (index = 0; index < count; index++) {
+        gzprintf(file, "%s{ \"name\": \"value number %u\", \"n\": %u }", (index > 0) ? ", " : "", index, index % 7);
+    }
+    gzputc(file, ']');
+    gzclose(file);
+}
+
+
+
+
+Test(JsonGzip, reads_gzip_files) {
+    // given a gzip file decompressing to several chunks
+    char path[] = "/tmp/JsonGzipTestXXXXXX";
+    FILE * file;
+    JsonSaxHandler handler;
+    long sum = 0;
+
+    close(mkstemp(path));
+    writeGzipArray(path, 20000);
+    memset(& handler, 0, sizeof(handler));
+    handler.onInteger = sumInteger;
+
+    // when reading it
+    file = fopen(path, "rb");
+
+    // then every value should have been read
+    cr_assert_eq(_JsonGzip->parseFile(file, & handler, & sum, NULL), 0);
+    cr_assert_eq(sum, 59997);
+
+    fclose(file);
+    unlink(path);
+}
+
+
+Test(JsonGzip, reads_concatenated_members_as_one_json) {
+    // given a json cut in the middle of a number, each part compressed in its own member
+    char path[] = "/tmp/JsonGzipTestXXXXXX";
+    FILE * file;
+    JsonSaxHandler handler;
+    long sum = 0;
+
+    close(mkstemp(path));
+    writeGzip(path, "wb", "[1, 2, 1");
+    writeGzip(path, "ab", "");
+    writeGzip(path, "ab", "00]");
+    memset(& handler, 0, sizeof(handler));
+    handler.onInteger = sumInteger;
+
+    // when reading its source
+    file = fopen(path, "rb");
+    JsonGzip * gzip = _JsonGzip->new(file);
+    JsonSaxSource source = _JsonGzip->getSource(gzip);
+
+    // then the members should have been read one after the other
+    cr_assert_eq(_JsonSax->parseSource(& source, 3, & handler, & sum, NULL), 0);
+    cr_assert_eq(sum, 103);
+
+    _JsonGzip->delete(& gzip);
+    cr_assert_null(gzip);
+    fclose(file);
+    unlink(path);
+}
+
+
+Test(JsonGzip, rejects_truncated_and_corrupted_files) {
+    // given a gzip file cut before its end
+    char path[] = "/tmp/JsonGzipTestXXXXXX";
+    FILE * file;
+    JsonSaxHandler handler;
+    JsonError error;
+    long size;
+    long sum = 0;
+
+    close(mkstemp(path));
+    writeGzipArray(path, 1000);
+    file = fopen(path, "rb");
+    fseek(file, 0, SEEK_END);
+    size = ftell(file);
+    fclose(file);
+    cr_assert_eq(truncate(path, size - 4), 0);
+    memset(& handler, 0, sizeof(handler));
+    handler.onInteger = sumInteger;
+
+    // when reading it
+    file = fopen(path, "rb");
+
+    // then it should be rejected as unreadable
+    cr_assert_eq(_JsonGzip->parseFile(file, & handler, & sum, & error), -1);
+    cr_assert_eq(error.code, JSON_ERROR_READ);
+    fclose(file);
+
+    // and so should a file which isn't compressed
+    file = fopen(path, "wb");
+    fputs("[1, 2, 3]", file);
+    fclose(file);
+    file = fopen(path, "rb");
+    cr_assert_eq(_JsonGzip->parseFile(file, & handler, & sum, & error), -1);
+    cr_assert_eq(error.code, JSON_ERROR_READ);
+
+    fclose(file);
+    unlink(path);
+}
+#else
+
+
+
+
+Test(JsonGzip, refuses_files_without_zlib) {
+    // given a library built without zlib
+    JsonSaxHandler handler;
+    JsonError error;
+    long sum = 0;
+
+    memset(& handler, 0, sizeof(handler));
+    handler.onInteger = sumInteger;
+
+    // when reading a compressed file
+    // then no stream should be created, and the file should be rejected as unreadable
+    cr_assert_null(_JsonGzip->new(stdin));
+    cr_assert_eq(_JsonGzip->parseFile(stdin, & handler, & sum, & error), -1);
+    cr_assert_eq(error.code, JSON_ERROR_READ);
+}
+#endif
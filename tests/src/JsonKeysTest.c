@@ -0,0 +1,70 @@
+#include <string.h>
+#include <criterion/criterion.h>
+
+#include "../../src/JsonKeys.h"
+
+
+
+
+Test(JsonKeys, finds_known_keys_in_distinct_slots) {
+    // given many keys
+    static char names[200][8];
+    char const * keys[200];
+    int displacements[200];
+    unsigned int slots[200];
+    char isTaken[200];
+    JsonKeySet set;
+    unsigned int index;
+
+    for (index = 0; index < 200; index++) {
+        sprintf(names[index], "key%u", index);
+        keys[index] = names[index];
+    }
+
+    // when building a perfect hash of them
+    cr_assert_eq(_JsonKeys->build(keys, 200, displacements, slots), 0);
+    set.count = 200;
+    set.displacements = displacements;
+    set.keys = keys;
+
+    // then every key should have its own slot
+    memset(isTaken, 0, sizeof(isTaken));
+    for (index = 0; index < 200; index++) {
+        cr_assert_lt(slots[index], 200);
+        cr_assert_not(isTaken[slots[index]], "slot %u should be taken once", slots[index]);
+        isTaken[slots[index]] = 1;
+    }
+
+    // and keys should be found through the set once stored in their slots
+    for (index = 0; index < 200; index++) {
+        keys[slots[index]] = names[index];
+    }
+    for (index = 0; index < 200; index++) {
+        cr_assert_eq(_JsonKeys->find(& set, names[index], strlen(names[index])), (int) slots[index]);
+    }
+    cr_assert_eq(_JsonKeys->find(& set, "key200", 6), -1);
+    cr_assert_eq(_JsonKeys->find(& set, "key1", 3), -1);
+    cr_assert_eq(_JsonKeys->find(& set, "", 0), -1);
+}
+
+
+Test(JsonKeys, rejects_duplicated_keys) {
+    // given duplicated keys
+    char const * const keys[] = { "a", "b", "a" };
+    int displacements[3];
+    unsigned int slots[3];
+
+    // when building a perfect hash of them
+    // then it should fail
+    cr_assert_eq(_JsonKeys->build(keys, 3, displacements, slots), JSON_KEYS_ERROR_DUPLICATED);
+}
+
+
+Test(JsonKeys, finds_nothing_in_empty_sets) {
+    // given an empty set
+    JsonKeySet const set = { 0, NULL, NULL };
+
+    // when looking a key up
+    // then it should not be found
+    cr_assert_eq(_JsonKeys->find(& set, "a", 1), -1);
+}
@@ -0,0 +1,86 @@
+#include <string.h>
+#include <criterion/criterion.h>
+
+#include "../../src/JsonToken.h"
+#include "../../src/JsonLexer.h"
+
+
+
+
+Test(JsonLexer, reads_tokens_without_white_spaces) {
+    // given a json-string with white-spaces between tokens
+    char * jsonString = " {\n\t\"foo\" : -42 }";
+    size_t offset = 0;
+    JsonLexeme lexeme;
+
+    // when reading the tokens
+    _JsonLexer->next(jsonString, strlen(jsonString), & offset, & lexeme);
+    _JsonLexer->next(jsonString, strlen(jsonString), & offset, & lexeme);
+    _JsonLexer->next(jsonString, strlen(jsonString), & offset, & lexeme);
+    _JsonLexer->next(jsonString, strlen(jsonString), & offset, & lexeme);
+
+    // then the fourth one should be the whole integer
+    cr_assert_eq(lexeme.type, JSON_TOKEN_INTEGER);
+    cr_assert_eq(
+        strncmp(lexeme.start, "-42", lexeme.length),
+        0,
+        "Lexer should read the longest token"
+    );
+}
+
+
+Test(JsonLexer, signals_end_of_string) {
+    // given a json-string with trailing white-spaces
+    char * jsonString = "42  ";
+    size_t offset = 0;
+    JsonLexeme lexeme;
+    _JsonLexer->next(jsonString, strlen(jsonString), & offset, & lexeme);
+
+    // when reading past the last token
+    int status = _JsonLexer->next(jsonString, strlen(jsonString), & offset, & lexeme);
+
+    // then the end should be signaled
+    cr_assert_eq(
+        status,
+        0,
+        "Lexer should signal the end of the json-string"
+    );
+}
+
+
+Test(JsonLexer, rejects_invalid_token) {
+    // given a json-string with an invalid token
+    char * jsonString = "[ nope ]";
+    size_t offset = 1;
+    JsonLexeme lexeme;
+
+    // when reading it
+    int status = _JsonLexer->next(jsonString, strlen(jsonString), & offset, & lexeme);
+
+    // then it should be rejected
+    cr_assert_eq(
+        status,
+        -1,
+        "Lexer should reject invalid tokens"
+    );
+}
+
+
+Test(JsonLexer, skips_whole_containers) {
+    // given a json-string starting with a nested container
+    char * jsonString = "{ \"a\": [1, { \"b\": \"}\" }] }, 42";
+    size_t offset = 0;
+    JsonLexeme lexeme;
+
+    // when skipping the value
+    int status = _JsonLexer->skipValue(jsonString, strlen(jsonString), & offset);
+
+    // then the next token should be the one following the container
+    cr_assert_eq(status, 0);
+    _JsonLexer->next(jsonString, strlen(jsonString), & offset, & lexeme);
+    cr_assert_eq(
+        lexeme.start[0],
+        ',',
+        "Skipping a container should move past its closing operator"
+    );
+}
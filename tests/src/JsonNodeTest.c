@@ -0,0 +1,242 @@
+#include <criterion/criterion.h>
+
+#include "../../src/Class.h"
+#include "../../src/Json.h"
+#include "../../src/JsonNode.h"
+
+
+
+
+static JsonNode * parse(char const * const jsonString) {
+    Json * json = _Json->new(jsonString);
+    JsonNode * node = _JsonNode->fromJson(json);
+
+    _Json->delete(& json);
+
+    return node;
+}
+
+static void assertSerializesTo(JsonNode const * const node, char const * const expected) {
+    char * string = _JsonNode->toString(node);
+
+    cr_assert_str_eq(string, expected, "Expected '%s', got '%s'", expected, string);
+    Class->delete((void **) & string);
+}
+
+
+
+
+Test(JsonNode, builds_tree_from_json) {
+    // given a parsed json
+    JsonNode * root = parse("{ \"a\": [1, 2.5, \"x\"], \"b\": { \"c\": null, \"d\": true } }");
+
+    // when walking its tree
+    JsonNode * array = _JsonNode->get(root, "/a");
+
+    // then every value should be found
+    cr_assert_not_null(root);
+    cr_assert_eq(_JsonNode->getType(array), JSON_NODE_ARRAY);
+    cr_assert_eq(_JsonNode->size(array), 3);
+    cr_assert_eq(_JsonNode->asInteger(_JsonNode->get(root, "/a/0")), 1);
+    cr_assert_str_eq(_JsonNode->asString(_JsonNode->get(root, "/a/2")), "x");
+    cr_assert_eq(_JsonNode->getType(_JsonNode->get(root, "/b/c")), JSON_NODE_NULL);
+    cr_assert_str_eq(_JsonNode->getKey(root, 1), "b");
+    cr_assert_null(
+        _JsonNode->get(root, "/a/3"),
+        "Paths out of the tree should find no node"
+    );
+    assertSerializesTo(root, "{\"a\":[1,2.5,\"x\"],\"b\":{\"c\":null,\"d\":true}}");
+}
+
+
+Test(JsonNode, writes_numbers_out_of_range_back) {
+    // given a parsed json with numbers out of range
+    JsonNode * root = parse("{ \"a\": 1e400, \"b\": [-1E400, 123456789012345678901234567890], \"c\": 0.10 }");
+    JsonNode * copy = _JsonNode->retain(root);
+    Json * json;
+    char * string;
+
+    // when modifying a copy of it
+    cr_assert_eq(_JsonNode->set(& copy, "/c", _JsonNode->newFloat(1.5)), 0);
+
+    // then the numbers should be written as they were read, so that the json-string parses again
+    assertSerializesTo(root, "{\"a\":1e400,\"b\":[-1E400,123456789012345678901234567890],\"c\":0.10}");
+    assertSerializesTo(copy, "{\"a\":1e400,\"b\":[-1E400,123456789012345678901234567890],\"c\":1.5}");
+    string = _JsonNode->toString(copy);
+    json = _Json->new(string);
+    cr_assert_not_null(json);
+    _Json->delete(& json);
+    Class->delete((void **) & string);
+
+    // and floats without representation should be refused
+    cr_assert_null(_JsonNode->newFloat(_JsonNode->asFloat(_JsonNode->get(root, "/a"))));
+    cr_assert_null(_JsonNode->newFloat(- _JsonNode->asFloat(_JsonNode->get(root, "/a"))));
+
+    _JsonNode->delete(& root);
+    _JsonNode->delete(& copy);
+}
+
+
+Test(JsonNode, sets_inserts_and_removes) {
+    // given a tree
+    JsonNode * root = parse("{ \"a\": [1, 2], \"b\": 3 }");
+
+    // when modifying it
+    cr_assert_eq(_JsonNode->set(& root, "/b", _JsonNode->newString("x")), 0);
+    cr_assert_eq(_JsonNode->set(& root, "/c~1d", _JsonNode->newBoolean(0)), 0);
+    cr_assert_eq(_JsonNode->insert(& root, "/a/0", _JsonNode->newInteger(0)), 0);
+    cr_assert_eq(_JsonNode->insert(& root, "/a/-", _JsonNode->newInteger(3)), 0);
+    cr_assert_eq(_JsonNode->remove(& root, "/a/1"), 0);
+
+    // then the tree should hold the modifications
+    assertSerializesTo(root, "{\"a\":[0,2,3],\"b\":\"x\",\"c/d\":false}");
+}
+
+
+Test(JsonNode, rejects_unreachable_paths) {
+    // given a tree and a value
+    JsonNode * root = parse("{ \"a\": [1] }");
+    JsonNode * value = _JsonNode->newNull();
+
+    // when modifying paths which can't be reached
+    // then nothing should be done
+    cr_assert_eq(_JsonNode->set(& root, "/b/c", value), -1);
+    cr_assert_eq(_JsonNode->set(& root, "/a/1", value), -1);
+    cr_assert_eq(_JsonNode->insert(& root, "/a/01", value), -1);
+    cr_assert_eq(_JsonNode->remove(& root, "/a/-"), -1);
+    assertSerializesTo(root, "{\"a\":[1]}");
+}
+
+
+Test(JsonNode, shares_unmodified_subtrees_with_variants) {
+    // given a base tree
+    JsonNode * base = parse("{ \"a\": { \"x\": 1 }, \"b\": { \"y\": 2 } }");
+
+    // when deriving a variant modifying one member
+    JsonNode * variant = _JsonNode->retain(base);
+    _JsonNode->set(& variant, "/a/x", _JsonNode->newInteger(42));
+
+    // then the base should be left untouched
+    assertSerializesTo(base, "{\"a\":{\"x\":1},\"b\":{\"y\":2}}");
+    assertSerializesTo(variant, "{\"a\":{\"x\":42},\"b\":{\"y\":2}}");
+
+    // and only the modified path should have been copied
+    cr_assert_neq(variant, base);
+    cr_assert_neq(_JsonNode->get(variant, "/a"), _JsonNode->get(base, "/a"));
+    cr_assert_eq(
+        _JsonNode->get(variant, "/b"),
+        _JsonNode->get(base, "/b"),
+        "Unmodified members should be shared with the base"
+    );
+}
+
+
+Test(JsonNode, modifies_unshared_trees_in_place) {
+    // given a tree with a single owner
+    JsonNode * root = parse("{ \"a\": { \"x\": 1 } }");
+    JsonNode * member = _JsonNode->get(root, "/a");
+    JsonNode * previousRoot = root;
+
+    // when modifying it
+    _JsonNode->set(& root, "/a/x", _JsonNode->newInteger(2));
+
+    // then no node should have been copied
+    cr_assert_eq(root, previousRoot);
+    cr_assert_eq(
+        _JsonNode->get(root, "/a"),
+        member,
+        "Nodes without other owners should be modified in place"
+    );
+}
+
+
+Test(JsonNode, finds_members_of_large_objects) {
+    // given an object with enough members to be indexed
+    JsonNode * root = parse("{ \"a\": 0, \"b\": 1, \"c\": 2, \"d\": 3, \"e\": 4, \"f\": 5, \"g\": 6, \"h\": 7, \"i\": 8 }");
+
+    // when modifying and looking its members up
+    cr_assert_eq(_JsonNode->set(& root, "/j", _JsonNode->newInteger(9)), 0);
+    cr_assert_eq(_JsonNode->remove(& root, "/c"), 0);
+
+    // then every member should be found by key
+    cr_assert_eq(_JsonNode->asInteger(_JsonNode->getMember(root, "a")), 0);
+    cr_assert_eq(_JsonNode->asInteger(_JsonNode->getMember(root, "i")), 8);
+    cr_assert_eq(_JsonNode->asInteger(_JsonNode->get(root, "/j")), 9);
+    cr_assert_eq(_JsonNode->asInteger(_JsonNode->get(root, "/d")), 3);
+    cr_assert_null(_JsonNode->getMember(root, "c"));
+    cr_assert_null(_JsonNode->getMember(root, "z"));
+
+    _JsonNode->delete(& root);
+}
+
+
+Test(JsonNode, freezes_trees_for_shared_reads) {
+    // given a tree with a large object, shared by two references
+    JsonNode * root = parse("{ \"a\": 0, \"b\": 1, \"c\": 2, \"d\": 3, \"e\": 4, \"f\": 5, \"g\": 6, \"h\": { \"i\": [8] } }");
+    JsonNode * shared = _JsonNode->retain(root);
+    unsigned long hash;
+
+    // when freezing it
+    cr_assert_eq(_JsonNode->freeze(root), 0);
+    hash = _JsonNode->hash(root);
+
+    // then reads should find the same values, and modifications through a reference should copy the tree
+    cr_assert_eq(_JsonNode->asInteger(_JsonNode->getMember(root, "f")), 5);
+    cr_assert_eq(_JsonNode->asInteger(_JsonNode->get(root, "/h/i/0")), 8);
+    cr_assert_eq(_JsonNode->set(& shared, "/h/i/0", _JsonNode->newInteger(9)), 0);
+    cr_assert_neq(shared, root);
+    cr_assert_eq(_JsonNode->asInteger(_JsonNode->get(root, "/h/i/0")), 8);
+    cr_assert_eq(_JsonNode->hash(root), hash);
+    cr_assert_neq(_JsonNode->hash(shared), hash);
+
+    _JsonNode->delete(& shared);
+    _JsonNode->delete(& root);
+}
+
+
+Test(JsonNode, hashes_and_compares_structurally) {
+    // given trees differing only by member order, number representations and string escapes
+    JsonNode * root = parse("{ \"a\": [1, 2.5, \"caf\\u00e9\"], \"b\": { \"c\": null, \"d\": true } }");
+    JsonNode * other = parse("{ \"b\": { \"d\": true, \"c\": null }, \"a\": [1.0, 2.5, \"café\"] }");
+    JsonNode * different = parse("{ \"a\": [1, 2.5, \"cafe\"], \"b\": { \"c\": null, \"d\": true } }");
+
+    // when hashing and comparing them
+    // then only the structurally different tree should differ
+    cr_assert_eq(_JsonNode->hash(root), _JsonNode->hash(other));
+    cr_assert(_JsonNode->equals(root, other));
+    cr_assert(_JsonNode->equals(other, root));
+    cr_assert_neq(_JsonNode->hash(root), _JsonNode->hash(different));
+    cr_assert_not(_JsonNode->equals(root, different));
+    cr_assert(_JsonNode->equals(_JsonNode->get(root, "/b"), _JsonNode->get(other, "/b")));
+    cr_assert_not(_JsonNode->equals(_JsonNode->get(root, "/a/0"), _JsonNode->get(root, "/a/1")));
+
+    _JsonNode->delete(& root);
+    _JsonNode->delete(& other);
+    _JsonNode->delete(& different);
+}
+
+
+Test(JsonNode, hashes_modified_trees_again) {
+    // given a hashed tree shared with a copy
+    JsonNode * root = parse("{ \"a\": { \"b\": [1, 2] }, \"c\": 3 }");
+    JsonNode * copy = _JsonNode->retain(root);
+    unsigned long hash = _JsonNode->hash(root);
+
+    // when modifying the copy deep down
+    _JsonNode->set(& copy, "/a/b/1", _JsonNode->newInteger(4));
+
+    // then only the copy should hash differently
+    cr_assert_neq(_JsonNode->hash(copy), hash);
+    cr_assert_eq(_JsonNode->hash(root), hash);
+    cr_assert_not(_JsonNode->equals(root, copy));
+
+    // when restoring the value
+    _JsonNode->set(& copy, "/a/b/1", _JsonNode->newInteger(2));
+
+    // then both trees should be equal again
+    cr_assert_eq(_JsonNode->hash(copy), hash);
+    cr_assert(_JsonNode->equals(root, copy));
+
+    _JsonNode->delete(& root);
+    _JsonNode->delete(& copy);
+}
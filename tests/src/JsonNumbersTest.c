@@ -0,0 +1,163 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <criterion/criterion.h>
+
+#include "../../src/JsonToken.h"
+#include "../../src/JsonLexer.h"
+#include "../../src/JsonNumbers.h"
+
+
+
+
+static void lex(char const * const * numbers, unsigned int count, JsonLexeme * lexemes) {
+    unsigned int index;
+
+    for (index = 0; index < count; index++) {
+        lexemes[index].type = (strpbrk(numbers[index], ".eE") != NULL) ? JSON_TOKEN_FLOAT : JSON_TOKEN_INTEGER;
+        lexemes[index].start = numbers[index];
+        lexemes[index].length = strlen(numbers[index]);
+    }
+}
+
+
+Test(JsonNumbers, converts_integers_as_the_c_library_does) {
+    // given integer tokens
+    char const * const numbers[] = {
+        "0", "7", "-7", "1234", "-98765", "2147483647", "-2147483648", "100000000", "123456789012345", "-1234567890123456789"
+    };
+    unsigned int count = sizeof(numbers) / sizeof(numbers[0]);
+    JsonLexeme lexemes[10];
+    JsonIntegerValue values[10];
+    unsigned int index;
+
+    // when converting them in bulk
+    lex(numbers, count, lexemes);
+    cr_assert_eq(_JsonNumbers->convertIntegers(lexemes, count, values), 0);
+
+    // then each should have the value atol gives
+    for (index = 0; index < count; index++) {
+        cr_assert_eq(values[index], atol(numbers[index]), "'%s' should be %ld, got %ld", numbers[index], atol(numbers[index]), values[index]);
+    }
+}
+
+
+Test(JsonNumbers, converts_floats_as_the_c_library_does) {
+    // given number tokens, some beyond exact conversions
+    char const * const numbers[] = {
+        "0", "-0.0", "0.1", "3.14159", "-2.5e-3", "1e22", "1e23", "6.02214076e23", "0.000123", "1.7976931348623157e308",
+        "4.9e-324", "123456789012345", "1234567890123456789", "0.30000000000000004", "12.5E+2", "9007199254740993"
+    };
+    unsigned int count = sizeof(numbers) / sizeof(numbers[0]);
+    JsonLexeme lexemes[16];
+    JsonFloatValue values[16];
+    JsonFloatValue expected;
+    unsigned int index;
+
+    // when converting them in bulk
+    lex(numbers, count, lexemes);
+    cr_assert_eq(_JsonNumbers->convertFloats(lexemes, count, values), 0);
+
+    // then each should have exactly the value strtod gives
+    for (index = 0; index < count; index++) {
+        expected = strtod(numbers[index], NULL);
+        cr_assert(memcmp(& values[index], & expected, sizeof(expected)) == 0, "'%s' should be %.17g, got %.17g", numbers[index], expected, values[index]);
+    }
+}
+
+
+Test(JsonNumbers, reads_numbers_within_a_json_string) {
+    // given numbers followed by other characters
+    char const * const jsonString = "[12345678,-0.5]";
+    JsonLexeme lexemes[2];
+    JsonFloatValue values[2];
+    size_t offset = 1;
+
+    // when converting their lexemes
+    _JsonLexer->next(jsonString, strlen(jsonString), & offset, & lexemes[0]);
+    offset++;
+    _JsonLexer->next(jsonString, strlen(jsonString), & offset, & lexemes[1]);
+    _JsonNumbers->convertFloats(lexemes, 2, values);
+
+    // then only their own characters should be read
+    cr_assert_float_eq(values[0], 12345678, 1e-9);
+    cr_assert_float_eq(values[1], -0.5, 1e-9);
+}
+
+
+Test(JsonNumbers, agrees_with_the_c_library_on_random_numbers) {
+    // given many random integers and floats, from a fixed seed
+    char strings[JSON_NUMBERS_BATCH_SIZE][48];
+    JsonLexeme lexemes[JSON_NUMBERS_BATCH_SIZE];
+    JsonIntegerValue integers[JSON_NUMBERS_BATCH_SIZE];
+    JsonFloatValue floats[JSON_NUMBERS_BATCH_SIZE];
+    JsonIntegerValue expectedInteger;
+    JsonFloatValue expectedFloat;
+    unsigned int round;
+    unsigned int index;
+
+    srand(42);
+    for (round = 0; round < 4096; round++) {
+        for (index = 0; index < JSON_NUMBERS_BATCH_SIZE; index++) {
+            switch (rand() % 4) {
+                case 0:
+                    sprintf(strings[index], "%s%d", (rand() % 2) ? "-" : "", rand() % ((rand() % 2) ? 1000 : RAND_MAX));
+                    break;
+                case 1:
+                    sprintf(strings[index], "%s%d%09d", (rand() % 2) ? "-" : "", 1 + rand() % 999999999, rand() % 1000000000);
+                    break;
+                case 2:
+                    sprintf(strings[index], "%s%d.%de%s%d", (rand() % 2) ? "-" : "", rand() % 100000, rand(), (rand() % 2) ? "-" : "", rand() % 330);
+                    break;
+                default:
+                    sprintf(strings[index], "%.*g", 1 + rand() % 17, (double) rand() / RAND_MAX * 1e6);
+                    break;
+            }
+            lexemes[index].type = (strpbrk(strings[index], ".eE") != NULL) ? JSON_TOKEN_FLOAT : JSON_TOKEN_INTEGER;
+            lexemes[index].start = strings[index];
+            lexemes[index].length = strlen(strings[index]);
+        }
+
+        // when converting them in bulk
+        cr_assert_eq(_JsonNumbers->convertFloats(lexemes, JSON_NUMBERS_BATCH_SIZE, floats), 0);
+        for (index = 0; index < JSON_NUMBERS_BATCH_SIZE; index++) {
+            if (lexemes[index].type == JSON_TOKEN_INTEGER) {
+                cr_assert_eq(_JsonNumbers->convertIntegers(& lexemes[index], 1, & integers[index]), 0);
+            }
+        }
+
+        // then each should have exactly the value strtod and strtol give
+        for (index = 0; index < JSON_NUMBERS_BATCH_SIZE; index++) {
+            expectedFloat = strtod(strings[index], NULL);
+            cr_assert(memcmp(& floats[index], & expectedFloat, sizeof(expectedFloat)) == 0, "'%s' should be %.17g, got %.17g", strings[index], expectedFloat, floats[index]);
+            if (lexemes[index].type == JSON_TOKEN_INTEGER) {
+                expectedInteger = strtol(strings[index], NULL, 10);
+                cr_assert_eq(integers[index], expectedInteger, "'%s' should be %ld, got %ld", strings[index], expectedInteger, integers[index]);
+            }
+        }
+    }
+}
+
+
+Test(JsonNumbers, converts_numbers_longer_than_the_stack_buffer) {
+    // given numbers too long to be copied on the stack
+    char integer[128];
+    char floating[128];
+    JsonLexeme lexemes[2];
+    JsonIntegerValue integerValue;
+    JsonFloatValue floatValue;
+
+    memset(integer, '9', 100);
+    integer[100] = '\0';
+    strcpy(floating, "0.");
+    memset(floating + 2, '3', 98);
+    floating[100] = '\0';
+    lex((char const * const []) { integer, floating }, 2, lexemes);
+
+    // when converting them
+    // then they should be converted from a full copy, not a truncated one
+    cr_assert_eq(_JsonNumbers->convertIntegers(& lexemes[0], 1, & integerValue), 0);
+    cr_assert_eq(integerValue, strtol(integer, NULL, 10));
+    cr_assert_eq(_JsonNumbers->convertFloats(& lexemes[1], 1, & floatValue), 0);
+    cr_assert(floatValue == strtod(floating, NULL));
+}
@@ -0,0 +1,132 @@
+#include <criterion/criterion.h>
+
+#include "../../src/Class.h"
+#include "../../src/Json.h"
+#include "../../src/JsonNode.h"
+#include "../../src/JsonPatch.h"
+
+
+
+
+static JsonNode * parse(char const * const jsonString) {
+    Json * json = _Json->new(jsonString);
+    JsonNode * node = _JsonNode->fromJson(json);
+
+    _Json->delete(& json);
+
+    return node;
+}
+
+static void assertSerializesTo(JsonNode const * const node, char const * const expected) {
+    char * string = _JsonNode->toString(node);
+
+    cr_assert_str_eq(string, expected, "Expected '%s', got '%s'", expected, string);
+    Class->delete((void **) & string);
+}
+
+
+
+
+Test(JsonPatch, applies_every_operation) {
+    // given a tree and a patch using every operation
+    JsonNode * root = parse("{ \"a\": [1, 2], \"b\": { \"c\": 3 }, \"d\": \"x\" }");
+    JsonNode * patch = parse(
+        "["
+        "{ \"op\": \"add\", \"path\": \"/a/1\", \"value\": 5 },"
+        "{ \"op\": \"remove\", \"path\": \"/d\" },"
+        "{ \"op\": \"replace\", \"path\": \"/b/c\", \"value\": [true] },"
+        "{ \"op\": \"move\", \"from\": \"/a/0\", \"path\": \"/e\" },"
+        "{ \"op\": \"copy\", \"from\": \"/b\", \"path\": \"/a/-\" },"
+        "{ \"op\": \"test\", \"path\": \"/e\", \"value\": 1.0 }"
+        "]"
+    );
+    unsigned int failedIndex;
+
+    // when applying the patch
+    int status = _JsonPatch->apply(& root, patch, & failedIndex);
+
+    // then the tree should hold the result of every operation
+    cr_assert_eq(status, 0);
+    assertSerializesTo(root, "{\"a\":[5,2,{\"c\":[true]}],\"b\":{\"c\":[true]},\"e\":1}");
+
+    _JsonNode->delete(& patch);
+    _JsonNode->delete(& root);
+}
+
+
+Test(JsonPatch, reports_failed_operation_and_keeps_tree) {
+    // given a tree and a patch whose third operation fails
+    JsonNode * root = parse("{ \"a\": [1, 2] }");
+    JsonNode * original = _JsonNode->retain(root);
+    JsonNode * patch = parse(
+        "["
+        "{ \"op\": \"add\", \"path\": \"/b\", \"value\": 3 },"
+        "{ \"op\": \"remove\", \"path\": \"/a/0\" },"
+        "{ \"op\": \"test\", \"path\": \"/b\", \"value\": \"3\" },"
+        "{ \"op\": \"add\", \"path\": \"/c\", \"value\": 4 }"
+        "]"
+    );
+    unsigned int failedIndex;
+
+    // when applying the patch
+    int status = _JsonPatch->apply(& root, patch, & failedIndex);
+
+    // then no operation should be applied
+    cr_assert_eq(status, -1);
+    cr_assert_eq(failedIndex, 2);
+    cr_assert_eq(root, original, "The root shouldn't be replaced");
+    assertSerializesTo(root, "{\"a\":[1,2]}");
+
+    _JsonNode->delete(& original);
+    _JsonNode->delete(& patch);
+    _JsonNode->delete(& root);
+}
+
+
+Test(JsonPatch, rejects_invalid_operations) {
+    // given a tree
+    JsonNode * root = parse("{ \"a\": { \"b\": 1 } }");
+    JsonNode * patch;
+    unsigned int failedIndex;
+    char const * patches[] = {
+        "[{ \"op\": \"replace\", \"path\": \"/c\", \"value\": 1 }]",
+        "[{ \"op\": \"move\", \"from\": \"/a\", \"path\": \"/a/b\" }]",
+        "[{ \"op\": \"add\", \"path\": \"/a/b\" }]",
+        "[{ \"op\": \"unknown\", \"path\": \"/a\" }]",
+        "[{ \"op\": \"remove\", \"path\": \"/a/c\" }]"
+    };
+    unsigned int index;
+
+    // when applying invalid patches
+    // then they should all fail
+    for (index = 0; index < sizeof(patches) / sizeof(patches[0]); index++) {
+        patch = parse(patches[index]);
+        cr_assert_eq(_JsonPatch->apply(& root, patch, & failedIndex), -1, "Patch %u should fail", index);
+        cr_assert_eq(failedIndex, 0);
+        _JsonNode->delete(& patch);
+    }
+    assertSerializesTo(root, "{\"a\":{\"b\":1}}");
+
+    _JsonNode->delete(& root);
+}
+
+
+Test(JsonPatch, merges_patch) {
+    // given a tree and a merge patch
+    JsonNode * root = parse("{ \"a\": \"b\", \"c\": { \"d\": \"e\", \"f\": \"g\" }, \"h\": [1] }");
+    JsonNode * original = _JsonNode->retain(root);
+    JsonNode * patch = parse("{ \"a\": \"z\", \"c\": { \"f\": null, \"i\": { \"j\": 1 } }, \"h\": null, \"k~/\": [] }");
+
+    // when merging the patch
+    int status = _JsonPatch->merge(& root, patch);
+
+    // then the patched tree should be a copy, sharing the untouched nodes
+    cr_assert_eq(status, 0);
+    assertSerializesTo(root, "{\"a\":\"z\",\"c\":{\"d\":\"e\",\"i\":{\"j\":1}},\"k~/\":[]}");
+    assertSerializesTo(original, "{\"a\":\"b\",\"c\":{\"d\":\"e\",\"f\":\"g\"},\"h\":[1]}");
+    cr_assert_eq(_JsonNode->get(root, "/c/d"), _JsonNode->get(original, "/c/d"));
+
+    _JsonNode->delete(& original);
+    _JsonNode->delete(& patch);
+    _JsonNode->delete(& root);
+}
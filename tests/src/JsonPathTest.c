@@ -0,0 +1,167 @@
+#include <stdio.h>
+#include <string.h>
+#include <criterion/criterion.h>
+
+#include "../../src/Json.h"
+#include "../../src/JsonToken.h"
+#include "../../src/JsonPath.h"
+
+
+
+
+static char const * const store =
+    "{ \"store\": {"
+    "    \"book\": ["
+    "        { \"title\": \"A\", \"price\": 8.95, \"qty\": 5 },"
+    "        { \"title\": \"B\", \"price\": 12.99, \"qty\": 20, \"isbn\": \"x\" },"
+    "        { \"title\": \"C\", \"price\": 22, \"qty\": 11, \"tags\": [] }"
+    "    ],"
+    "    \"bicycle\": { \"price\": 19.95, \"id\": 7 }"
+    "}, \"id\": 1 }";
+
+static void assertSelects(Json const * const json, char const * const expression, char const * const expected) {
+    JsonPath * path = _JsonPath->new(expression);
+    unsigned int indexes[16];
+    unsigned int count;
+    unsigned int index;
+    char selected[256] = "";
+
+    cr_assert_not_null(path, "'%s' should compile", expression);
+    count = _JsonPath->select(path, json, indexes, 16);
+    for (index = 0; index < count; index++) {
+        strcat(selected, (index > 0) ? " " : "");
+        strcat(selected, _JsonToken->getRawString(_Json->getToken(json, indexes[index])));
+    }
+
+    cr_assert_str_eq(selected, expected, "'%s' should select '%s', got '%s'", expression, expected, selected);
+    _JsonPath->delete(& path);
+}
+
+
+
+
+Test(JsonPath, selects_children_and_elements) {
+    // given a json
+    Json * json = _Json->new(store);
+
+    // when selecting children, elements and wildcards
+    // then the matching values should be found in document order
+    assertSelects(json, "$.store.book[1].title", "\"B\"");
+    assertSelects(json, "$['store'][\"bicycle\"].id", "7");
+    assertSelects(json, "$.store.book[*].price", "8.95 12.99 22");
+    assertSelects(json, "$.store.*.price", "19.95");
+    assertSelects(json, "$.store.book[3]", "");
+    assertSelects(json, "$.id[0]", "");
+    assertSelects(json, "$", "{");
+
+    _Json->delete(& json);
+}
+
+
+Test(JsonPath, selects_descendants) {
+    // given a json
+    Json * json = _Json->new(store);
+
+    // when selecting descendants
+    // then every matching descendant should be found in document order
+    assertSelects(json, "$..price", "8.95 12.99 22 19.95");
+    assertSelects(json, "$..id", "7 1");
+    assertSelects(json, "$..book[2].title", "\"C\"");
+    assertSelects(json, "$..[0].qty", "5");
+
+    _Json->delete(& json);
+}
+
+
+Test(JsonPath, filters_values) {
+    // given a json
+    Json * json = _Json->new(store);
+
+    // when filtering values
+    // then only the values passing the filter should be selected
+    assertSelects(json, "$.store.book[?(@.qty > 10)].title", "\"B\" \"C\"");
+    assertSelects(json, "$.store.book[?(@.price <= 12.99)].qty", "5 20");
+    assertSelects(json, "$.store.book[?(@.title == 'C')].price", "22");
+    assertSelects(json, "$.store.book[?(@.title != 'C')].price", "8.95 12.99");
+    assertSelects(json, "$.store.book[?(@.isbn)].title", "\"B\"");
+    assertSelects(json, "$..book[?(@.tags)].qty", "11");
+    assertSelects(json, "$.store.book[*].qty[?(@ > 10)]", "");
+    assertSelects(json, "$.store.book[*][?(@ == 20)]", "20");
+
+    _Json->delete(& json);
+}
+
+
+Test(JsonPath, counts_matches_beyond_capacity) {
+    // given a json and a query with several matches
+    Json * json = _Json->new(store);
+    JsonPath * path = _JsonPath->new("$..price");
+    unsigned int indexes[1];
+
+    // when selecting into a single index
+    unsigned int count = _JsonPath->select(path, json, indexes, 1);
+
+    // then every match should be counted, the first one stored
+    cr_assert_eq(count, 4);
+    cr_assert_str_eq(_JsonToken->getRawString(_Json->getToken(json, indexes[0])), "8.95");
+
+    _JsonPath->delete(& path);
+    _Json->delete(& json);
+}
+
+
+Test(JsonPath, selects_in_a_batch_of_jsons_on_several_threads) {
+    // given many frozen jsons, each with its own number of matches
+    Json * jsons[100];
+    unsigned int counts[100];
+    unsigned int indexes[100 * 4];
+    JsonPath * path = _JsonPath->new("$.items[?(@.qty > 10)].price");
+    char jsonString[512];
+    unsigned int index;
+    unsigned int item;
+    unsigned long count;
+
+    for (index = 0; index < 100; index++) {
+        strcpy(jsonString, "{ \"items\": [");
+        for (item = 0; item < index % 7; item++) {
+            sprintf(jsonString + strlen(jsonString), "%s{ \"qty\": %u, \"price\": %u }", (item > 0) ? ", " : "", (item % 2) ? 20 : 5, index * 10 + item);
+        }
+        strcat(jsonString, "] }");
+        jsons[index] = _Json->new(jsonString);
+        _Json->freeze(jsons[index]);
+    }
+
+    // when selecting in all of them on four threads
+    count = _JsonPath->selectBatch(path, (Json const * const *) jsons, 100, counts, indexes, 4, 4);
+
+    // then each json should get the matches a single select finds
+    cr_assert_eq(count, 14 * (0 + 0 + 1 + 1 + 2 + 2 + 3));
+    for (index = 0; index < 100; index++) {
+        unsigned int expected[4];
+
+        cr_assert_eq(counts[index], _JsonPath->select(path, jsons[index], expected, 4));
+        cr_assert_eq(counts[index], (index % 7) / 2);
+        for (item = 0; item < counts[index]; item++) {
+            cr_assert_eq(indexes[index * 4 + item], expected[item]);
+            cr_assert_eq(_JsonToken->asInteger(_Json->getToken(jsons[index], expected[item])), index * 10 + item * 2 + 1);
+        }
+        _Json->delete(& jsons[index]);
+    }
+
+    _JsonPath->delete(& path);
+}
+
+
+Test(JsonPath, rejects_invalid_queries) {
+    // given invalid queries
+    char const * const expressions[] = {
+        "store", "$.", "$..", "$[", "$['a'", "$[a]", "$[?(@.a ==)]", "$[?(@.a > 1]", "$[?(@. > 1)]", "$.a b"
+    };
+    unsigned int index;
+
+    // when compiling them
+    // then they should be rejected
+    for (index = 0; index < sizeof(expressions) / sizeof(expressions[0]); index++) {
+        cr_assert_null(_JsonPath->new(expressions[index]), "'%s' should be rejected", expressions[index]);
+    }
+}
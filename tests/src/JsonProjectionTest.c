@@ -0,0 +1,115 @@
+#include <string.h>
+#include <criterion/criterion.h>
+
+#include "../../src/LinkedList.h"
+#include "../../src/JsonToken.h"
+#include "../../src/JsonProjection.h"
+
+
+
+
+static void assertTokens(LinkedList * tokens, char const * const * expectedTokens, unsigned int expectedCount) {
+    unsigned int tokenIndex;
+
+    for (tokenIndex = 0; tokenIndex < expectedCount; tokenIndex++) {
+        cr_assert_not_null(tokens, "Expected token '%s', got none", expectedTokens[tokenIndex]);
+        cr_assert_str_eq(
+            _JsonToken->getRawString(_LinkedList->getContent(tokens)),
+            expectedTokens[tokenIndex],
+            "Expected to find the token '%s'", expectedTokens[tokenIndex]
+        );
+        tokens = _LinkedList->nextElement(tokens);
+    }
+
+    cr_assert_null(tokens, "Expected no more tokens");
+}
+
+
+Test(JsonProjection, extracts_requested_members_only) {
+    // given a json object and paths to some of its members
+    char * jsonString = "{ \"id\": 42, \"tags\": [1, 2], \"user\": { \"name\": \"foo\", \"country\": \"FR\" }, \"ts\": 7 }";
+    char const * paths[] = { "/user/country", "/id" };
+    char const * expectedTokens[] = {
+        "{", "\"id\"", ":", "42", ",", "\"user\"", ":", "{", "\"country\"", ":", "\"FR\"", "}", "}"
+    };
+    LinkedList * tokens;
+
+    // when extracting them
+    int status = _JsonProjection->extractTokens(jsonString, strlen(jsonString), paths, 2, NULL, NULL, 0, & tokens);
+
+    // then only the members and their ancestors should be extracted
+    cr_assert_eq(status, 0);
+    assertTokens(tokens, expectedTokens, 13);
+}
+
+
+Test(JsonProjection, copies_whole_requested_values) {
+    // given a json object and a path to a container
+    char * jsonString = "{ \"a\": 1, \"tags\": [1, { \"b\": true }] }";
+    char const * paths[] = { "/tags" };
+    char const * expectedTokens[] = {
+        "{", "\"tags\"", ":", "[", "1", ",", "{", "\"b\"", ":", "true", "}", "]", "}"
+    };
+    LinkedList * tokens;
+
+    // when extracting it
+    int status = _JsonProjection->extractTokens(jsonString, strlen(jsonString), paths, 1, NULL, NULL, 0, & tokens);
+
+    // then the whole container should be extracted
+    cr_assert_eq(status, 0);
+    assertTokens(tokens, expectedTokens, 13);
+}
+
+
+Test(JsonProjection, stops_once_every_path_is_found) {
+    // given a json object which is malformed after the requested member
+    char * jsonString = "{ \"id\": 42, \"rest\": ?!";
+    char const * paths[] = { "/id" };
+    char const * expectedTokens[] = { "{", "\"id\"", ":", "42", "}" };
+    LinkedList * tokens;
+
+    // when extracting the member
+    int status = _JsonProjection->extractTokens(jsonString, strlen(jsonString), paths, 1, NULL, NULL, 0, & tokens);
+
+    // then reading should have stopped before the malformed part
+    cr_assert_eq(
+        status,
+        0,
+        "Extraction should stop once every path was found"
+    );
+    assertTokens(tokens, expectedTokens, 5);
+}
+
+
+Test(JsonProjection, skips_members_not_leading_to_paths) {
+    // given a json object without the requested path
+    char * jsonString = "{ \"user\": 42, \"other\": { \"country\": 1 } }";
+    char const * paths[] = { "/user/country" };
+    char const * expectedTokens[] = { "{", "}" };
+    LinkedList * tokens;
+
+    // when extracting it
+    int status = _JsonProjection->extractTokens(jsonString, strlen(jsonString), paths, 1, NULL, NULL, 0, & tokens);
+
+    // then only the root should be extracted
+    cr_assert_eq(status, 0);
+    assertTokens(tokens, expectedTokens, 2);
+}
+
+
+Test(JsonProjection, rejects_malformed_json) {
+    // given a malformed json object
+    char * jsonString = "{ \"id\" 42 }";
+    char const * paths[] = { "/id" };
+    LinkedList * tokens;
+
+    // when extracting from it
+    int status = _JsonProjection->extractTokens(jsonString, strlen(jsonString), paths, 1, NULL, NULL, 0, & tokens);
+
+    // then extraction should fail
+    cr_assert_eq(
+        status,
+        -1,
+        "Malformed json should be rejected"
+    );
+}
@@ -0,0 +1,598 @@
+#include <limits.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <criterion/criterion.h>
+
+#include "../../src/JsonToken.h"
+#include "../../src/JsonSax.h"
+
+
+
+
+typedef struct {
+    char events[256];
+    unsigned int eventsCount;
+    unsigned int stopAfter;
+} Recorder;
+
+static int record(Recorder * recorder, char event) {
+    recorder->events[recorder->eventsCount] = event;
+    recorder->eventsCount++;
+    return (recorder->stopAfter != 0) && (recorder->eventsCount == recorder->stopAfter);
+}
+
+static int onObjectStart(void * context) { return record(context, '{'); }
+static int onObjectEnd(void * context) { return record(context, '}'); }
+static int onArrayStart(void * context) { return record(context, '['); }
+static int onArrayEnd(void * context) { return record(context, ']'); }
+static int onKey(void * context, char const * key, size_t length) { (void) key; (void) length; return record(context, 'k'); }
+static int onString(void * context, char const * value, size_t length) { (void) value; (void) length; return record(context, 's'); }
+static int onInteger(void * context, JsonIntegerValue value) { (void) value; return record(context, 'i'); }
+static int onFloat(void * context, JsonFloatValue value) { (void) value; return record(context, 'f'); }
+static int onBoolean(void * context, JsonBooleanValue value) { (void) value; return record(context, 'b'); }
+static int onNull(void * context) { return record(context, 'n'); }
+
+static JsonSaxHandler const recorderHandler = {
+    onObjectStart, onObjectEnd, onArrayStart, onArrayEnd, onKey, onString, onInteger, onFloat, onBoolean, onNull, NULL, NULL
+};
+
+
+static long integersSum;
+
+static int sumInteger(void * context, JsonIntegerValue value) {
+    (void) context;
+    integersSum += value;
+    return 0;
+}
+
+
+static int storeFloat(void * context, JsonFloatValue value) {
+    * (JsonFloatValue *) context = value;
+    return 0;
+}
+
+
+static char keyCopy[16];
+
+static int copyKey(void * context, char const * key, size_t length) {
+    (void) context;
+    memcpy(keyCopy, key, length);
+    keyCopy[length] = '\0';
+    return 0;
+}
+
+
+
+
+Test(JsonSax, calls_back_every_event_in_order) {
+    // given a json-string with every kind of value
+    char * jsonString = "{ \"a\": [1, 2.5, \"x\", true, null], \"b\": {} }";
+    Recorder recorder;
+
+    memset(& recorder, 0, sizeof(recorder));
+
+    // when reading it
+    int status = _JsonSax->parse(jsonString, strlen(jsonString), & recorderHandler, & recorder, NULL);
+
+    // then every event should have been called back in order
+    cr_assert_eq(status, 0);
+    recorder.events[recorder.eventsCount] = '\0';
+    cr_assert_str_eq(
+        recorder.events,
+        "{k[ifsbn]k{}}",
+        "Events should follow the json-string"
+    );
+}
+
+
+Test(JsonSax, stops_when_a_callback_asks_to) {
+    // given a handler stopping after the third event
+    char * jsonString = "[1, 2, 3, 4]";
+    Recorder recorder;
+
+    memset(& recorder, 0, sizeof(recorder));
+    recorder.stopAfter = 3;
+
+    // when reading a json-string
+    int status = _JsonSax->parse(jsonString, strlen(jsonString), & recorderHandler, & recorder, NULL);
+
+    // then the parse should have stopped
+    cr_assert_eq(status, 1);
+    cr_assert_eq(
+        recorder.eventsCount,
+        3,
+        "No event should be called back once a callback asked to stop"
+    );
+}
+
+
+Test(JsonSax, skips_missing_callbacks) {
+    // given a handler only summing integers
+    char * jsonString = "{ \"a\": [10, 20], \"b\": { \"c\": 12 }, \"d\": \"13\" }";
+    JsonSaxHandler handler;
+
+    memset(& handler, 0, sizeof(handler));
+    handler.onInteger = sumInteger;
+    integersSum = 0;
+
+    // when reading a json-string
+    int status = _JsonSax->parse(jsonString, strlen(jsonString), & handler, NULL, NULL);
+
+    // then only integers should have been seen
+    cr_assert_eq(status, 0);
+    cr_assert_eq(
+        integersSum,
+        42,
+        "Integer values should be converted and summed"
+    );
+}
+
+
+Test(JsonSax, borrows_strings_without_quotes) {
+    // given a handler copying keys
+    char * jsonString = "{ \"name\": 1 }";
+    JsonSaxHandler handler;
+
+    memset(& handler, 0, sizeof(handler));
+    handler.onKey = copyKey;
+
+    // when reading a json-string
+    _JsonSax->parse(jsonString, strlen(jsonString), & handler, NULL, NULL);
+
+    // then the key should be given without its quotes
+    cr_assert_str_eq(
+        keyCopy,
+        "name",
+        "Keys should be borrowed without their quotes"
+    );
+}
+
+
+static int recordKeyId(void * context, int id) { return record(context, (char) ('0' + id + 1)); }
+
+Test(JsonSax, maps_known_keys_to_ids) {
+    // given a handler with a set of known keys
+    char const * const keys[] = { "id", "name", "tags" };
+    char const * slottedKeys[3];
+    int displacements[3];
+    unsigned int slots[3];
+    JsonKeySet const set = { 3, displacements, slottedKeys };
+    unsigned int index;
+    char * jsonString = "{ \"name\": 1, \"other\": { \"id\": 2 } }";
+    char expected[16];
+    Recorder recorder;
+    JsonSaxHandler handler;
+
+    memset(& recorder, 0, sizeof(recorder));
+    memset(& handler, 0, sizeof(handler));
+    handler.onKeyId = recordKeyId;
+    handler.onKey = onKey;
+    handler.keys = & set;
+    cr_assert_eq(_JsonKeys->build(keys, 3, displacements, slots), 0);
+    for (index = 0; index < 3; index++) {
+        slottedKeys[slots[index]] = keys[index];
+    }
+
+    // when reading a json-string
+    _JsonSax->parse(jsonString, strlen(jsonString), & handler, & recorder, NULL);
+
+    // then each key should be given as its slot, -1 for unknown keys
+    sprintf(expected, "%c%c%c", '0' + slots[1] + 1, '0', '0' + slots[0] + 1);
+    cr_assert_eq(recorder.eventsCount, 3);
+    cr_assert(memcmp(recorder.events, expected, 3) == 0);
+}
+
+
+Test(JsonSax, rejects_invalid_syntax) {
+    // given an invalid json-string
+    char * jsonString = "{ \"a\" 1 }";
+    JsonSaxHandler handler;
+    JsonError error;
+
+    memset(& handler, 0, sizeof(handler));
+
+    // when reading it
+    int status = _JsonSax->parse(jsonString, strlen(jsonString), & handler, NULL, & error);
+
+    // then it should be rejected at the unexpected token
+    cr_assert_eq(status, -1);
+    cr_assert_eq(error.code, JSON_ERROR_UNEXPECTED_TOKEN);
+    cr_assert_eq(error.offset, 6);
+}
+
+
+Test(JsonSax, reads_chunks_of_any_size) {
+    // given a json-string whose tokens may be cut anywhere
+    char * jsonString = "{ \"key\": [123456, -2.5e10, \"a \\\" long string\", true, false, null], \"k2\": {} }";
+    unsigned int length = strlen(jsonString);
+    unsigned int chunkSize;
+    unsigned int offset;
+    JsonSaxStream stream;
+    Recorder recorder;
+
+    for (chunkSize = 1; chunkSize <= length; chunkSize++) {
+        memset(& recorder, 0, sizeof(recorder));
+
+        // when feeding it chunk by chunk
+        _JsonSax->begin(& stream, & recorderHandler, & recorder);
+        for (offset = 0; offset < length; offset += chunkSize) {
+            cr_assert_eq(_JsonSax->feed(& stream, jsonString + offset, (length - offset < chunkSize) ? length - offset : chunkSize), 0);
+        }
+
+        // then every event should have been called back once, in order
+        cr_assert_eq(_JsonSax->end(& stream, NULL), 0);
+        recorder.events[recorder.eventsCount] = '\0';
+        cr_assert_str_eq(recorder.events, "{k[ifsbbn]k{}}", "Chunks of %u characters should give every event", chunkSize);
+    }
+}
+
+
+Test(JsonSax, completes_numbers_cut_by_chunks) {
+    // given a json-string fed in two chunks cutting numbers
+    JsonSaxHandler handler;
+    JsonSaxStream stream;
+
+    memset(& handler, 0, sizeof(handler));
+    handler.onInteger = sumInteger;
+    integersSum = 0;
+
+    // when feeding it
+    _JsonSax->begin(& stream, & handler, NULL);
+    _JsonSax->feed(& stream, "[10, 2", 6);
+    _JsonSax->feed(& stream, "0, 1]", 5);
+
+    // then numbers should only be converted once complete
+    cr_assert_eq(_JsonSax->end(& stream, NULL), 0);
+    cr_assert_eq(integersSum, 31);
+}
+
+
+Test(JsonSax, converts_numbers_of_any_length) {
+    // given numbers longer than the stack copy used to convert them
+    char string[256];
+    JsonSaxHandler handler;
+    JsonFloatValue floating = 0;
+
+    memset(& handler, 0, sizeof(handler));
+    handler.onInteger = sumInteger;
+    handler.onFloat = storeFloat;
+    integersSum = 0;
+    strcpy(string, "[1.25");
+    memset(string + 5, '0', 70);
+    strcpy(string + 75, ", 1");
+    memset(string + 78, '0', 70);
+    strcpy(string + 148, "]");
+
+    // when parsing them
+    // then they should be converted from a copy on the heap
+    cr_assert_eq(_JsonSax->parse(string, strlen(string), & handler, & floating, NULL), 0);
+    cr_assert_float_eq(floating, 1.25, 1e-12);
+    cr_assert_eq(integersSum, LONG_MAX);
+}
+
+
+Test(JsonSax, rejects_invalid_chunks_at_their_offset) {
+    // given a json-string with an invalid token in its second chunk
+    JsonSaxHandler handler;
+    JsonSaxStream stream;
+    JsonError error;
+
+    memset(& handler, 0, sizeof(handler));
+
+    // when feeding it
+    _JsonSax->begin(& stream, & handler, NULL);
+    cr_assert_eq(_JsonSax->feed(& stream, "[true, tr", 9), 0);
+    cr_assert_eq(_JsonSax->feed(& stream, "ux]", 3), -1);
+
+    // then the offset should be counted from the start of the json-string
+    cr_assert_eq(_JsonSax->end(& stream, & error), -1);
+    cr_assert_eq(error.code, JSON_ERROR_INVALID_TOKEN);
+    cr_assert_eq(error.offset, 7);
+}
+
+
+Test(JsonSax, reads_files) {
+    // given a file larger than a chunk
+    FILE * file = tmpfile();
+    JsonSaxHandler handler;
+    unsigned int index;
+    int status;
+
+    fputc('[', file);
+    for (index = 0; index < 20000; index++) {
+        fprintf(file, "%s%u", (index > 0) ? ", " : "", index % 7);
+    }
+    fputc(']', file);
+    rewind(file);
+
+    memset(& handler, 0, sizeof(handler));
+    handler.onInteger = sumInteger;
+    integersSum = 0;
+
+    // when reading it
+    status = _JsonSax->parseFile(file, & handler, NULL, NULL);
+    fclose(file);
+
+    // then every value should have been read
+    cr_assert_eq(status, 0);
+    cr_assert_eq(integersSum, 59997);
+}
+
+
+Test(JsonSax, reads_files_from_their_current_position) {
+    // given a file whose first characters were already read
+    FILE * file = tmpfile();
+    JsonSaxHandler handler;
+
+    fputs("header [1, 2, 39]", file);
+    fseek(file, 7, SEEK_SET);
+
+    memset(& handler, 0, sizeof(handler));
+    handler.onInteger = sumInteger;
+    integersSum = 0;
+
+    // when reading it
+    // then only the json-string following the position should have been read
+    cr_assert_eq(_JsonSax->parseFile(file, & handler, NULL, NULL), 0);
+    cr_assert_eq(integersSum, 42);
+    fclose(file);
+}
+
+
+Test(JsonSax, reads_mapped_files_through_a_sliding_window) {
+    // given a file spanning many pages, with strings and numbers cut by page boundaries
+    char path[] = "/tmp/JsonSaxTestXXXXXX";
+    FILE * file;
+    JsonSaxHandler handler;
+    JsonError error;
+    unsigned int index;
+    long size;
+
+    close(mkstemp(path));
+    file = fopen(path, "w");
+    fputc('[', file);
+    for (index = 0; index < 20000; index++) {
+        fprintf(file, "%s{ \"name\": \"value number %u\", \"n\": %u }", (index > 0) ? ", " : "", index, index % 7);
+    }
+    fputc(']', file);
+    size = ftell(file);
+    fclose(file);
+
+    memset(& handler, 0, sizeof(handler));
+    handler.onInteger = sumInteger;
+    integersSum = 0;
+
+    // when reading it a page at a time
+    // then every value should have been read
+    cr_assert_eq(_JsonSax->parseMappedFile(path, 1, & handler, NULL, NULL), 0);
+    cr_assert_eq(integersSum, 59997);
+
+    // and errors past the first window should be reported at their offset in the file
+    file = fopen(path, "a");
+    fputs(" ]", file);
+    fclose(file);
+    cr_assert_eq(_JsonSax->parseMappedFile(path, 1, & handler, NULL, & error), -1);
+    cr_assert_eq(error.code, JSON_ERROR_UNEXPECTED_TOKEN);
+    cr_assert_eq(error.offset, (size_t) size + 1);
+
+    unlink(path);
+    cr_assert_eq(_JsonSax->parseMappedFile(path, 1, & handler, NULL, & error), -1);
+    cr_assert_eq(error.code, JSON_ERROR_READ);
+}
+
+
+Test(JsonSax, counts_offsets_past_4_gigabytes) {
+    // given a stream having already read more than 4 GB
+    size_t consumed = (sizeof(size_t) > 4) ? ((size_t) 5 << 30) + 3 : 3;
+    JsonSaxStream stream;
+    JsonSaxHandler handler;
+    JsonError error;
+
+    memset(& handler, 0, sizeof(handler));
+    _JsonSax->begin(& stream, & handler, NULL);
+    _JsonSax->feed(& stream, "[[[", 3);
+    stream.consumed = consumed;
+
+    // when feeding an invalid chunk
+    _JsonSax->feed(& stream, "1, }", 4);
+
+    // then the error should be reported at its offset, without wrapping
+    cr_assert_eq(_JsonSax->end(& stream, & error), -1);
+    cr_assert_eq(error.code, JSON_ERROR_UNEXPECTED_TOKEN);
+    cr_assert_eq(error.offset, consumed + 3);
+}
+
+
+typedef struct {
+    unsigned int valuesCount;
+    unsigned int valueIndex;
+    unsigned int failAfter;
+} Generator;
+
+static int generate(void * context, char * window, unsigned int capacity) {
+    Generator * generator = context;
+    unsigned int length = 0;
+
+    if ((generator->failAfter != 0) && (generator->valueIndex >= generator->failAfter)) {
+        return -1;
+    }
+
+    // decodes one value at a time, much like a decompressor filling its window
+    if (generator->valueIndex < generator->valuesCount) {
+        length = sprintf(window, "%s%u", (generator->valueIndex == 0) ? "[" : ",", generator->valueIndex % 7);
+        generator->valueIndex++;
+    } else if (generator->valueIndex == generator->valuesCount) {
+        window[0] = ']';
+        length = 1;
+        generator->valueIndex++;
+    }
+
+    cr_assert(length <= capacity);
+    return length;
+}
+
+
+Test(JsonSax, reads_sources_through_a_window) {
+    // given a source decoding a json-string much larger than the window
+    Generator generator = { 20000, 0, 0 };
+    JsonSaxSource source = { generate, & generator };
+    JsonSaxHandler handler;
+    int status;
+
+    memset(& handler, 0, sizeof(handler));
+    handler.onInteger = sumInteger;
+    integersSum = 0;
+
+    // when reading it
+    status = _JsonSax->parseSource(& source, 16, & handler, NULL, NULL);
+
+    // then every value should have been read
+    cr_assert_eq(status, 0);
+    cr_assert_eq(integersSum, 59997);
+}
+
+
+Test(JsonSax, rejects_failing_sources) {
+    // given a source failing in the middle of the json-string
+    Generator generator = { 100, 0, 50 };
+    JsonSaxSource source = { generate, & generator };
+    JsonSaxHandler handler;
+    JsonError error;
+
+    memset(& handler, 0, sizeof(handler));
+
+    // when reading it
+    int status = _JsonSax->parseSource(& source, 16, & handler, NULL, & error);
+
+    // then the read should fail where the source did
+    cr_assert_eq(status, -1);
+    cr_assert_eq(error.code, JSON_ERROR_READ);
+    cr_assert_eq(error.offset, 100);
+}
+
+
+Test(JsonSax, reads_sources_on_a_reader_thread) {
+    // given sources decoding a json-string much larger than a buffer, one of them failing in the middle
+    Generator generator = { 20000, 0, 0 };
+    Generator failing = { 100, 0, 50 };
+    JsonSaxSource source = { generate, & generator };
+    JsonSaxSource failingSource = { generate, & failing };
+    JsonSaxHandler handler;
+    JsonError error;
+
+    memset(& handler, 0, sizeof(handler));
+    handler.onInteger = sumInteger;
+    integersSum = 0;
+
+    // when reading them through a ring of buffers
+    // then every value should have been read, and the read should fail where the source did
+    cr_assert_eq(_JsonSax->parseSourceAsync(& source, 3, 16, & handler, NULL, NULL), 0);
+    cr_assert_eq(integersSum, 59997);
+    cr_assert_eq(_JsonSax->parseSourceAsync(& failingSource, 3, 16, & handler, NULL, & error), -1);
+    cr_assert_eq(error.code, JSON_ERROR_READ);
+    cr_assert_eq(error.offset, 100);
+}
+
+
+typedef struct {
+    unsigned int chunksCount;
+    long readDelay;
+    long parseDelay;
+    unsigned int readCount;
+    unsigned int parsedCount;
+    unsigned int maximumAhead;
+} SlowPipeline;
+
+static void waitMilliseconds(long milliseconds) {
+    struct timespec duration = { 0, milliseconds * 1000000L };
+    nanosleep(& duration, NULL);
+}
+
+static double elapsedMilliseconds(struct timespec const * start) {
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, & end);
+    return (end.tv_sec - start->tv_sec) * 1000.0 + (end.tv_nsec - start->tv_nsec) / 1000000.0;
+}
+
+static int readSlowly(void * context, char * window, unsigned int capacity) {
+    SlowPipeline * pipeline = context;
+    unsigned int index = __sync_add_and_fetch(& pipeline->readCount, 0);
+    (void) capacity;
+
+    // like a disk, each chunk takes a while to come
+    waitMilliseconds(pipeline->readDelay);
+    if (index > pipeline->chunksCount) {
+        return 0;
+    }
+    window[0] = (index == 0) ? '[' : ((index == pipeline->chunksCount) ? ']' : ',');
+    window[1] = '1';
+    __sync_add_and_fetch(& pipeline->readCount, 1);
+
+    return (index == pipeline->chunksCount) ? 1 : 2;
+}
+
+static int parseSlowly(void * context, JsonIntegerValue value) {
+    SlowPipeline * pipeline = context;
+    unsigned int ahead = __sync_add_and_fetch(& pipeline->readCount, 0) - pipeline->parsedCount;
+    (void) value;
+
+    // and each value takes as long to handle
+    if (ahead > pipeline->maximumAhead) {
+        pipeline->maximumAhead = ahead;
+    }
+    waitMilliseconds(pipeline->parseDelay);
+    pipeline->parsedCount++;
+
+    return 0;
+}
+
+
+Test(JsonSax, overlaps_reading_and_parsing) {
+    // given a source and a handler as slow as each other
+    SlowPipeline pipeline = { 50, 2, 2, 0, 0, 0 };
+    JsonSaxSource source = { readSlowly, & pipeline };
+    JsonSaxHandler handler;
+    struct timespec start;
+    double sequentialTime;
+    double asyncTime;
+
+    memset(& handler, 0, sizeof(handler));
+    handler.onInteger = parseSlowly;
+
+    // when reading the json-string on the parsing thread, then on a reader thread
+    clock_gettime(CLOCK_MONOTONIC, & start);
+    cr_assert_eq(_JsonSax->parseSource(& source, 16, & handler, & pipeline, NULL), 0);
+    sequentialTime = elapsedMilliseconds(& start);
+    cr_assert_eq(pipeline.parsedCount, 50);
+
+    pipeline.readCount = 0;
+    pipeline.parsedCount = 0;
+    pipeline.maximumAhead = 0;
+    clock_gettime(CLOCK_MONOTONIC, & start);
+    cr_assert_eq(_JsonSax->parseSourceAsync(& source, 4, 16, & handler, & pipeline, NULL), 0);
+    asyncTime = elapsedMilliseconds(& start);
+    cr_assert_eq(pipeline.parsedCount, 50);
+
+    // then reading should overlap parsing, the throughput nearing that of the slower one rather than their sum
+    cr_assert_lt(asyncTime, sequentialTime * 0.75, "Reading on a thread took %.1f ms, against %.1f ms", asyncTime, sequentialTime);
+}
+
+
+Test(JsonSax, holds_a_fast_source_back) {
+    // given a source much faster than the handler
+    SlowPipeline pipeline = { 50, 0, 1, 0, 0, 0 };
+    JsonSaxSource source = { readSlowly, & pipeline };
+    JsonSaxHandler handler;
+
+    memset(& handler, 0, sizeof(handler));
+    handler.onInteger = parseSlowly;
+
+    // when reading the json-string on a reader thread
+    cr_assert_eq(_JsonSax->parseSourceAsync(& source, 4, 16, & handler, & pipeline, NULL), 0);
+
+    // then the reader should get ahead, but no further than the ring of buffers, a value being carried and another read
+    cr_assert_eq(pipeline.parsedCount, 50);
+    cr_assert_geq(pipeline.maximumAhead, 4);
+    cr_assert_leq(pipeline.maximumAhead, 4 + 2);
+}
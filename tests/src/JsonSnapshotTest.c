@@ -0,0 +1,209 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <criterion/criterion.h>
+
+#include "../../src/JsonToken.h"
+#include "../../src/Json.h"
+#include "../../src/JsonSnapshot.h"
+
+
+
+
+static JsonSnapshot * saveAndLoad(char const * const jsonString) {
+    char path[] = "/tmp/JsonSnapshotTestXXXXXX";
+    Json * json = _Json->new(jsonString);
+    JsonSnapshot * snapshot;
+
+    close(mkstemp(path));
+    cr_assert_eq(_JsonSnapshot->save(json, path), 0, "Saving a snapshot should succeed");
+    snapshot = _JsonSnapshot->load(path);
+    unlink(path);
+    _Json->delete(& json);
+
+    return snapshot;
+}
+
+
+Test(JsonSnapshot, loads_saved_json) {
+    // given a saved json
+    JsonSnapshot * snapshot = saveAndLoad("{ \"a\": [1, true, \"x\"], \"b\": { \"c\": 5 } }");
+
+    // when loading it
+
+    // then every token should be there
+    cr_assert_not_null(snapshot);
+    cr_assert_eq(
+        _JsonSnapshot->size(snapshot),
+        19,
+        "Loaded snapshot should contain every token of the json"
+    );
+}
+
+
+Test(JsonSnapshot, stores_converted_values) {
+    // given a loaded snapshot
+    JsonSnapshot * snapshot = saveAndLoad("[7, false, \"foo\"]");
+
+    // when reading its tokens
+
+    // then they should hold their values
+    cr_assert_eq(_JsonSnapshot->getType(snapshot, 1), JSON_TOKEN_INTEGER);
+    cr_assert_eq(_JsonSnapshot->asInteger(snapshot, 1), 7);
+    cr_assert_eq(_JsonSnapshot->asBoolean(snapshot, 3), 0);
+    cr_assert_eq(_JsonSnapshot->asOperator(snapshot, 6), ']');
+    cr_assert_str_eq(
+        _JsonSnapshot->asString(snapshot, 5),
+        "\"foo\"",
+        "Snapshot tokens should hold the same values as the json tokens"
+    );
+}
+
+
+Test(JsonSnapshot, skips_containers) {
+    // given a loaded snapshot
+    JsonSnapshot * snapshot = saveAndLoad("[[1, [2]], 3]");
+
+    // when skipping the nested array
+    unsigned int next = _JsonSnapshot->skip(snapshot, 1);
+
+    // then the token following it should be returned
+    cr_assert_eq(
+        next,
+        8,
+        "Skipping a container should jump past its closing operator"
+    );
+}
+
+
+Test(JsonSnapshot, finds_members) {
+    // given a loaded snapshot
+    JsonSnapshot * snapshot = saveAndLoad("{ \"a\": [1, 2], \"b\": { \"c\": 5 }, \"d\": true }");
+    unsigned int valueIndex;
+
+    // when looking for a member
+    int status = _JsonSnapshot->findMember(snapshot, 0, "d", & valueIndex);
+
+    // then its value should be found
+    cr_assert_eq(status, 0);
+    cr_assert_eq(
+        _JsonSnapshot->asBoolean(snapshot, valueIndex),
+        1,
+        "Found member should lead to its value"
+    );
+    cr_assert_eq(
+        _JsonSnapshot->findMember(snapshot, 0, "c", & valueIndex),
+        -1,
+        "Nested members shouldn't be found"
+    );
+}
+
+
+Test(JsonSnapshot, finds_members_among_many) {
+    // given a loaded snapshot of an object with many members, one of them duplicated
+    char jsonString[8192] = "{";
+    JsonSnapshot * snapshot;
+    unsigned int valueIndex;
+    char key[16];
+    unsigned int index;
+
+    for (index = 0; index < 300; index++) {
+        sprintf(jsonString + strlen(jsonString), "\"key%u\": %u, ", (index * 7919) % 300, index);
+    }
+    strcat(jsonString, "\"key5\": -1, \"key\": [{ \"key7\": 0 }] }");
+    snapshot = saveAndLoad(jsonString);
+
+    // when looking for each member
+    // then each should lead to its value, the first of duplicate keys being found
+    for (index = 0; index < 300; index++) {
+        sprintf(key, "key%u", (index * 7919) % 300);
+        cr_assert_eq(_JsonSnapshot->findMember(snapshot, 0, key, & valueIndex), 0, "'%s' should be found", key);
+        cr_assert_eq(_JsonSnapshot->asInteger(snapshot, valueIndex), index);
+    }
+    cr_assert_eq(_JsonSnapshot->findMember(snapshot, 0, "key", & valueIndex), 0);
+    cr_assert_eq(_JsonSnapshot->asOperator(snapshot, valueIndex), '[');
+    cr_assert_eq(_JsonSnapshot->findMember(snapshot, valueIndex + 1, "key7", & valueIndex), 0);
+    cr_assert_eq(_JsonSnapshot->asInteger(snapshot, valueIndex), 0);
+    cr_assert_eq(_JsonSnapshot->findMember(snapshot, 0, "key300", & valueIndex), -1);
+    cr_assert_eq(_JsonSnapshot->findMember(snapshot, 0, "ke", & valueIndex), -1);
+}
+
+
+Test(JsonSnapshot, saves_millions_of_tokens) {
+    // given an array of a million numbers, two million tokens with the commas
+    size_t count = 1000000;
+    size_t length = 2 * count + 1;
+    char * string = malloc(length + 1);
+    size_t index;
+
+    string[0] = '[';
+    for (index = 0; index < count; index++) {
+        string[2 * index + 1] = '0';
+        string[2 * index + 2] = ',';
+    }
+    string[length - 1] = ']';
+    string[length] = '\0';
+
+    // when saving and loading it
+    JsonSnapshot * snapshot = saveAndLoad(string);
+    free(string);
+
+    // then every token should be there
+    cr_assert_not_null(snapshot);
+    cr_assert_eq(_JsonSnapshot->size(snapshot), length);
+    cr_assert_eq(_JsonSnapshot->skip(snapshot, 0), length);
+    _JsonSnapshot->delete(& snapshot);
+}
+
+
+Test(JsonSnapshot, reads_nothing_out_of_a_corrupted_file) {
+    // given a snapshot file whose records point out of the file
+    char path[] = "/tmp/JsonSnapshotTestXXXXXX";
+    Json * json = _Json->new("{ \"a\": [1, 2] }");
+    JsonSnapshot * snapshot;
+    unsigned int values[16];
+    unsigned int valueIndex;
+    FILE * file;
+
+    close(mkstemp(path));
+    cr_assert_eq(_JsonSnapshot->save(json, path), 0);
+    _Json->delete(& json);
+    file = fopen(path, "r+b");
+    memset(values, 0xFF, sizeof(values));
+    fseek(file, 8 * sizeof(unsigned int), SEEK_SET);
+    cr_assert_eq(fwrite(values, sizeof(values), 1, file), 1);
+    fclose(file);
+
+    // when reading its tokens
+    snapshot = _JsonSnapshot->load(path);
+    unlink(path);
+
+    // then every read should stay within the file
+    cr_assert_not_null(snapshot);
+    cr_assert_null(_JsonSnapshot->getRawString(snapshot, 0));
+    cr_assert_null(_JsonSnapshot->asString(snapshot, 1));
+    cr_assert_eq(_JsonSnapshot->skip(snapshot, 0), _JsonSnapshot->size(snapshot));
+    cr_assert_eq(_JsonSnapshot->findMember(snapshot, 0, "a", & valueIndex), -1);
+    cr_assert_null(_JsonSnapshot->getRawString(snapshot, 1000));
+    cr_assert_eq(_JsonSnapshot->getType(snapshot, 1000), (JsonTokenType) -1);
+}
+
+
+Test(JsonSnapshot, rejects_invalid_files) {
+    // given a file which isn't a snapshot
+    char path[] = "/tmp/JsonSnapshotTestXXXXXX";
+    int file = mkstemp(path);
+    cr_assert_eq(write(file, "{ \"not\": \"a snapshot\" }", 23), 23);
+    close(file);
+
+    // when loading it
+    JsonSnapshot * snapshot = _JsonSnapshot->load(path);
+    unlink(path);
+
+    // then no instance should be returned
+    cr_assert_null(
+        snapshot,
+        "Loading a file which isn't a snapshot should fail"
+    );
+}
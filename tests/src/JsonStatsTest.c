@@ -0,0 +1,119 @@
+#include <criterion/criterion.h>
+
+#include "../../src/JsonToken.h"
+#include "../../src/Json.h"
+#include "../../src/JsonStats.h"
+
+
+
+
+Test(JsonStats, records_into_current_stats) {
+    // given stats being recorded
+    JsonStats stats;
+    _JsonStats->begin(& stats);
+
+    // when counting an allocation
+    _JsonStats->countAllocation(42);
+    _JsonStats->end();
+
+    // then the stats should contain it
+    cr_assert_eq(
+        stats.allocatedBytes,
+        42,
+        "Allocated bytes should be recorded into the current stats"
+    );
+}
+
+
+Test(JsonStats, aggregates_process_wide) {
+    // given two recorded parses
+    JsonStats first;
+    JsonStats second;
+    _JsonStats->resetGlobal();
+    _JsonStats->begin(& first);
+    _JsonStats->countAllocation(10);
+    _JsonStats->end();
+    _JsonStats->begin(& second);
+    _JsonStats->countAllocation(32);
+    _JsonStats->end();
+
+    // when reading the process-wide stats
+    JsonStats const * global = _JsonStats->getGlobal();
+
+    // then they should sum both parses
+    cr_assert_eq(
+        global->allocatedBytes,
+        42,
+        "Process-wide stats should sum the recorded parses"
+    );
+    cr_assert_eq(
+        global->parses,
+        2,
+        "Process-wide stats should count the recorded parses"
+    );
+}
+
+
+Test(JsonStats, counts_tokens_by_type) {
+    // given stats being recorded
+    JsonStats stats;
+    JsonToken * token = _JsonToken->new("42");
+    _JsonStats->begin(& stats);
+
+    // when counting an integer token
+    _JsonStats->countToken(token);
+    _JsonStats->end();
+
+    // then it should be counted as an integer
+    cr_assert_eq(
+        stats.tokensByType[JSON_TOKEN_INTEGER],
+        1,
+        "Tokens should be counted by type"
+    );
+}
+
+
+Test(JsonStats, tracks_maximum_depth) {
+    // given stats being recorded
+    JsonStats stats;
+    char * operators[] = { "{", "[", "]", "[", "[", "]", "]", "}" };
+    unsigned int operatorIndex;
+    _JsonStats->begin(& stats);
+
+    // when counting nested operators
+    for (operatorIndex = 0; operatorIndex < 8; operatorIndex++) {
+        _JsonStats->countToken(_JsonToken->new(operators[operatorIndex]));
+    }
+    _JsonStats->end();
+
+    // then the deepest nesting should be kept
+    cr_assert_eq(
+        stats.maximumDepth,
+        3,
+        "Maximum depth should be the deepest nesting encountered"
+    );
+}
+
+
+#ifdef JSON_INSTRUMENTATION
+Test(JsonStats, records_each_json_parse) {
+    // given no parse recorded yet
+    Json * rejected;
+    Json * json;
+    _JsonStats->resetGlobal();
+
+    // when parsing a rejected json, then a valid one
+    rejected = _Json->new("{\"a\":");
+    json = _Json->new("{\"a\": 1}");
+
+    // then both should be recorded, the valid one keeping its stats, its own block included
+    cr_assert_null(rejected);
+    cr_assert_not_null(json);
+    cr_assert_eq(_JsonStats->getGlobal()->parses, 2);
+    cr_assert_eq(_Json->getStats(json)->parses, 1);
+    cr_assert_geq(_Json->getStats(json)->allocatedBytes, sizeof(void *) + sizeof("{\"a\": 1}"));
+    cr_assert_eq(_Json->getStats(json)->tokensByType[JSON_TOKEN_INTEGER], 1);
+
+    _Json->delete(& json);
+}
+#endif
@@ -1,4 +1,7 @@
-
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
 #include <criterion/criterion.h>
 
 #include "../../src/LinkedList.h"
@@ -100,7 +103,135 @@ Test(Json, parses_correct_tokens) {
 }
 
 
-#error Checkpoint
+static unsigned int liveBlocks = 0;
+
+static void * countingAllocate(void * context, size_t size) {
+    * (unsigned int *) context += size;
+    liveBlocks++;
+    return malloc(size);
+}
+
+static void * countingReallocate(void * context, void * block, size_t oldSize, size_t newSize) {
+    * (unsigned int *) context += newSize - oldSize;
+    return realloc(block, newSize);
+}
+
+static void countingDeallocate(void * context, void * block) {
+    (void) context;
+    liveBlocks--;
+    free(block);
+}
+
+
+Test(Json, allocates_with_given_allocator) {
+    // given a custom allocator
+    unsigned int allocatedBytes = 0;
+    Allocator allocator = {
+        countingAllocate,
+        countingReallocate,
+        countingDeallocate,
+        & allocatedBytes
+    };
+
+    // when parsing a json with it
+    Json * json = _Json->newWithAllocator("{ \"foo\": true }", & allocator);
+
+    // then the json and its tokens should have been allocated with it
+    cr_assert_not_null(json);
+    cr_assert_gt(
+        allocatedBytes,
+        sizeof(LinkedList *) * 5,
+        "Json and tokens should be allocated with the given allocator"
+    );
+
+    // and released with it too
+    _Json->delete(& json);
+    cr_assert_eq(
+        liveBlocks,
+        0,
+        "Deleting a json should release everything with its allocator"
+    );
+}
+
+
+Test(Json, charges_its_own_allocator_only) {
+    // given a document allocator, and another one set as the current allocator
+    unsigned int documentBytes = 0;
+    unsigned int currentBytes = 0;
+    Allocator documentAllocator = { countingAllocate, countingReallocate, countingDeallocate, & documentBytes };
+    Allocator currentAllocator = { countingAllocate, countingReallocate, countingDeallocate, & currentBytes };
+    Allocator const * previousAllocator = Class->useAllocator(& currentAllocator);
+
+    // when parsing, editing and deleting a json with long strings
+    Json * json = _Json->newWithAllocator("{ \"key longer than the inline buffer of tokens\": [1, 2] }", & documentAllocator);
+    cr_assert_not_null(json);
+    cr_assert_eq(_Json->edit(json, 50, 1, "\"value longer than the inline buffer of tokens\"", NULL), 0);
+    _Json->delete(& json);
+    Class->useAllocator(previousAllocator);
+
+    // then every byte should have gone through the document allocator
+    cr_assert_gt(documentBytes, 0);
+    cr_assert_eq(currentBytes, 0, "Documents shouldn't allocate with the current allocator");
+    cr_assert_eq(liveBlocks, 0, "Documents should release everything with their allocator");
+}
+
+
+Test(Json, deletes_once_every_reference_is_released) {
+    // given a json shared by two owners
+    unsigned int allocatedBytes = 0;
+    Allocator allocator = {
+        countingAllocate,
+        countingReallocate,
+        countingDeallocate,
+        & allocatedBytes
+    };
+    Json * json = _Json->newWithAllocator("{ \"foo\": true }", & allocator);
+    Json * sharedJson = _Json->retain(json);
+
+    // when the first owner releases it
+    _Json->delete(& json);
+
+    // then it should still be usable by the other one
+    cr_assert_null(json);
+    cr_assert_str_eq(
+        _Json->toString(sharedJson),
+        "{ \"foo\": true }",
+        "Json should stay valid while referenced"
+    );
+
+    // and be deleted when the last owner releases it
+    _Json->delete(& sharedJson);
+    cr_assert_eq(
+        liveBlocks,
+        0,
+        "Json should be deleted once every reference is released"
+    );
+}
+
+
+Test(Json, extracts_projected_tokens_only) {
+    // given a json object
+    char * jsonString = "{ \"id\": 42, \"name\": \"foo\" }";
+    char const * paths[] = { "/name" };
+
+    // when parsing it with a projection
+    Json * json = _Json->newWithProjection(jsonString, paths, 1);
+
+    // then only the projected tokens should be extracted
+    cr_assert_not_null(json);
+    cr_assert_eq(
+        _LinkedList->size(_Json->getTokens(json)),
+        5,
+        "Only the projected member and the root should have tokens"
+    );
+    cr_assert_str_eq(
+        _Json->toString(json),
+        jsonString,
+        "Projected json should still store the whole json-string"
+    );
+}
+
+
 Test(Json, rejects_invalid_syntax, .timeout=1) {
     // given some jsons with invalid syntax
     char * jsonStrings[] = {
@@ -125,3 +256,316 @@ Test(Json, rejects_invalid_syntax, .timeout=1) {
         );
     }
 }
+
+
+Test(Json, reports_syntax_error_offset) {
+    // given a json missing a comma, and options to get the error back
+    char * jsonString = "[1, 2 3]";
+    JsonError error;
+    JsonOptions options;
+
+    memset(& options, 0, sizeof(options));
+    options.error = & error;
+
+    // when creating an object from it
+    Json * json = _Json->newWithOptions(jsonString, & options);
+
+    // then the unexpected token should be reported
+    cr_assert_null(json);
+    cr_assert_eq(error.code, JSON_ERROR_UNEXPECTED_TOKEN);
+    cr_assert_eq(
+        error.offset,
+        6,
+        "Error should be reported at the offset of the unexpected token"
+    );
+}
+
+
+Test(Json, indexes_matching_brackets) {
+    // given a json with nested containers
+    Json * json = _Json->new("{ \"a\": [1, {}], \"b\": 2 }");
+
+    // when getting the matching brackets
+    cr_assert_not_null(json);
+    cr_assert_eq(_Json->getTokensCount(json), 14);
+
+    // then openers and closers should point at each other, and other tokens at themselves
+    cr_assert_eq(_Json->getMatchingIndex(json, 0), 13);
+    cr_assert_eq(_Json->getMatchingIndex(json, 13), 0);
+    cr_assert_eq(
+        _Json->getMatchingIndex(json, 3),
+        8,
+        "Array start should match its end"
+    );
+    cr_assert_eq(_Json->getMatchingIndex(json, 6), 7);
+    cr_assert_eq(_Json->getMatchingIndex(json, 4), 4);
+    cr_assert_eq(_Json->getMatchingIndex(json, 14), -1);
+}
+
+
+Test(Json, gets_tokens_by_index) {
+    // given a json
+    Json * json = _Json->new("{ \"a\": [1, {}], \"b\": 2 }");
+
+    // when getting tokens by index
+    // then they should be the tokens of the list at this index
+    cr_assert_str_eq(_JsonToken->getRawString(_Json->getToken(json, 1)), "\"a\"");
+    cr_assert_eq(_JsonToken->asInteger(_Json->getToken(json, 12)), 2);
+    cr_assert_eq(_Json->getToken(json, 0), _LinkedList->getContent(_Json->getTokens(json)));
+    cr_assert_null(_Json->getToken(json, 14));
+}
+
+
+Test(Json, converts_numbers_in_bulk) {
+    // given a json full of integers and floats, parsed with lazy numbers
+    char jsonString[8192] = "[";
+    JsonOptions options;
+    JsonNumber numbers[200];
+    unsigned int index;
+    Json * json;
+
+    for (index = 0; index < 150; index++) {
+        sprintf(jsonString + strlen(jsonString), "%s{\"x\": %u, \"y\": -%u.25}", (index > 0) ? "," : "", index, index);
+    }
+    strcat(jsonString, ",9007199254740993]");
+    memset(& options, 0, sizeof(options));
+    options.lazyNumbers = 1;
+    json = _Json->newWithOptions(jsonString, & options);
+
+    // when converting its numbers
+    // then every number should be found with its type in document order, up to the capacity
+    cr_assert_eq(_Json->getNumbers(json, numbers, 200), 301);
+    for (index = 0; index < 100; index++) {
+        cr_assert_eq(numbers[2 * index].type, JSON_TOKEN_INTEGER);
+        cr_assert_eq(numbers[2 * index].value.asInteger, index);
+        cr_assert_eq(numbers[2 * index + 1].type, JSON_TOKEN_FLOAT);
+        cr_assert_float_eq(numbers[2 * index + 1].value.asFloat, - (double) index - 0.25, 1e-9);
+    }
+
+    // and the tokens should hold their values, integers beyond float precision included
+    cr_assert(_Json->getToken(json, 1501)->isConverted);
+    cr_assert_eq(JSON_TOKEN_AS_INTEGER(_Json->getToken(json, 1501)), 9007199254740993L);
+    cr_assert(_Json->getToken(json, 1498)->isConverted);
+    cr_assert_float_eq(JSON_TOKEN_AS_FLOAT(_Json->getToken(json, 1498)), -149.25, 1e-9);
+
+    _Json->delete(& json);
+}
+
+
+Test(Json, freezes_jsons_for_shared_reads) {
+    // given a json parsed with lazy numbers
+    JsonOptions options;
+    Json * json;
+    Json * shared;
+
+    memset(& options, 0, sizeof(options));
+    options.lazyNumbers = 1;
+    json = _Json->newWithOptions("{ \"a\": [1, 2.5] }", & options);
+
+    // when freezing it
+    _Json->freeze(json);
+    shared = _Json->retain(json);
+
+    // then its numbers should be read as before, and edits should be refused
+    cr_assert_eq(_JsonToken->asInteger(_Json->getToken(json, 4)), 1);
+    cr_assert_float_eq(_JsonToken->asFloat(_Json->getToken(json, 6)), 2.5, 1e-9);
+    _Json->delete(& shared);
+    cr_assert_eq(_Json->edit(json, 7, 1, "3", NULL), -1);
+    cr_assert_str_eq(_Json->toString(json), "{ \"a\": [1, 2.5] }");
+
+    _Json->delete(& json);
+}
+
+
+static void * readSharedJson(void * reference) {
+    Json * json = reference;
+    Json * copy;
+    long sum = 0;
+    unsigned int round;
+    unsigned int index;
+
+    for (round = 0; round < 1000; round++) {
+        copy = _Json->retain(json);
+        for (index = 0; index < _Json->getTokensCount(copy); index++) {
+            if (_JsonToken->getType(_Json->getToken(copy, index)) == JSON_TOKEN_INTEGER) {
+                sum += _JsonToken->asInteger(_Json->getToken(copy, index));
+            }
+        }
+        _Json->delete(& copy);
+    }
+
+    _Json->delete(& json);
+
+    return (void *) sum;
+}
+
+
+Test(Json, shares_frozen_jsons_between_threads) {
+    // given a frozen json with lazy numbers, and a reference per thread
+    unsigned int allocatedBytes = 0;
+    Allocator allocator = { countingAllocate, countingReallocate, countingDeallocate, & allocatedBytes };
+    JsonOptions options;
+    Json * json;
+    pthread_t threads[8];
+    void * sums[8];
+    unsigned int thread;
+
+    memset(& options, 0, sizeof(options));
+    options.allocator = & allocator;
+    options.lazyNumbers = 1;
+    json = _Json->newWithOptions("{ \"a\": [1, 2, 3], \"b\": { \"c\": 4 } }", & options);
+    cr_assert_not_null(json);
+    _Json->freeze(json);
+
+    // when threads read it, retaining and releasing references, and the last one deletes it
+    for (thread = 0; thread < 8; thread++) {
+        cr_assert_eq(pthread_create(& threads[thread], NULL, readSharedJson, _Json->retain(json)), 0);
+    }
+    _Json->delete(& json);
+    for (thread = 0; thread < 8; thread++) {
+        pthread_join(threads[thread], & sums[thread]);
+    }
+
+    // then every thread should read the same values, and the json be released with its allocator
+    for (thread = 0; thread < 8; thread++) {
+        cr_assert_eq((long) sums[thread], 10 * 1000);
+    }
+    cr_assert_eq(liveBlocks, 0, "The last reference should release the json, whichever thread holds it");
+}
+
+
+Test(Json, edits_a_range_of_the_json_string) {
+    // given a json
+    Json * json = _Json->new("{ \"a\": 1, \"b\": [2] }");
+    LinkedList * tokens;
+    unsigned int tokenIndex;
+    char * expectedTokens[] = {
+        "{", "\"a\"", ":", "\"foo\"", ",", "\"c\"", ":", "3", ",", "\"b\"", ":", "[", "2", "]", "}"
+    };
+
+    // when replacing a value by a value and a new member
+    int status = _Json->edit(json, 7, 1, "\"foo\", \"c\": 3", NULL);
+
+    // then the tokens should be the ones of the edited json-string
+    cr_assert_eq(status, 0);
+    cr_assert_str_eq(_Json->toString(json), "{ \"a\": \"foo\", \"c\": 3, \"b\": [2] }");
+    cr_assert_eq(_Json->getTokensCount(json), 15);
+    tokens = _Json->getTokens(json);
+    for (tokenIndex = 0; tokenIndex < 15; tokenIndex++) {
+        cr_assert_str_eq(
+            _JsonToken->getRawString(_LinkedList->getContent(tokens)),
+            expectedTokens[tokenIndex],
+            "Expected to find the token '%s'", expectedTokens[tokenIndex]
+        );
+        tokens = _LinkedList->nextElement(tokens);
+    }
+
+    // and brackets after the edit should still match
+    cr_assert_eq(_Json->getMatchingIndex(json, 11), 13);
+}
+
+
+Test(Json, keeps_json_untouched_on_invalid_edit) {
+    // given a json
+    char * jsonString = "[1, 2]";
+    Json * json = _Json->new(jsonString);
+    JsonError error;
+
+    // when removing a comma
+    int status = _Json->edit(json, 2, 1, "", & error);
+
+    // then the edit should be rejected, and the json kept as is
+    cr_assert_eq(status, -1);
+    cr_assert_eq(error.code, JSON_ERROR_UNEXPECTED_TOKEN);
+    cr_assert_str_eq(
+        _Json->toString(json),
+        jsonString,
+        "Rejected edit should leave the json-string untouched"
+    );
+    cr_assert_eq(_Json->getTokensCount(json), 5);
+}
+
+
+Test(Json, edits_like_a_fresh_parse) {
+    // given a json, and random edits of it, many of them invalid
+    char const * const insertions[] = {
+        "", " ", "7", "-2.5", ", 1", ",", "[", "]", "{", "}", "\"", "\"x\"", "[1, [2]]", "{\"a\": {\"b\": 2}}", ", \"c\": 3", ":", "true", "tr"
+    };
+    char expected[4096];
+    char previous[4096];
+    Json * json = _Json->new("{ \"a\": [1, 2, { \"b\": [3, \"x\"] }], \"c\": { \"d\": null }, \"e\": [[], {}] }");
+    Json * parsed;
+    unsigned int round;
+    unsigned int index;
+    unsigned int offset;
+    unsigned int removedLength;
+    char const * inserted;
+    int status;
+
+    srand(7);
+    for (round = 0; round < 3000; round++) {
+        strcpy(previous, _Json->toString(json));
+        offset = rand() % (strlen(previous) + 1);
+        removedLength = rand() % 4;
+        removedLength = (removedLength > strlen(previous) - offset) ? strlen(previous) - offset : removedLength;
+        inserted = insertions[rand() % (sizeof(insertions) / sizeof(insertions[0]))];
+        if (strlen(previous) + strlen(inserted) >= sizeof(expected)) {
+            break;
+        }
+        memcpy(expected, previous, offset);
+        strcpy(expected + offset, inserted);
+        strcat(expected, previous + offset + removedLength);
+
+        // when applying each of them
+        status = _Json->edit(json, offset, removedLength, inserted, NULL);
+
+        // then valid edits should lead to the tokens and matches of a fresh parse, invalid ones change nothing
+        parsed = _Json->new(expected);
+        if (parsed == NULL) {
+            cr_assert_eq(status, -1, "Editing '%s' into '%s' should be rejected", previous, expected);
+            cr_assert_str_eq(_Json->toString(json), previous);
+            continue;
+        }
+
+        cr_assert_eq(status, 0, "Editing '%s' into '%s' should be accepted", previous, expected);
+        cr_assert_str_eq(_Json->toString(json), expected);
+        cr_assert_eq(_Json->getTokensCount(json), _Json->getTokensCount(parsed), "'%s' should have the tokens of a fresh parse", expected);
+        for (index = 0; index < _Json->getTokensCount(parsed); index++) {
+            cr_assert_str_eq(_JsonToken->getRawString(_Json->getToken(json, index)), _JsonToken->getRawString(_Json->getToken(parsed, index)));
+            cr_assert_eq(_Json->getMatchingIndex(json, index), _Json->getMatchingIndex(parsed, index), "'%s' token %u should match as in a fresh parse", expected, index);
+        }
+        cr_assert_eq(_LinkedList->size(_Json->getTokens(json)), _Json->getTokensCount(parsed));
+        _Json->delete(& parsed);
+    }
+
+    _Json->delete(& json);
+}
+
+
+Test(Json, edits_away_millions_of_tokens) {
+    // given an array of a million numbers, two million tokens with the commas
+    size_t count = 1000000;
+    size_t length = 2 * count + 1;
+    char * string = malloc(length + 1);
+    Json * json;
+    size_t index;
+
+    string[0] = '[';
+    for (index = 0; index < count; index++) {
+        string[2 * index + 1] = '0';
+        string[2 * index + 2] = ',';
+    }
+    string[length - 1] = ']';
+    string[length] = '\0';
+    json = _Json->new(string);
+    cr_assert_not_null(json);
+
+    // when replacing its whole content
+    // then the removed tokens should be freed without running out of stack
+    cr_assert_eq(_Json->edit(json, 1, length - 2, "7", NULL), 0);
+    cr_assert_str_eq(_Json->toString(json), "[7]");
+    cr_assert_eq(_LinkedList->size(_Json->getTokens(json)), 3);
+
+    _Json->delete(& json);
+    free(string);
+}
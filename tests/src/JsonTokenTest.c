@@ -1,4 +1,6 @@
-
+#include <string.h>
+#include <limits.h>
+#include <math.h>
 #include <criterion/criterion.h>
 
 #include "../../src/JsonToken.h"
@@ -411,3 +413,249 @@ Test(JsonToken, stores_raw_string) {
         "Created token should store the raw string [%s]", rawString
     );
 }
+
+
+Test(JsonToken, accepts_exponent_float) {
+    // given a string with a litteral float in exponent notation
+    char * number = "-4.2e+1";
+
+    // when creating a token from it
+    JsonToken * token = _JsonToken->new(number);
+
+    // then it should be a float holding the value
+    cr_assert_not_null(token);
+    cr_assert_eq(
+        _JsonToken->getType(token),
+        JSON_TOKEN_FLOAT,
+        "Created instance should have the type float"
+    );
+    cr_assert_eq(
+        _JsonToken->asFloat(token),
+        -42.0,
+        "Created instance should contain the litteral float value %s", number
+    );
+}
+
+
+Test(JsonToken, rejects_lone_sign) {
+    // given a string with a sign only
+    char * sign = "-";
+
+    // when creating a token from it
+    JsonToken * token = _JsonToken->new(sign);
+
+    // then no instance should be returned
+    cr_assert_null(
+        token,
+        "Constructor should reject a sign without digits"
+    );
+}
+
+
+Test(JsonToken, accepts_escaped_backslash_before_closing_quote) {
+    // given a string ending with an escaped backslash
+    char * escapedString = "\"42\\\\\"";
+
+    // when creating a token with it
+    JsonToken * token = _JsonToken->new(escapedString);
+
+    // then a valid instance should be returned
+    cr_assert_not_null(
+        token,
+        "Token should be created when the closing quote follows an escaped backslash"
+    );
+}
+
+
+Test(JsonToken, builds_from_length_bounded_string) {
+    // given a token-string followed by other characters
+    char * buffer = "42,true]";
+
+    // when creating a token from its first characters only
+    JsonToken * token = _JsonToken->newWithLength(buffer, 2);
+
+    // then the token should hold these characters only
+    cr_assert_not_null(token);
+    cr_assert_str_eq(
+        _JsonToken->getRawString(token),
+        "42",
+        "Created instance should only hold the given length of the string"
+    );
+    cr_assert_eq(
+        _JsonToken->asInteger(token),
+        42,
+        "Created instance should contain the litteral integer value"
+    );
+}
+
+
+Test(JsonToken, scans_longest_token) {
+    // given a string starting with a token followed by other characters
+    char * buffer = "\"a,b\",42";
+    size_t length;
+
+    // when scanning it
+    JsonTokenType type = _JsonToken->scan(buffer, 8, & length);
+
+    // then the whole first token should be found
+    cr_assert_eq(type, JSON_TOKEN_STRING);
+    cr_assert_eq(
+        length,
+        5,
+        "Scanning should find the longest token at the start of the string"
+    );
+}
+
+
+Test(JsonToken, converts_lazy_numbers_on_first_access) {
+    // given lazy number conversion
+    int previousLazyNumbers = _JsonToken->useLazyNumbers(1);
+
+    // when creating number tokens, one out of the integer range
+    JsonToken * token = _JsonToken->new("123456789012345678901234567890");
+    JsonToken * floatToken = _JsonToken->new("-2.5e1");
+    _JsonToken->useLazyNumbers(previousLazyNumbers);
+
+    // then its raw representation should be kept as is
+    cr_assert_not_null(token);
+    cr_assert_str_eq(
+        _JsonToken->getRawNumber(token),
+        "123456789012345678901234567890",
+        "Raw number should be the unconverted token-string"
+    );
+
+    // and values should still be converted on access
+    cr_assert_float_eq(
+        _JsonToken->asFloat(floatToken),
+        -25.0,
+        0.0001,
+        "Lazy number should be converted on first access"
+    );
+}
+
+
+Test(JsonToken, saturates_out_of_range_numbers) {
+    // given numbers out of the range of the native types
+    JsonToken * big = _JsonToken->new("123456789012345678901234567890");
+    JsonToken * small = _JsonToken->new("-123456789012345678901234567890");
+    JsonToken * huge = _JsonToken->new("-1e999");
+
+    // when converting them
+    // then they should saturate, their exact digits being kept
+    cr_assert_eq(_JsonToken->asInteger(big), LONG_MAX);
+    cr_assert_eq(_JsonToken->asInteger(small), LONG_MIN);
+    cr_assert(_JsonToken->asFloat(huge) == - HUGE_VAL);
+    cr_assert_str_eq(_JsonToken->getRawNumber(big), "123456789012345678901234567890");
+
+    _JsonToken->delete(& big);
+    _JsonToken->delete(& small);
+    _JsonToken->delete(& huge);
+}
+
+
+Test(JsonToken, has_no_raw_number_for_other_types) {
+    // given a string token
+    JsonToken * token = _JsonToken->new("\"42\"");
+
+    // when getting its raw number
+    char const * rawNumber = _JsonToken->getRawNumber(token);
+
+    // then none should be returned
+    cr_assert_null(
+        rawNumber,
+        "Only integer and float tokens should have a raw number"
+    );
+}
+
+
+Test(JsonToken, parses_null) {
+    // given a json litteral null
+    char * nullString = "null";
+
+    // when creating a token with it
+    JsonToken * token = _JsonToken->new(nullString);
+
+    // then it should be a null token
+    cr_assert_not_null(token);
+    cr_assert_eq(
+        _JsonToken->getType(token),
+        JSON_TOKEN_NULL,
+        "Created instance should be of type null"
+    );
+}
+
+
+Test(JsonToken, stores_short_and_long_strings) {
+    // given a short and a long token-string, read from a pool
+    char longString[128];
+    Pool * pool = _JsonToken->newPool(Class->getAllocator());
+    JsonToken * shortToken;
+    JsonToken * longToken;
+
+    memset(longString, 'a', sizeof(longString) - 1);
+    longString[0] = '"';
+    longString[sizeof(longString) - 2] = '"';
+    longString[sizeof(longString) - 1] = '\0';
+
+    // when creating tokens from them
+    shortToken = _JsonToken->newInPool(pool, "\"key\"", 5, 0);
+    longToken = _JsonToken->newInPool(pool, longString, strlen(longString), 0);
+
+    // then both should keep their raw string until deleted
+    cr_assert_str_eq(_JsonToken->asString(shortToken), "\"key\"");
+    cr_assert_str_eq(_JsonToken->asString(longToken), longString);
+
+    _JsonToken->deleteInPool(pool, & shortToken);
+    _JsonToken->deleteInPool(pool, & longToken);
+    cr_assert_null(shortToken);
+    _Pool->delete(& pool);
+}
+
+
+Test(JsonToken, pools_tokens_on_cache_lines) {
+    // given a token pool
+    Pool * pool = _JsonToken->newPool(Class->getAllocator());
+    JsonToken * token = NULL;
+    unsigned int index;
+
+    // when taking tokens from several of its slabs
+    for (index = 0; index < 100; index++) {
+        token = _JsonToken->newInPool(pool, "42", 2, 0);
+
+        // then each of them should start on a cache line, never straddling two
+        cr_assert_eq((size_t) token % 64, 0);
+        cr_assert_leq(sizeof(JsonToken), 64);
+    }
+
+    _Pool->delete(& pool);
+}
+
+
+Test(JsonToken, accessor_macros_match_the_methods) {
+    // given tokens of every type, numbers being converted lazily
+    int previousLazyNumbers = _JsonToken->useLazyNumbers(1);
+    JsonToken * integer = _JsonToken->new("-42");
+    JsonToken * floating = _JsonToken->new("2.5");
+    JsonToken * boolean = _JsonToken->new("true");
+    JsonToken * operator = _JsonToken->new("[");
+    JsonToken * string = _JsonToken->new("\"a\"");
+
+    _JsonToken->useLazyNumbers(previousLazyNumbers);
+
+    // when reading them through the accessor macros
+    // then they should give what the methods give
+    cr_assert_eq(JSON_TOKEN_AS_INTEGER(integer), -42);
+    cr_assert_eq(JSON_TOKEN_AS_INTEGER(integer), _JsonToken->asInteger(integer));
+    cr_assert_float_eq(JSON_TOKEN_AS_FLOAT(floating), 2.5, 1e-9);
+    cr_assert_eq(JSON_TOKEN_GET_TYPE(floating), JSON_TOKEN_FLOAT);
+    cr_assert_eq(JSON_TOKEN_AS_BOOLEAN(boolean), 1);
+    cr_assert_eq(JSON_TOKEN_AS_OPERATOR(operator), '[');
+    cr_assert_str_eq(JSON_TOKEN_AS_STRING(string), "\"a\"");
+    cr_assert_eq(JSON_TOKEN_GET_RAW_STRING(string), _JsonToken->getRawString(string));
+
+    _JsonToken->delete(& integer);
+    _JsonToken->delete(& floating);
+    _JsonToken->delete(& boolean);
+    _JsonToken->delete(& operator);
+    _JsonToken->delete(& string);
+}
@@ -139,3 +139,61 @@ Test(LinkedList, computes_the_size_list)
         "Size should be 2 for a list of two elements"
     );
 }
+
+
+Test(LinkedList, takes_elements_from_pool)
+{
+    // given a pool for list elements
+    Pool * pool = _LinkedList->newPool(Class->getAllocator());
+
+    // when creating two elements
+    LinkedList * firstElement = _LinkedList->newInPool(pool, "first");
+    LinkedList * secondElement = _LinkedList->newInPool(pool, "second");
+
+    // then they should be next to each other
+    cr_assert_eq(
+        (char *) secondElement - (char *) firstElement,
+        sizeof(void *) * 2,
+        "Elements should be taken next to each other from the pool"
+    );
+}
+
+
+Test(LinkedList, detaches_following_elements)
+{
+    // given a list of three elements
+    LinkedList * firstElement = _LinkedList->new("first");
+    LinkedList * secondElement = _LinkedList->new("second");
+    _LinkedList->append(& firstElement, secondElement);
+    _LinkedList->append(& firstElement, _LinkedList->new("third"));
+
+    // when detaching the elements following the first one
+    LinkedList * detached = _LinkedList->detachNext(firstElement);
+
+    // then the list should end at the first element, and the others be returned
+    cr_assert_eq(_LinkedList->size(firstElement), 1);
+    cr_assert_eq(
+        detached,
+        secondElement,
+        "Detached elements should start right after the given one"
+    );
+    cr_assert_eq(_LinkedList->size(detached), 2);
+}
+
+
+Test(LinkedList, accessor_macros_match_the_methods) {
+    // given a list of two elements
+    int first = 1;
+    int second = 2;
+    LinkedList * list = _LinkedList->new(& first);
+    LinkedList * last = _LinkedList->new(& second);
+
+    _LinkedList->append(& list, last);
+
+    // when reading it through the accessor macros
+    // then they should give what the methods give
+    cr_assert_eq(LINKED_LIST_CONTENT(list), _LinkedList->getContent(list));
+    cr_assert_eq(LINKED_LIST_NEXT(list), _LinkedList->nextElement(list));
+    cr_assert_eq(LINKED_LIST_CONTENT(LINKED_LIST_NEXT(list)), & second);
+    cr_assert_null(LINKED_LIST_NEXT(last));
+}
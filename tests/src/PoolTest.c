@@ -0,0 +1,121 @@
+#include <criterion/criterion.h>
+
+#include "../../src/Pool.h"
+
+
+
+
+Test(Pool, instanciation_allocates_memory) {
+    // given
+
+    // when creating a new instance
+    Pool * instance = _Pool->new(24);
+
+    // then an usable memory block should be returned
+    cr_assert_not_null(
+        instance,
+        "Creating a new instance should return a valid memory block"
+    );
+}
+
+
+Test(Pool, destruction_frees_memory) {
+    // given an instance with some blocks taken
+    Pool * instance = _Pool->new(24);
+    _Pool->take(instance);
+
+    // when destroying it
+    _Pool->delete(& instance);
+
+    // then the memory block should have been freed and set to NULL
+    cr_assert_null(
+        instance,
+        "Destroying the instance should free the memory and set the pointer to NULL"
+    );
+}
+
+
+Test(Pool, takes_contiguous_blocks) {
+    // given a pool
+    Pool * pool = _Pool->new(24);
+
+    // when taking two blocks
+    char * first = _Pool->take(pool);
+    char * second = _Pool->take(pool);
+
+    // then they should be next to each other
+    cr_assert_eq(
+        second - first,
+        24,
+        "Blocks should be carved next to each other from a slab"
+    );
+}
+
+
+Test(Pool, takes_zeroed_blocks) {
+    // given a block given back after use
+    Pool * pool = _Pool->new(24);
+    char * block = _Pool->take(pool);
+    memset(block, 42, 24);
+    _Pool->give(pool, block);
+
+    // when taking it again
+    char * reused = _Pool->take(pool);
+
+    // then it should be the same, zeroed
+    cr_assert_eq(
+        reused,
+        block,
+        "Given back blocks should be taken again first"
+    );
+    cr_assert_eq(
+        reused[23],
+        0,
+        "Taken blocks should be zeroed"
+    );
+}
+
+
+Test(Pool, grows_beyond_first_slab) {
+    // given a pool
+    Pool * pool = _Pool->new(8);
+    unsigned int blockIndex;
+    char * block = NULL;
+
+    // when taking more blocks than a slab holds
+    for (blockIndex = 0; blockIndex < 1000; blockIndex++) {
+        block = _Pool->take(pool);
+        block[7] = 1;
+    }
+
+    // then blocks should still be handed out
+    cr_assert_not_null(
+        block,
+        "Pool should allocate new slabs when running out of blocks"
+    );
+}
+
+
+Test(Pool, aligns_blocks) {
+    // given a pool of blocks aligned on 64 bytes
+    Pool * pool = _Pool->newWithAlignment(40, 64, NULL);
+    unsigned int blockIndex;
+    char * previous = NULL;
+    char * block;
+
+    // when taking blocks from several slabs
+    for (blockIndex = 0; blockIndex < 100; blockIndex++) {
+        block = _Pool->take(pool);
+
+        // then each of them should start on the boundary, blocks of a slab following each other
+        cr_assert_not_null(block);
+        cr_assert_eq((size_t) block % 64, 0);
+        if ((blockIndex > 0) && (blockIndex != 16) && (blockIndex != 48)) {
+            cr_assert_eq(block - previous, 64);
+        }
+        memset(block, 1, 64);
+        previous = block;
+    }
+
+    _Pool->delete(& pool);
+}
@@ -0,0 +1,299 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "../../src/Class.h"
+#include "../../src/JsonKeys.h"
+
+
+
+
+/**
+ * Longest key which can be read
+ */
+#define JSON_KEYS_MAX_KEY_LENGTH 1023
+
+
+/**
+ * Number of keys there is room for at first
+ */
+#define JSON_KEYS_INITIAL_COUNT 64
+
+
+
+
+/**
+ * Reads the keys, one per line, skipping blank lines
+ *
+ * @param input - the file to read from
+ * @param count - where to store the number of keys
+ *
+ * @return - the keys, NULL if a key is too long or allocation fails
+ */
+static char ** __readKeys(FILE * input, unsigned int * count);
+
+
+/**
+ * Deletes keys read by __readKeys
+ *
+ * @param keys - the keys
+ * @param count - the number of keys
+ */
+static void __deleteKeys(char ** keys, unsigned int count);
+
+
+/**
+ * Builds the name of the enum constant of a key, upper-cased with other characters than letters and digits turned to '_'
+ *
+ * @param prefix - the upper-cased name of the set
+ * @param key - the key
+ *
+ * @return - the name, NULL if allocation fails
+ */
+static char * __constantName(char const * const prefix, char const * const key);
+
+
+/**
+ * Writes a key as a C string litteral
+ *
+ * @param output - the file to write to
+ * @param key - the key
+ */
+static void __writeString(FILE * output, char const * const key);
+
+
+/**
+ * Writes the header of a set of keys
+ *
+ * @param output - the file to write to
+ * @param name - the name of the set, such as "Message"
+ * @param keys - the keys
+ * @param count - the number of keys
+ * @param displacements - the displacement of each bucket
+ * @param slots - the slot of each key
+ *
+ * @return - 0 on success, -1 if two keys have the same constant name, -2 if allocation fails
+ */
+static int __writeHeader(FILE * output, char const * const name, char ** keys, unsigned int count, int const * displacements, unsigned int const * slots);
+
+
+
+
+/**
+ * Generates a minimal perfect hash of the keys read from the standard input, one per line,
+ * as a header declaring a <Name>Key enum whose constants are the slots of the keys
+ *
+ * usage: json-keys <Name> < keys.txt > <Name>Keys.h
+ */
+int main(int argc, char ** argv)
+{
+    char ** keys;
+    unsigned int count = 0;
+    int * displacements = NULL;
+    unsigned int * slots = NULL;
+    int built = 0;
+    int written = 0;
+    int status = EXIT_FAILURE;
+
+    if ((argc != 2) || ! isalpha((unsigned char) argv[1][0])) {
+        fprintf(stderr, "usage: %s <Name> < keys.txt > <Name>Keys.h\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    keys = __readKeys(stdin, & count);
+    if (keys == NULL) {
+        fprintf(stderr, "%s: can't read the keys\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    displacements = Class->new("int[]", count * sizeof(int) + 1);
+    slots = Class->new("unsigned int[]", count * sizeof(unsigned int) + 1);
+    if ((displacements != NULL) && (slots != NULL)) {
+        built = _JsonKeys->build((char const * const *) keys, count, displacements, slots);
+    }
+    if ((displacements != NULL) && (slots != NULL) && (built == 0)) {
+        written = __writeHeader(stdout, argv[1], keys, count, displacements, slots);
+    }
+
+    if ((displacements == NULL) || (slots == NULL) || (built == JSON_KEYS_ERROR_ALLOCATION) || (written == -2)) {
+        fprintf(stderr, "%s: out of memory\n", argv[0]);
+    } else if (built == JSON_KEYS_ERROR_DUPLICATED) {
+        fprintf(stderr, "%s: keys are duplicated\n", argv[0]);
+    } else if (built == JSON_KEYS_ERROR_NO_SEED) {
+        fprintf(stderr, "%s: no seed places every key, try splitting the keys into several sets\n", argv[0]);
+    } else if (written == -1) {
+        fprintf(stderr, "%s: keys have the same constant name\n", argv[0]);
+    } else {
+        status = EXIT_SUCCESS;
+    }
+
+    __deleteKeys(keys, count);
+    Class->delete((void **) & displacements);
+    Class->delete((void **) & slots);
+
+    return status;
+}
+
+
+
+
+static char ** __readKeys(FILE * input, unsigned int * count)
+{
+    char line[JSON_KEYS_MAX_KEY_LENGTH + 2];
+    unsigned int capacity = JSON_KEYS_INITIAL_COUNT;
+    unsigned int length;
+    char ** keys;
+
+    keys = Class->new("char *[]", capacity * sizeof(char *));
+    if (keys == NULL) {
+        return NULL;
+    }
+
+    while (fgets(line, sizeof(line), input) != NULL) {
+        length = strlen(line);
+        if ((length == sizeof(line) - 1) && (line[length - 1] != '\n')) {
+            __deleteKeys(keys, * count);
+            return NULL;
+        }
+        while ((length > 0) && ((line[length - 1] == '\n') || (line[length - 1] == '\r'))) {
+            line[--length] = '\0';
+        }
+        if (length == 0) {
+            continue;
+        }
+
+        if ((* count == capacity) && (Class->resize((void **) & keys, capacity * sizeof(char *), 2 * capacity * sizeof(char *)) != 0)) {
+            __deleteKeys(keys, * count);
+            return NULL;
+        }
+        capacity = (* count == capacity) ? 2 * capacity : capacity;
+
+        keys[* count] = Class->new("JsonString", length + 1);
+        if (keys[* count] == NULL) {
+            __deleteKeys(keys, * count);
+            return NULL;
+        }
+        memcpy(keys[(* count)++], line, length);
+    }
+
+    return keys;
+}
+
+
+static void __deleteKeys(char ** keys, unsigned int count)
+{
+    unsigned int key;
+
+    for (key = 0; key < count; key++) {
+        Class->delete((void **) & keys[key]);
+    }
+    Class->delete((void **) & keys);
+}
+
+
+static char * __constantName(char const * const prefix, char const * const key)
+{
+    char * name;
+    unsigned int prefixLength = strlen(prefix);
+    unsigned int index;
+
+    name = Class->new("JsonString", prefixLength + strlen("_KEY_") + strlen(key) + 1);
+    if (name == NULL) {
+        return NULL;
+    }
+
+    strcpy(name, prefix);
+    strcat(name, "_KEY_");
+    for (index = 0; key[index] != '\0'; index++) {
+        name[prefixLength + 5 + index] = isalnum((unsigned char) key[index]) ? toupper((unsigned char) key[index]) : '_';
+    }
+
+    return name;
+}
+
+
+static void __writeString(FILE * output, char const * const key)
+{
+    unsigned int index;
+
+    fputc('"', output);
+    for (index = 0; key[index] != '\0'; index++) {
+        if ((key[index] == '"') || (key[index] == '\\')) {
+            fputc('\\', output);
+        }
+        fputc(key[index], output);
+    }
+    fputc('"', output);
+}
+
+
+static int __writeHeader(FILE * output, char const * const name, char ** keys, unsigned int count, int const * displacements, unsigned int const * slots)
+{
+    char ** names;
+    char * prefix;
+    char * variable;
+    unsigned int index;
+    unsigned int other;
+    int status = 0;
+
+    names = Class->new("char *[]", count * sizeof(char *) + 1);
+    prefix = Class->new("JsonString", strlen(name) + 1);
+    variable = Class->new("JsonString", strlen(name) + 1);
+    if ((names == NULL) || (prefix == NULL) || (variable == NULL)) {
+        status = -2;
+    }
+
+    for (index = 0; (status == 0) && (name[index] != '\0'); index++) {
+        prefix[index] = isalnum((unsigned char) name[index]) ? toupper((unsigned char) name[index]) : '_';
+        variable[index] = (index == 0) ? tolower((unsigned char) name[index]) : name[index];
+    }
+
+    /* constants are stored by slot, so that they follow the enum values */
+    for (index = 0; (status == 0) && (index < count); index++) {
+        names[slots[index]] = __constantName(prefix, keys[index]);
+        status = (names[slots[index]] == NULL) ? -2 : 0;
+    }
+    for (index = 0; (status == 0) && (index < count); index++) {
+        for (other = index + 1; (status == 0) && (other < count); other++) {
+            status = (strcmp(names[index], names[other]) == 0) ? -1 : 0;
+        }
+    }
+
+    if (status == 0) {
+        fprintf(output, "/* Generated by `make keys-header`, do not edit */\n");
+        fprintf(output, "#ifndef %s_KEYS_HEADER\n#define %s_KEYS_HEADER\n\n#include \"JsonKeys.h\"\n\n\n\n\n", prefix, prefix);
+
+        fprintf(output, "/**\n * Ids of the %s keys, as found by _JsonKeys->find\n */\ntypedef enum\n{\n", name);
+        for (index = 0; index < count; index++) {
+            fprintf(output, "    %s = %u,\n", names[index], index);
+        }
+        fprintf(output, "    %s_KEYS_COUNT = %u\n} %sKey;\n\n\n", prefix, count, name);
+
+        fprintf(output, "/**\n * Displacement of each bucket of the %s keys\n */\nstatic int const %sKeysDisplacements[%u] = {", name, variable, count + (count == 0));
+        for (index = 0; index < count; index++) {
+            fprintf(output, "%s%d", (index > 0) ? ", " : " ", displacements[index]);
+        }
+        fprintf(output, "%s };\n\n\n", (count == 0) ? " 0" : "");
+
+        fprintf(output, "/**\n * The %s key in each slot\n */\nstatic char const * const %sKeysNames[%u] = {", name, variable, count + (count == 0));
+        for (index = 0; index < count; index++) {
+            fprintf(output, "%s", (index > 0) ? ",\n    " : "\n    ");
+            for (other = 0; slots[other] != index; other++);
+            __writeString(output, keys[other]);
+        }
+        fprintf(output, "%s\n};\n\n\n", (count == 0) ? " NULL" : "");
+
+        fprintf(output, "/**\n * The %s keys\n */\nstatic JsonKeySet const %sKeys = { %u, %sKeysDisplacements, %sKeysNames };\n\n\n\n\n", name, variable, count, variable, variable);
+        fprintf(output, "#endif /* %s_KEYS_HEADER */\n", prefix);
+    }
+
+    for (index = 0; (names != NULL) && (index < count); index++) {
+        Class->delete((void **) & names[index]);
+    }
+    Class->delete((void **) & names);
+    Class->delete((void **) & prefix);
+    Class->delete((void **) & variable);
+
+    return status;
+}